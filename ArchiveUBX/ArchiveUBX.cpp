@@ -0,0 +1,121 @@
+//**********************************************************************
+// File:			ArchiveUBX.cpp
+// Programmer:		Guoyu Fu
+// Description:		Packs receiver logs into .ubz archives and back
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <fstream>
+#include <vector>
+#include <thread>
+
+#include "ArchiveUBX.h"
+#include "../ParseUBX/LibInput.h"
+
+using namespace std;
+
+// LogArchiver: default constructor
+LogArchiver::LogArchiver()
+{
+	threads = 0;
+	level = ARCHIVE_LEVEL;
+	logBytes = 0;
+	archiveBytes = 0;
+}
+
+// pack: packs a log into an archive, a batch of blocks per round, one
+//   block per thread
+int LogArchiver::pack(const string &input, const string &output)
+{
+#if !defined(UBX_ZLIB) && !defined(UBX_ZSTD)
+	// stored streams would make the archive larger than any compressor
+	return(ARCHIVER_NO_CODEC);
+#endif
+	unsigned int count = threads != 0 ? threads : thread::hardware_concurrency();
+	if(count == 0)
+		count = 1;
+
+	LogInputBuf in;
+	if(in.open(input) != INPUT_OK)
+		return(ARCHIVER_NO_INPUT);
+	ofstream out(output.c_str(), ios::out | ios::binary);
+	if(!out.is_open())
+		return(ARCHIVER_NO_OUTPUT);
+
+	out.write(reinterpret_cast<const char *>(ARCHIVE_MAGIC), ARCHIVE_MAGIC_SIZE);
+	logBytes = 0;
+	archiveBytes = ARCHIVE_MAGIC_SIZE;
+
+	vector< vector<unsigned char> > logs(count);
+	vector< vector<unsigned char> > blocks(count);
+	bool more = true;
+	while(more)
+	{
+		unsigned int used = 0;
+		for(; used < count && more; used++)
+		{
+			logs[used].resize(ARCHIVE_BLOCK_SIZE);
+			streamsize n = in.sgetn(&logs[used][0], ARCHIVE_BLOCK_SIZE);
+			logs[used].resize(static_cast<size_t>(n));
+			more = n == ARCHIVE_BLOCK_SIZE;
+			if(n == 0)
+				break;
+		}
+
+		vector<thread> packers;
+		for(unsigned int b = 0; b < used; b++)
+		{
+			blocks[b].clear();
+			packers.push_back(thread([this, &logs, &blocks, b] {
+				packBlock(logs[b].empty() ? 0 : &logs[b][0], logs[b].size(), blocks[b], level);
+			}));
+		}
+		for(unsigned int b = 0; b < used; b++)
+		{
+			packers[b].join();
+			out.write(reinterpret_cast<const char *>(&blocks[b][0]), blocks[b].size());
+			logBytes += logs[b].size();
+			archiveBytes += blocks[b].size();
+		}
+	}
+
+	if(!out)
+		return(ARCHIVER_NO_OUTPUT);
+	return(in.failed() ? ARCHIVER_DAMAGED : ARCHIVER_OK);
+}
+
+// unpack: writes the log of an archive (or of any input LogInputBuf reads)
+int LogArchiver::unpack(const string &input, const string &output)
+{
+	LogInputBuf in;
+	if(in.open(input, threads) != INPUT_OK)
+		return(ARCHIVER_NO_INPUT);
+	ofstream out(output.c_str(), ios::out | ios::binary);
+	if(!out.is_open())
+		return(ARCHIVER_NO_OUTPUT);
+
+	ifstream archive(input.c_str(), ios::in | ios::binary | ios::ate);
+	archiveBytes = archive.is_open() ? static_cast<unsigned long long>(archive.tellg()) : 0;
+	logBytes = 0;
+
+	vector<unsigned char> buffer(ARCHIVE_BLOCK_SIZE);
+	streamsize n;
+	while((n = in.sgetn(&buffer[0], buffer.size())) > 0)
+	{
+		out.write(reinterpret_cast<const char *>(&buffer[0]), n);
+		logBytes += n;
+	}
+
+	if(!out)
+		return(ARCHIVER_NO_OUTPUT);
+	return(in.failed() ? ARCHIVER_DAMAGED : ARCHIVER_OK);
+}
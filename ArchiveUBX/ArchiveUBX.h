@@ -0,0 +1,52 @@
+//**********************************************************************
+// File:			ArchiveUBX.h
+// Programmer:		Guoyu Fu
+// Description:		Packs receiver logs into .ubz archives and back
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Packing reads the log through LogInputBuf, so plain, gzip and zstd
+// logs are packed alike, and codes ARCHIVE_BLOCK_SIZE blocks on as
+// many threads (LibArchive.h).  Unpacking reads the archive through
+// LogInputBuf too, which unpacks the blocks on its worker threads.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef ARCHIVE_UBX_H
+#define ARCHIVE_UBX_H
+
+// defined constants
+#define ARCHIVER_OK           0
+#define ARCHIVER_NO_INPUT    -1        // cannot open the input
+#define ARCHIVER_NO_OUTPUT   -2        // cannot write the output
+#define ARCHIVER_DAMAGED     -3        // input damaged, output incomplete
+#define ARCHIVER_NO_CODEC    -4        // built without UBX_ZLIB or UBX_ZSTD, nothing to pack with
+
+// included libraries
+#include <string>
+#include "../ParseUBX/LibArchive.h"
+
+// definition of LogArchiver class
+class LogArchiver
+{
+	public:
+		// constructors
+		LogArchiver();
+
+		// methods
+		int pack(const std::string &input, const std::string &output);
+		int unpack(const std::string &input, const std::string &output);
+
+		// settings
+		unsigned int threads;           // 0 => one per hardware thread
+		int level;                      // compression level, ARCHIVE_LEVEL by default
+
+		// statistics of the last call
+		unsigned long long logBytes;
+		unsigned long long archiveBytes;
+};
+
+#endif // ARCHIVE_UBX_H
@@ -0,0 +1,86 @@
+//**********************************************************************
+// File:			main.cpp
+// Programmer:		Guoyu Fu
+// Description:		Packs receiver logs into .ubz archives and back
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//   archiveubx -c ds3_r2.ubx ds3_r2.ubz
+//   archiveubx -c -l 19 ds3_r2.ubx ds3_r2.ubz   (smaller, slower)
+//   archiveubx -d ds3_r2.ubz ds3_r2.ubx
+//   ParseUBX ds3_r2.ubz ds3_r2.csv        (reads the archive directly)
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include "ArchiveUBX.h"
+using namespace std;
+
+// main program module
+//   archiveubx -c|-d [-t threads] [-l level] input output
+int main(int argc, char* argv[])
+{
+	LogArchiver archiver;
+	string mode;
+	string input;
+	string output;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg == "-c" || arg == "-d")
+			mode = arg;
+		else if(arg == "-t" && i + 1 < argc)
+			archiver.threads = atoi(argv[++i]);
+		else if(arg == "-l" && i + 1 < argc)
+			archiver.level = atoi(argv[++i]);
+		else if(input.empty())
+			input = arg;
+		else
+			output = arg;
+	}
+
+	if(mode.empty() || input.empty() || output.empty())
+	{
+		cout << "usage: archiveubx -c|-d [-t threads] [-l level] input output" << endl;
+		cout << "  -c  pack a log (plain, gzip or zstd) into a .ubz archive" << endl;
+		cout << "  -d  unpack a .ubz archive into the original log" << endl;
+		cout << "  -l  compression level, 1 (fast) to 22 (small), default " << ARCHIVE_LEVEL << endl;
+		return(1);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int res = mode == "-c" ? archiver.pack(input, output) : archiver.unpack(input, output);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	switch(res)
+	{
+		case ARCHIVER_NO_INPUT:
+			cout << "Unable to open input file!" << endl;
+			return(1);
+		case ARCHIVER_NO_OUTPUT:
+			cout << "Unable to write output file!" << endl;
+			return(1);
+		case ARCHIVER_DAMAGED:
+			cout << "Input damaged, output ends at the damage!" << endl;
+			return(1);
+		case ARCHIVER_NO_CODEC:
+			cout << "Built without compression (define UBX_ZLIB or UBX_ZSTD), not packing!" << endl;
+			return(1);
+	}
+
+	double ratio = archiver.logBytes > 0 ? 100.0 * archiver.archiveBytes / archiver.logBytes : 0.0;
+	cout << archiver.logBytes << " log bytes, " << archiver.archiveBytes << " archive bytes ("
+	     << fixed << setprecision(1) << ratio << "%), "
+	     << (seconds > 0 ? archiver.logBytes / seconds / 1e6 : 0.0) << " MB/s" << endl;
+	return(0);
+}
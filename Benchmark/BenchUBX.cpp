@@ -0,0 +1,521 @@
+//**********************************************************************
+// File:			BenchUBX.cpp
+// Programmer:		Guoyu Fu
+// Description:		Throughput benchmark of the UBX/NMEA log pipeline
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <atomic>
+#include <chrono>
+
+#include "BenchUBX.h"
+#include "../ParseUBX/ParseUBX.h"
+
+using namespace std;
+
+// defined constants
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// heap allocations made by the whole program
+static atomic<unsigned long> allocationCount(0);
+
+// the replacements pair malloc with free, which gcc takes for a
+// mismatched new/delete
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void * operator new(size_t size)
+{
+	allocationCount++;
+	void * p = malloc(size > 0 ? size : 1);
+	if(p == 0)
+		throw bad_alloc();
+	return(p);
+}
+
+void * operator new[](size_t size)
+{
+	allocationCount++;
+	void * p = malloc(size > 0 ? size : 1);
+	if(p == 0)
+		throw bad_alloc();
+	return(p);
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+	free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// heapAllocations: allocations made so far
+unsigned long heapAllocations(void)
+{
+	return(allocationCount.load());
+}
+
+// elapsed: seconds since an arbitrary fixed point
+static double elapsed(void)
+{
+	return(chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// messageTypeName: UBX class-ID name of a frame type key, from the parse
+//   statistics table; types it does not list are named by their numbers
+string messageTypeName(unsigned short type)
+{
+	if(type == BENCH_NMEA_TYPE)
+		return(ParseStats::typeName(STATS_NMEA_TYPE));
+
+	int slot = ParseStats::typeSlot(type >> 8, type & 0xFF);
+	if(slot != STATS_OTHER_TYPE)
+		return(ParseStats::typeName(slot));
+
+	char unknown[16];
+	sprintf(unknown, "0x%02X-0x%02X", type >> 8, type & 0xFF);
+	return(unknown);
+}
+
+// ThroughputBench: default constructor
+ThroughputBench::ThroughputBench()
+{
+	repeats = BENCH_REPEATS;
+}
+
+// run: measures every stage over one log and appends the result
+//   returns 0 on success, -1 if the file cannot be read
+int ThroughputBench::run(const string &fname)
+{
+	FileResult result;
+	result.name = fname;
+	result.ubxFrames = result.nmeaFrames = 0;
+	result.skippedBytes = result.badChecksums = 0;
+	for(int s = 0; s < BENCH_NUM_STAGES; s++)
+	{
+		result.stage[s].seconds = -1.0;
+		result.stage[s].frames = result.stage[s].bytes = result.stage[s].allocations = 0;
+	}
+
+	// read, from the OS file cache after the first run
+	for(int r = 0; r < repeats; r++)
+	{
+		double start = elapsed();
+		unsigned long allocations = heapAllocations();
+
+		ifstream in(fname.c_str(), ios::in | ios::binary);
+		if(!in.is_open())
+		{
+			cout << "Unable to open " << fname << endl;
+			return(-1);
+		}
+		in.seekg(0, ios::end);
+		unsigned long size = static_cast<unsigned long>(in.tellg());
+		in.seekg(0, ios::beg);
+		data.resize(size);
+		if(size > 0)
+			in.read(reinterpret_cast<char *>(&data[0]), size);
+		if(!in)
+		{
+			cout << "Unable to read " << fname << endl;
+			return(-1);
+		}
+
+		double seconds = elapsed() - start;
+		if(result.stage[STAGE_READ].seconds < 0.0 || seconds < result.stage[STAGE_READ].seconds)
+		{
+			result.stage[STAGE_READ].seconds = seconds;
+			result.stage[STAGE_READ].allocations = heapAllocations() - allocations;
+		}
+	}
+	result.bytes = data.size();
+	result.stage[STAGE_READ].bytes = data.size();
+
+	// framing and checksum, whole log per run
+	for(int r = 0; r < repeats; r++)
+	{
+		StageResult &stage = result.stage[STAGE_FRAMING];
+		double start = elapsed();
+		unsigned long allocations = heapAllocations();
+		stage.frames = frame(result);
+		double seconds = elapsed() - start;
+		if(stage.seconds < 0.0 || seconds < stage.seconds)
+		{
+			stage.seconds = seconds;
+			stage.allocations = heapAllocations() - allocations;
+		}
+		stage.bytes = data.size();
+	}
+	for(int r = 0; r < repeats; r++)
+	{
+		StageResult &stage = result.stage[STAGE_CHECKSUM];
+		double start = elapsed();
+		unsigned long allocations = heapAllocations();
+		stage.frames = checksum(result);
+		double seconds = elapsed() - start;
+		if(stage.seconds < 0.0 || seconds < stage.seconds)
+		{
+			stage.seconds = seconds;
+			stage.allocations = heapAllocations() - allocations;
+		}
+	}
+
+	result.ubxFrames = result.nmeaFrames = 0;
+	for(unsigned long f = 0; f < frames.size(); f++)
+	{
+		if(frames[f].type == BENCH_NMEA_TYPE)
+			result.nmeaFrames++;
+		else
+			result.ubxFrames++;
+		result.stage[STAGE_CHECKSUM].bytes += frames[f].length;
+	}
+
+	// decode and export, one message type at a time
+	decodeAndExport(result);
+
+	results.push_back(result);
+	return(0);
+}
+
+// frame: splits the log into UBX and NMEA frames with the parser's framer
+//   returns number of frames found
+unsigned long ThroughputBench::frame(FileResult &result)
+{
+	UBXParser parser;
+	const unsigned char * bytes;
+	int length;
+	unsigned long framed = 0;
+
+	frames.clear();
+	parser.open(data.empty() ? 0 : &data[0], data.size());
+
+	while(parser.read_next_frame(bytes, length) == 0)
+	{
+		BenchFrame f;
+		f.length = length;
+		f.offset = static_cast<unsigned long>(parser.resumeOffset()) - f.length;
+		f.type   = (bytes[0] == '$') ? BENCH_NMEA_TYPE : static_cast<unsigned short>((bytes[2] << 8) | bytes[3]);
+		f.valid  = false;
+		frames.push_back(f);
+		framed += f.length;
+	}
+
+	// bytes outside any frame, and a frame cut by the end of the log
+	result.skippedBytes = data.size() - framed;
+	return(frames.size());
+}
+
+// checksum: verifies every frame as processUBXMessage/processNMEAMessage do
+//   returns number of frames checked
+unsigned long ThroughputBench::checksum(FileResult &result)
+{
+	result.badChecksums = 0;
+
+	for(unsigned long f = 0; f < frames.size(); f++)
+	{
+		char * buffer = reinterpret_cast<char *>(&data[frames[f].offset]);
+		const int length = static_cast<int>(frames[f].length);
+
+		if(frames[f].type != BENCH_NMEA_TYPE)
+		{
+			UBXMessage message(buffer, length);
+			frames[f].valid = message.verifyChecksum();
+		}
+		else
+		{
+			string message(buffer, length);
+			frames[f].valid = verifyChecksum(message);
+		}
+		if(!frames[f].valid)
+			result.badChecksums++;
+	}
+
+	return(frames.size());
+}
+
+// decodeAndExport: times message construction and CSV output per type
+void ThroughputBench::decodeAndExport(FileResult &result)
+{
+	// frames of each type that passed their checksum, in log order
+	map<unsigned short, vector<unsigned long> > byType;
+	for(unsigned long f = 0; f < frames.size(); f++)
+		if(frames[f].valid)
+			byType[frames[f].type].push_back(f);
+
+	ofstream out(NULL_DEVICE);
+	NavAssembler * nav = new NavAssembler();   // too large for the stack
+	vector<UBXMessage> messages;
+	vector<string> sentences;
+	vector<NavRecord> records;
+
+	for(map<unsigned short, vector<unsigned long> >::const_iterator t = byType.begin(); t != byType.end(); ++t)
+	{
+		const vector<unsigned long> &index = t->second;
+		const bool nmea  = (t->first == BENCH_NMEA_TYPE);
+		const bool sfrbx = (t->first == ((RXM << 8) | SFRBX));
+
+		TypeResult type;
+		type.frames = index.size();
+		type.bytes = 0;
+		for(unsigned long k = 0; k < index.size(); k++)
+			type.bytes += frames[index[k]].length;
+		type.decodeSeconds = type.exportSeconds = -1.0;
+		type.decodeAllocations = type.exportAllocations = 0;
+
+		messages.reserve(index.size());
+		sentences.reserve(index.size());
+		records.reserve(index.size());
+
+		for(int r = 0; r < repeats; r++)
+		{
+			// decode: what processUBXMessage/processNMEAMessage build per frame
+			nav->reset();
+			double start = elapsed();
+			unsigned long allocations = heapAllocations();
+			for(unsigned long k = 0; k < index.size(); k++)
+			{
+				const BenchFrame &f = frames[index[k]];
+				char * buffer = reinterpret_cast<char *>(&data[f.offset]);
+				if(nmea)
+				{
+					sentences.push_back(string(buffer, f.length));
+					continue;
+				}
+
+				messages.emplace_back(buffer, static_cast<int>(f.length));
+				if(sfrbx)
+				{
+					NavRecord record;
+					const UBXMessage &message = messages.back();
+					if(nav->add(message.payload, message.header.length, record) == 1)
+						records.push_back(record);
+				}
+			}
+			double seconds = elapsed() - start;
+			if(type.decodeSeconds < 0.0 || seconds < type.decodeSeconds)
+			{
+				type.decodeSeconds = seconds;
+				type.decodeAllocations = heapAllocations() - allocations;
+			}
+
+			// export: CSV lines, then the messages are released
+			start = elapsed();
+			allocations = heapAllocations();
+			for(unsigned long k = 0; k < messages.size(); k++)
+				messages[k].writeCSV(out);
+			for(unsigned long k = 0; k < records.size(); k++)
+				writeNavRecord(out, records[k]);
+			for(unsigned long k = 0; k < sentences.size(); k++)
+			{
+				if(sentences[k].size() >= 2)
+					out << sentences[k].substr(0, sentences[k].size() - 2);
+				out << endl;
+			}
+			messages.clear();
+			sentences.clear();
+			records.clear();
+			seconds = elapsed() - start;
+			if(type.exportSeconds < 0.0 || seconds < type.exportSeconds)
+			{
+				type.exportSeconds = seconds;
+				type.exportAllocations = heapAllocations() - allocations;
+			}
+		}
+
+		result.types[t->first] = type;
+
+		for(int s = STAGE_DECODE; s <= STAGE_EXPORT; s++)
+		{
+			StageResult &stage = result.stage[s];
+			if(stage.seconds < 0.0)
+				stage.seconds = 0.0;
+			stage.seconds += (s == STAGE_DECODE) ? type.decodeSeconds : type.exportSeconds;
+			stage.allocations += (s == STAGE_DECODE) ? type.decodeAllocations : type.exportAllocations;
+			stage.frames += type.frames;
+			stage.bytes += type.bytes;
+		}
+	}
+
+	delete nav;
+}
+
+// rate: amount per second, 0 if nothing was timed
+static double rate(double amount, double seconds)
+{
+	return(seconds > 0.0 ? amount / seconds : 0.0);
+}
+
+// jsonString: quoted JSON string
+static string jsonString(const string &text)
+{
+	string quoted = "\"";
+	for(unsigned int i = 0; i < text.size(); i++)
+	{
+		char c = text[i];
+		if(c == '"' || c == '\\')
+			quoted += '\\';
+		if(static_cast<unsigned char>(c) < 0x20)
+			continue;
+		quoted += c;
+	}
+	return(quoted + "\"");
+}
+
+// writeStage: one stage object of the JSON report
+static void writeStage(ostream &out, const char * name, const StageResult &stage, bool last)
+{
+	double seconds = stage.seconds > 0.0 ? stage.seconds : 0.0;
+
+	out << "        " << jsonString(name) << ": { ";
+	out << "\"seconds\": " << seconds << ", ";
+	out << "\"MBps\": " << rate(stage.bytes / 1.0e6, seconds) << ", ";
+	out << "\"framesPerSec\": " << rate(static_cast<double>(stage.frames), seconds) << ", ";
+	out << "\"allocsPerFrame\": " << (stage.frames > 0 ? static_cast<double>(stage.allocations) / stage.frames : 0.0);
+	out << " }" << (last ? "" : ",") << endl;
+}
+
+// writeJSON: writes all results to a machine readable report
+//   returns 0 on success, -1 if the file cannot be opened
+int ThroughputBench::writeJSON(const string &fname) const
+{
+	static const char * stageNames[BENCH_NUM_STAGES] = { "read", "framing", "checksum", "decode", "export" };
+
+	ofstream out(fname.c_str());
+	if(!out.is_open())
+		return(-1);
+
+	char timestamp[32];
+	time_t now = time(0);
+	strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+	out << setprecision(6);
+	out << "{" << endl;
+	out << "  \"benchmark\": \"BenchUBX\"," << endl;
+	out << "  \"timestamp\": \"" << timestamp << "\"," << endl;
+	out << "  \"repeats\": " << repeats << "," << endl;
+	out << "  \"files\": [" << endl;
+
+	StageResult total[BENCH_NUM_STAGES];
+	memset(total, 0, sizeof(total));
+
+	for(unsigned int f = 0; f < results.size(); f++)
+	{
+		const FileResult &result = results[f];
+
+		out << "    {" << endl;
+		out << "      \"file\": " << jsonString(result.name) << "," << endl;
+		out << "      \"bytes\": " << result.bytes << "," << endl;
+		out << "      \"ubxFrames\": " << result.ubxFrames << "," << endl;
+		out << "      \"nmeaFrames\": " << result.nmeaFrames << "," << endl;
+		out << "      \"skippedBytes\": " << result.skippedBytes << "," << endl;
+		out << "      \"badChecksums\": " << result.badChecksums << "," << endl;
+		out << "      \"stages\": {" << endl;
+		for(int s = 0; s < BENCH_NUM_STAGES; s++)
+		{
+			writeStage(out, stageNames[s], result.stage[s], s == BENCH_NUM_STAGES - 1);
+			total[s].seconds     += result.stage[s].seconds > 0.0 ? result.stage[s].seconds : 0.0;
+			total[s].frames      += result.stage[s].frames;
+			total[s].bytes       += result.stage[s].bytes;
+			total[s].allocations += result.stage[s].allocations;
+		}
+		out << "      }," << endl;
+
+		out << "      \"types\": [" << endl;
+		map<unsigned short, TypeResult>::const_iterator t = result.types.begin();
+		while(t != result.types.end())
+		{
+			const TypeResult &type = t->second;
+			out << "        { \"type\": " << jsonString(messageTypeName(t->first)) << ", ";
+			out << "\"frames\": " << type.frames << ", ";
+			out << "\"bytes\": " << type.bytes << ", ";
+			out << "\"decodeFramesPerSec\": " << rate(static_cast<double>(type.frames), type.decodeSeconds) << ", ";
+			out << "\"exportFramesPerSec\": " << rate(static_cast<double>(type.frames), type.exportSeconds) << ", ";
+			out << "\"allocsPerFrame\": " << static_cast<double>(type.decodeAllocations + type.exportAllocations) / type.frames << " }";
+			++t;
+			out << (t == result.types.end() ? "" : ",") << endl;
+		}
+		out << "      ]" << endl;
+		out << "    }" << (f + 1 == results.size() ? "" : ",") << endl;
+	}
+	out << "  ]," << endl;
+
+	out << "  \"total\": {" << endl;
+	out << "      \"stages\": {" << endl;
+	for(int s = 0; s < BENCH_NUM_STAGES; s++)
+		writeStage(out, stageNames[s], total[s], s == BENCH_NUM_STAGES - 1);
+	out << "      }" << endl;
+	out << "  }" << endl;
+	out << "}" << endl;
+
+	return(out.good() ? 0 : -1);
+}
+
+// writeSummary: MB/s of every stage and allocations per frame, one line per file
+void ThroughputBench::writeSummary(ostream &out) const
+{
+	out << setfill(' ') << left << setw(36) << "file" << right;
+	out << setw(9) << "MB" << setw(9) << "frames";
+	out << setw(10) << "read" << setw(10) << "framing" << setw(10) << "checksum";
+	out << setw(10) << "decode" << setw(10) << "export";
+	out << setw(10) << "allocs/fr" << endl;
+
+	for(unsigned int f = 0; f < results.size(); f++)
+	{
+		const FileResult &result = results[f];
+		string name = result.name;
+		size_t slash = name.find_last_of("/\\");
+		if(slash != string::npos)
+			name = name.substr(slash + 1);
+
+		unsigned long frameCount = result.ubxFrames + result.nmeaFrames;
+		unsigned long allocations = result.stage[STAGE_DECODE].allocations + result.stage[STAGE_EXPORT].allocations;
+
+		out << left << setw(36) << name << right << fixed << setprecision(2);
+		out << setw(9) << result.bytes / 1.0e6 << setw(9) << frameCount;
+		for(int s = 0; s < BENCH_NUM_STAGES; s++)
+			out << setw(10) << rate(result.stage[s].bytes / 1.0e6, result.stage[s].seconds);
+		out << setw(10) << (frameCount > 0 ? static_cast<double>(allocations) / frameCount : 0.0);
+		out << endl;
+	}
+	out << "(MB/s per stage)" << endl;
+}
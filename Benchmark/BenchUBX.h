@@ -0,0 +1,119 @@
+//**********************************************************************
+// File:			BenchUBX.h
+// Programmer:		Guoyu Fu
+// Description:		Throughput benchmark of the UBX/NMEA log pipeline
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Each log is read into memory once, then the stages of UBXParser are
+// timed separately over the buffer so that disk speed does not hide
+// them:
+//   framing  - UBXParser::read_next_frame over the buffer: UBX
+//              (0xB5 0x62 + length) and NMEA ('$' .. '\n') frames,
+//              bytes that start neither are skipped
+//   checksum - UBXMessage::verifyChecksum and the NMEA verifyChecksum
+//              over every frame
+//   decode   - UBXMessage construction (payload copy) and RXM-SFRBX
+//              navigation record assembly, as processUBXMessage does
+//   export   - UBXMessage::writeCSV, writeNavRecord and NMEA lines to
+//              the null device
+// Decode and export take the frames that passed their checksum, as the
+// parser does, and run one message type at a time, so the frame rate
+// of every type is measured without a timer call per frame.  Every
+// stage is repeated and the fastest run is kept.  Heap allocations are
+// counted by the replaced global operator new.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef BENCH_UBX_H
+#define BENCH_UBX_H
+
+// defined constants
+#define BENCH_REPEATS    3      // default runs per stage, fastest is kept
+#define BENCH_NMEA_TYPE  0xFFFF // type key of NMEA sentences
+#define BENCH_NUM_STAGES 5
+
+// stage indices
+#define STAGE_READ      0
+#define STAGE_FRAMING   1
+#define STAGE_CHECKSUM  2
+#define STAGE_DECODE    3
+#define STAGE_EXPORT    4
+
+// included libraries
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+// custom data types
+struct BenchFrame {
+	unsigned long  offset;    // first byte in the log
+	unsigned long  length;    // bytes including sync and checksum
+	unsigned short type;      // class << 8 | ID, BENCH_NMEA_TYPE for NMEA
+	bool           valid;     // checksum verified
+};
+
+struct StageResult {
+	double        seconds;    // fastest run
+	unsigned long frames;     // frames handled per run
+	unsigned long bytes;      // bytes handled per run
+	unsigned long allocations;// heap allocations per run
+};
+
+struct TypeResult {
+	unsigned long frames;
+	unsigned long bytes;
+	double        decodeSeconds;
+	double        exportSeconds;
+	unsigned long decodeAllocations;
+	unsigned long exportAllocations;
+};
+
+struct FileResult {
+	std::string   name;
+	unsigned long bytes;
+	unsigned long ubxFrames;
+	unsigned long nmeaFrames;
+	unsigned long skippedBytes;   // bytes outside any frame
+	unsigned long badChecksums;
+	StageResult   stage[BENCH_NUM_STAGES];
+	std::map<unsigned short, TypeResult> types;
+};
+
+// definition of ThroughputBench class
+class ThroughputBench
+{
+	public:
+		// constructors
+		ThroughputBench();
+
+		// methods
+		int  run(const std::string &fname);
+		int  writeJSON(const std::string &fname) const;
+		void writeSummary(std::ostream &out) const;
+
+		// settings
+		int repeats;              // runs per stage
+
+		// results, one per file run
+		std::vector<FileResult> results;
+
+	private:
+		std::vector<unsigned char> data;   // log being measured
+		std::vector<BenchFrame>    frames;
+
+		// stages, each returns frames handled
+		unsigned long frame(FileResult &result);
+		unsigned long checksum(FileResult &result);
+		void decodeAndExport(FileResult &result);
+};
+
+// function prototypes
+std::string messageTypeName(unsigned short type);
+unsigned long heapAllocations(void);
+
+#endif // BENCH_UBX_H
@@ -0,0 +1,619 @@
+//**********************************************************************
+// File:			GenUBX.cpp
+// Programmer:		Guoyu Fu
+// Description:		Synthetic UBX/NMEA log generator
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cstring>
+#include <cstdlib>
+
+#include "GenUBX.h"
+#include "../ParseUBX/LibUBX.h"
+
+using namespace std;
+
+// defined constants
+#define GEN_L1_WAVELENGTH  0.190293672798365   // m
+#define GEN_RECEIVER_X     -1288398.0          // m, fixed receiver position
+#define GEN_RECEIVER_Y     -4721696.0
+#define GEN_RECEIVER_Z      4078625.0
+#define GEN_RECEIVER_LAT    40.0003            // deg
+#define GEN_RECEIVER_LON   -105.2627           // deg
+#define GEN_RECEIVER_H      1650.0             // m
+
+// little endian field writers
+static inline void put1(unsigned char * p, int v)
+{
+	p[0] = static_cast<unsigned char>(v);
+}
+
+static inline void put2(unsigned char * p, int v)
+{
+	p[0] = static_cast<unsigned char>(v);
+	p[1] = static_cast<unsigned char>(v >> 8);
+}
+
+static inline void put4(unsigned char * p, unsigned long v)
+{
+	p[0] = static_cast<unsigned char>(v);
+	p[1] = static_cast<unsigned char>(v >> 8);
+	p[2] = static_cast<unsigned char>(v >> 16);
+	p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+static inline void putR4(unsigned char * p, float v)
+{
+	unsigned int bits;
+	memcpy(&bits, &v, sizeof(bits));
+	put4(p, bits);
+}
+
+static inline void putR8(unsigned char * p, double v)
+{
+	unsigned long long bits;
+	memcpy(&bits, &v, sizeof(bits));
+	put4(p, static_cast<unsigned long>(bits & 0xFFFFFFFF));
+	put4(p + 4, static_cast<unsigned long>(bits >> 32));
+}
+
+// putDecimal: writes a non-negative value with at least width digits
+//   returns the end of the text
+static char * putDecimal(char * p, int value, int width)
+{
+	char digits[12];
+	int n = 0;
+	do
+	{
+		digits[n++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while(value > 0 || n < width);
+
+	while(n > 0)
+		*p++ = digits[--n];
+	return(p);
+}
+
+// LogGenerator: default constructor
+LogGenerator::LogGenerator()
+{
+	numSV = 12;
+	intervalMs = 1000;
+	corruptionRate = 0.0;
+	seed = 1;
+	mix[GEN_RAWX]  = 1;
+	mix[GEN_RAW]   = 0;
+	mix[GEN_SFRBX] = 1;
+	mix[GEN_MEASX] = 1;
+	mix[GEN_NAV]   = 1;
+	mix[GEN_GSV]   = 1;
+
+	bytesWritten = frames = epochs = 0;
+	corrupted[GEN_FLIP] = corrupted[GEN_TRUNCATE] = corrupted[GEN_GARBAGE] = 0;
+	used = 0;
+	state = 1;
+	numGPS = 0;
+	week = GEN_START_WEEK;
+	tow = 0;
+}
+
+// ~LogGenerator: destructor
+LogGenerator::~LogGenerator(void)
+{
+	close();
+}
+
+// setMix: sets the messages per epoch from "kind[=count],..."
+//   kinds not listed are not written
+//   returns 0 on success, -1 on an unknown kind or bad count
+int LogGenerator::setMix(const string &spec)
+{
+	static const char * kinds[GEN_NUM_KINDS] = { "rawx", "raw", "sfrbx", "measx", "nav", "gsv" };
+	int counts[GEN_NUM_KINDS] = { 0 };
+	size_t start = 0;
+
+	while(start < spec.size())
+	{
+		size_t end = spec.find(',', start);
+		if(end == string::npos)
+			end = spec.size();
+		string item = spec.substr(start, end - start);
+		start = end + 1;
+
+		int count = 1;
+		size_t equals = item.find('=');
+		if(equals != string::npos)
+		{
+			count = atoi(item.substr(equals + 1).c_str());
+			item = item.substr(0, equals);
+			if(count < 0)
+				return(-1);
+		}
+
+		int k = 0;
+		while(k < GEN_NUM_KINDS && item != kinds[k])
+			k++;
+		if(k == GEN_NUM_KINDS)
+			return(-1);
+		counts[k] = count;
+	}
+
+	for(int k = 0; k < GEN_NUM_KINDS; k++)
+		mix[k] = counts[k];
+	return(0);
+}
+
+// open: creates the output log and sets up the simulated SVs
+//   returns 0 on success, -1 if the file cannot be created
+int LogGenerator::open(const string &fname)
+{
+	close();
+	out.open(fname.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!out.is_open())
+		return(-1);
+
+	if(numSV < 1)
+		numSV = 1;
+	if(numSV > GEN_MAX_SV)
+		numSV = GEN_MAX_SV;
+	if(intervalMs < 1)
+		intervalMs = 1;
+
+	buffer.resize(GEN_BUFFER_SIZE);
+	used = 0;
+	state = seed != 0 ? seed : 1;
+	bytesWritten = frames = epochs = 0;
+	corrupted[GEN_FLIP] = corrupted[GEN_TRUNCATE] = corrupted[GEN_GARBAGE] = 0;
+	week = GEN_START_WEEK;
+	tow = 0;
+
+	numGPS = 0;
+	for(int i = 0; i < numSV; i++)
+	{
+		Channel &ch = channel[i];
+		ch.gnssId    = (i < 32) ? 0 : 2;
+		ch.svId      = (i < 32) ? i + 1 : i - 31;
+		ch.range     = 20.2e6 + (random() % 5000000);
+		ch.rate      = static_cast<double>(random() % 1600) - 800.0;
+		ch.cno       = 30 + random() % 20;
+		ch.elevation = 5 + random() % 85;
+		ch.azimuth   = random() % 360;
+		if(ch.gnssId == 0)
+			numGPS++;
+	}
+
+	return(0);
+}
+
+// generate: writes whole epochs until at least bytes more are written
+//   returns 0 on success, -1 on a write error
+int LogGenerator::generate(unsigned long long bytes)
+{
+	unsigned long long target = bytesWritten + used + bytes;
+
+	if(!out.is_open())
+		return(-1);
+
+	while(bytesWritten + used < target)
+	{
+		for(int n = 0; n < mix[GEN_RAWX]; n++)
+			writeRAWX();
+		for(int n = 0; n < mix[GEN_RAW]; n++)
+			writeRAW();
+		if(mix[GEN_SFRBX] > 0 && tow % 6000 < static_cast<unsigned long>(intervalMs))
+			writeSFRBX();
+		for(int n = 0; n < mix[GEN_MEASX]; n++)
+			writeMEASX();
+		for(int n = 0; n < mix[GEN_NAV]; n++)
+			writeNAV();
+		for(int n = 0; n < mix[GEN_GSV]; n++)
+			writeGSV();
+
+		epochs++;
+		tow += intervalMs;
+		if(tow >= 604800000UL)
+		{
+			tow -= 604800000UL;
+			week++;
+		}
+
+		if(used > GEN_BUFFER_SIZE / 2 && flush() != 0)
+			return(-1);
+	}
+
+	return(flush());
+}
+
+// close: writes what is buffered and closes the log
+//   returns 0 on success, -1 on a write error
+int LogGenerator::close(void)
+{
+	if(!out.is_open())
+		return(0);
+
+	int res = flush();
+	out.close();
+	return(res);
+}
+
+// random: xorshift64* generator, low 32 bits
+unsigned long LogGenerator::random(void)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return(static_cast<unsigned long>((state * 2685821657736338717ULL) >> 32));
+}
+
+// flush: writes the buffered frames
+//   returns 0 on success, -1 on a write error
+int LogGenerator::flush(void)
+{
+	if(used == 0)
+		return(0);
+
+	out.write(reinterpret_cast<const char *>(&buffer[0]), used);
+	bytesWritten += used;
+	used = 0;
+	return(out.good() ? 0 : -1);
+}
+
+// beginUBX: starts a frame in the buffer
+//   returns the payload to fill, finished by endUBX()
+unsigned char * LogGenerator::beginUBX(int messageClass, int messageID, int length)
+{
+	if(used + length + 8 + GEN_MAX_GARBAGE > buffer.size())
+		flush();
+
+	unsigned char * p = &buffer[used];
+	p[0] = 0xb5;
+	p[1] = 0x62;
+	put1(p + 2, messageClass);
+	put1(p + 3, messageID);
+	put2(p + 4, length);
+	memset(p + 6, 0, length);
+	return(p + 6);
+}
+
+// endUBX: appends the checksum of the frame started by beginUBX()
+void LogGenerator::endUBX(void)
+{
+	size_t start = used;
+	unsigned char * p = &buffer[start];
+	int length = p[4] | (p[5] << 8);
+
+	U1 ck_A = 0;
+	U1 ck_B = 0;
+	for(int i = 2; i < length + 6; i++)
+	{
+		ck_A += p[i];
+		ck_B += ck_A;
+	}
+	p[length + 6] = ck_A;
+	p[length + 7] = ck_B;
+
+	used += length + 8;
+	finish(start);
+}
+
+// writeNMEA: appends "$<sentence>*hh\r\n"
+void LogGenerator::writeNMEA(const char * sentence)
+{
+	size_t length = strlen(sentence);
+	if(used + length + 6 + GEN_MAX_GARBAGE > buffer.size())
+		flush();
+
+	size_t start = used;
+	unsigned char sum = 0;
+	for(size_t i = 0; i < length; i++)
+		sum ^= static_cast<unsigned char>(sentence[i]);
+
+	static const char hex[] = "0123456789ABCDEF";
+	unsigned char * p = &buffer[start];
+	p[0] = '$';
+	memcpy(p + 1, sentence, length);
+	p[length + 1] = '*';
+	p[length + 2] = hex[sum >> 4];
+	p[length + 3] = hex[sum & 0xF];
+	p[length + 4] = '\r';
+	p[length + 5] = '\n';
+
+	used += length + 6;
+	finish(start);
+}
+
+// finish: counts the frame at start and damages it at the corruption rate
+void LogGenerator::finish(size_t start)
+{
+	frames++;
+	if(corruptionRate <= 0.0 || random() >= corruptionRate * 4294967296.0)
+		return;
+
+	size_t length = used - start;
+	int kind = random() % 3;
+	if(kind == GEN_FLIP)
+	{	// any byte after the sync, checksum or length error
+		buffer[start + 2 + random() % (length - 2)] ^= static_cast<unsigned char>(1 + random() % 255);
+	}
+	else if(kind == GEN_TRUNCATE)
+	{	// frame cut short, the next one starts inside it
+		used -= 1 + random() % (length - 1);
+	}
+	else
+	{	// noise before the frame, sometimes with a false UBX sync
+		size_t garbage = 1 + random() % GEN_MAX_GARBAGE;
+		memmove(&buffer[start + garbage], &buffer[start], length);
+		for(size_t i = 0; i < garbage; i++)
+			buffer[start + i] = static_cast<unsigned char>(random());
+		if(garbage >= 2 && random() % 4 == 0)
+		{
+			buffer[start + garbage - 2] = 0xb5;
+			buffer[start + garbage - 1] = 0x62;
+		}
+		used += garbage;
+	}
+	corrupted[kind]++;
+}
+
+// writeRAWX: RXM-RAWX with every SV
+void LogGenerator::writeRAWX(void)
+{
+	double t = tow / 1000.0;
+	unsigned char * p = beginUBX(RXM, RAWX, 16 + 32 * numSV);
+
+	putR8(p, t);
+	put2(p + 8, week);
+	put1(p + 10, 18);       // leap seconds
+	put1(p + 11, numSV);
+	put1(p + 12, 0x01);     // leap seconds valid
+	put1(p + 13, 1);        // version
+
+	for(int i = 0; i < numSV; i++)
+	{
+		const Channel &ch = channel[i];
+		unsigned char * b = p + 16 + 32 * i;
+		double range = ch.range + ch.rate * t + (random() & 0xFFF) / 1024.0;
+		putR8(b, range);
+		putR8(b + 8, range / GEN_L1_WAVELENGTH);
+		putR4(b + 16, static_cast<float>(-ch.rate / GEN_L1_WAVELENGTH));
+		put1(b + 20, ch.gnssId);
+		put1(b + 21, ch.svId);
+		put2(b + 24, 64500);    // lock time, ms
+		put1(b + 26, ch.cno);
+		put1(b + 27, 3);        // stdev indices
+		put1(b + 28, 2);
+		put1(b + 29, 4);
+		put1(b + 30, 0x07);     // pr, cp valid, half cycle resolved
+	}
+	endUBX();
+}
+
+// writeRAW: RXM-RAW with the GPS SVs
+void LogGenerator::writeRAW(void)
+{
+	double t = tow / 1000.0;
+	unsigned char * p = beginUBX(RXM, RAW, 8 + 24 * numGPS);
+
+	put4(p, tow);
+	put2(p + 4, week);
+	put1(p + 6, numGPS);
+
+	for(int i = 0; i < numGPS; i++)
+	{
+		const Channel &ch = channel[i];
+		unsigned char * b = p + 8 + 24 * i;
+		double range = ch.range + ch.rate * t + (random() & 0xFFF) / 1024.0;
+		putR8(b, range / GEN_L1_WAVELENGTH);
+		putR8(b + 8, range);
+		putR4(b + 16, static_cast<float>(-ch.rate / GEN_L1_WAVELENGTH));
+		put1(b + 20, ch.svId);
+		put1(b + 21, 7);        // mesQI
+		put1(b + 22, ch.cno);
+	}
+	endUBX();
+}
+
+// writeSFRBX: the LNAV subframe broadcast in this 6 s slot, every GPS SV
+void LogGenerator::writeSFRBX(void)
+{
+	unsigned long towCount = tow / 6000 + 1;       // HOW TOW of the next subframe
+	int subframe = static_cast<int>(towCount % 5) + 1;
+	unsigned long iode = (week * 84 + tow / 7200000) & 0xFF;   // changes every two hours
+
+	for(int i = 0; i < numGPS; i++)
+	{
+		unsigned long data[10];
+		for(int w = 2; w < 10; w++)
+			data[w] = random() & 0xFFFFFF;
+		data[0] = 0x8B0000;                                     // preamble
+		data[1] = ((towCount & 0x1FFFF) << 7) | (subframe << 2);
+		if(subframe == 1)
+		{
+			data[2] = (data[2] & ~0x3UL) | (iode >> 8);         // IODC
+			data[7] = (data[7] & 0xFFFF) | (iode << 16);
+		}
+		else if(subframe == 2)
+			data[2] = (data[2] & 0xFFFF) | (iode << 16);        // IODE
+		else if(subframe == 3)
+			data[9] = (data[9] & 0xFFFF) | (iode << 16);
+
+		unsigned char * p = beginUBX(RXM, SFRBX, 8 + 40);
+		put1(p, channel[i].gnssId);
+		put1(p + 1, channel[i].svId);
+		put1(p + 4, 10);        // words
+		put1(p + 5, i);         // channel
+		put1(p + 6, 2);         // version
+		for(int w = 0; w < 10; w++)
+			put4(p + 8 + 4 * w, data[w] << 6);    // parity bits left zero
+		endUBX();
+	}
+}
+
+// writeMEASX: RXM-MEASX with every SV
+void LogGenerator::writeMEASX(void)
+{
+	unsigned char * p = beginUBX(RXM, MEASX, 44 + 24 * numSV);
+
+	put4(p + 4, tow);           // GPS, GLONASS and BeiDou time
+	put4(p + 8, (tow + 10800000UL - 18000) % 86400000UL);
+	put4(p + 12, (tow + 604800000UL - 14000) % 604800000UL);
+	put4(p + 20, tow);          // QZSS
+	put2(p + 24, 16);
+	put2(p + 26, 16);
+	put2(p + 28, 16);
+	put2(p + 32, 16);
+	put1(p + 34, numSV);
+	put1(p + 35, 0x02);         // TOW set
+
+	for(int i = 0; i < numSV; i++)
+	{
+		const Channel &ch = channel[i];
+		unsigned char * b = p + 44 + 24 * i;
+		long doppler = static_cast<long>(-ch.rate * 25.0);             // 0.04 m/s
+		put1(b, ch.gnssId);
+		put1(b + 1, ch.svId);
+		put1(b + 2, ch.cno);
+		put1(b + 3, 1);
+		put4(b + 4, doppler);
+		put4(b + 8, static_cast<long>(-ch.rate / GEN_L1_WAVELENGTH * 5.0));   // 0.2 Hz
+		put2(b + 12, random() % 1023);
+		put2(b + 14, random() % 1024);
+		put4(b + 16, random() & 0x1FFFFF);
+		put1(b + 21, 10);
+	}
+	endUBX();
+}
+
+// writeNAV: the NAV-* solution set of an epoch
+void LogGenerator::writeNAV(void)
+{
+	unsigned char * p;
+
+	p = beginUBX(NAV, SOL, 52);
+	put4(p, tow);
+	put2(p + 8, week);
+	put1(p + 10, 3);            // 3D fix
+	put1(p + 11, 0x0D);         // fix OK, week and TOW valid
+	put4(p + 12, static_cast<long>(GEN_RECEIVER_X * 100.0) + random() % 200 - 100);
+	put4(p + 16, static_cast<long>(GEN_RECEIVER_Y * 100.0) + random() % 200 - 100);
+	put4(p + 20, static_cast<long>(GEN_RECEIVER_Z * 100.0) + random() % 200 - 100);
+	put4(p + 24, 250);
+	put4(p + 40, 30);
+	put2(p + 44, 140);
+	put1(p + 47, numSV);
+	endUBX();
+
+	p = beginUBX(NAV, POSLLH, 28);
+	put4(p, tow);
+	put4(p + 4, static_cast<long>(GEN_RECEIVER_LON * 1e7));
+	put4(p + 8, static_cast<long>(GEN_RECEIVER_LAT * 1e7));
+	put4(p + 12, static_cast<long>(GEN_RECEIVER_H * 1000.0));
+	put4(p + 16, static_cast<long>((GEN_RECEIVER_H + 16.0) * 1000.0));
+	put4(p + 20, 1800);
+	put4(p + 24, 2600);
+	endUBX();
+
+	p = beginUBX(NAV, STATUS, 16);
+	put4(p, tow);
+	put1(p + 4, 3);
+	put1(p + 5, 0x0D);
+	put4(p + 8, 28000);
+	put4(p + 12, static_cast<unsigned long>(epochs * intervalMs));
+	endUBX();
+
+	p = beginUBX(NAV, DOP, 18);
+	put4(p, tow);
+	put2(p + 4, 180);
+	put2(p + 6, 140);
+	put2(p + 8, 90);
+	put2(p + 10, 110);
+	put2(p + 12, 80);
+	put2(p + 14, 60);
+	put2(p + 16, 50);
+	endUBX();
+
+	p = beginUBX(NAV, TIMEGPS, 16);
+	put4(p, tow);
+	put2(p + 8, week);
+	put1(p + 10, 18);
+	put1(p + 11, 0x07);
+	put4(p + 12, 20);
+	endUBX();
+
+	p = beginUBX(NAV, CLOCK, 20);
+	put4(p, tow);
+	put4(p + 4, static_cast<unsigned long>(epochs * 37 % 1000000));
+	put4(p + 8, 37);
+	put4(p + 12, 20);
+	put4(p + 16, 400);
+	endUBX();
+
+	p = beginUBX(NAV, SVINFO, 8 + 12 * numSV);
+	put4(p, tow);
+	put1(p + 4, numSV);
+	put1(p + 5, 0x04);          // u-blox 8 chip
+	for(int i = 0; i < numSV; i++)
+	{
+		const Channel &ch = channel[i];
+		unsigned char * b = p + 8 + 12 * i;
+		put1(b, i);
+		put1(b + 1, ch.gnssId == 0 ? ch.svId : 210 + ch.svId);
+		put1(b + 2, 0x0D);
+		put1(b + 3, 7);
+		put1(b + 4, ch.cno);
+		put1(b + 5, ch.elevation);
+		put2(b + 6, ch.azimuth);
+		put4(b + 8, random() % 2000 - 1000);
+	}
+	endUBX();
+}
+
+// writeGSV: $--GSV sentences for the GPS and Galileo SVs in view
+void LogGenerator::writeGSV(void)
+{
+	char sentence[96];
+
+	for(int system = 0; system < 2; system++)
+	{
+		int first = (system == 0) ? 0 : numGPS;
+		int count = (system == 0) ? numGPS : numSV - numGPS;
+		int total = (count + 3) / 4;
+
+		for(int s = 0; s < total; s++)
+		{
+			char * p = sentence;
+			*p++ = 'G';
+			*p++ = (system == 0) ? 'P' : 'A';
+			memcpy(p, "GSV,", 4);
+			p += 4;
+			p = putDecimal(p, total, 1);
+			*p++ = ',';
+			p = putDecimal(p, s + 1, 1);
+			*p++ = ',';
+			p = putDecimal(p, count, 2);
+			for(int k = 4 * s; k < count && k < 4 * s + 4; k++)
+			{
+				const Channel &ch = channel[first + k];
+				*p++ = ',';
+				p = putDecimal(p, ch.svId, 2);
+				*p++ = ',';
+				p = putDecimal(p, ch.elevation, 2);
+				*p++ = ',';
+				p = putDecimal(p, ch.azimuth, 3);
+				*p++ = ',';
+				p = putDecimal(p, ch.cno, 2);
+			}
+			*p = '\0';
+			writeNMEA(sentence);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+//**********************************************************************
+// File:			GenUBX.h
+// Programmer:		Guoyu Fu
+// Description:		Synthetic UBX/NMEA log generator
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Writes a stream of valid UBX frames and NMEA sentences, one epoch at
+// a time, for testing the parser on logs far larger than the bundled
+// ones.  The mix gives how many messages of each kind are written per
+// epoch:
+//   rawx  - RXM-RAWX with every simulated SV
+//   raw   - RXM-RAW with the GPS SVs
+//   sfrbx - RXM-SFRBX LNAV subframes, one per GPS SV every 6 s
+//   measx - RXM-MEASX with every simulated SV
+//   nav   - NAV-SOL, -POSLLH, -STATUS, -DOP, -TIMEGPS, -CLOCK, -SVINFO
+//   gsv   - $GPGSV/$GAGSV burst
+// The first 32 SVs are GPS, any more are Galileo.  Ranges, carrier
+// phases and Dopplers follow a constant range rate per SV and the nav
+// subframes carry a new IODE every two hours, so the data decodes
+// sensibly, but orbits and positions are not physical.
+//
+// Checksums are real.  With a corruption rate set, that fraction of
+// frames is damaged after its checksum is computed: a byte is changed
+// (checksum or length error), the frame is truncated, or random bytes
+// are inserted before it (resync).  Frames are built in a large buffer
+// and written in blocks.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef GEN_UBX_H
+#define GEN_UBX_H
+
+// defined constants
+#define GEN_MAX_SV        64        // simulated SVs, GPS 1-32 then Galileo
+#define GEN_BUFFER_SIZE   (4 << 20) // bytes buffered before a write
+#define GEN_MAX_GARBAGE   64        // bytes inserted by one corruption
+#define GEN_START_WEEK    1900
+
+// message kinds of the mix
+#define GEN_RAWX       0
+#define GEN_RAW        1
+#define GEN_SFRBX      2
+#define GEN_MEASX      3
+#define GEN_NAV        4
+#define GEN_GSV        5
+#define GEN_NUM_KINDS  6
+
+// corruption kinds
+#define GEN_FLIP       0
+#define GEN_TRUNCATE   1
+#define GEN_GARBAGE    2
+
+// included libraries
+#include <fstream>
+#include <string>
+#include <vector>
+
+// definition of LogGenerator class
+class LogGenerator
+{
+	public:
+		// constructors
+		LogGenerator();
+
+		// destructor
+		~LogGenerator(void);
+
+		// methods
+		int  setMix(const std::string &spec);
+		int  open(const std::string &fname);
+		int  generate(unsigned long long bytes);
+		int  close(void);
+
+		// settings, fixed once open() is called
+		int    numSV;               // simulated SVs
+		int    intervalMs;          // epoch interval
+		double corruptionRate;      // fraction of frames damaged
+		unsigned long long seed;
+		int    mix[GEN_NUM_KINDS];  // messages per epoch of each kind
+
+		// statistics
+		unsigned long long bytesWritten;
+		unsigned long long frames;
+		unsigned long long epochs;
+		unsigned long long corrupted[3];
+
+	private:
+		struct Channel {
+			int    gnssId;
+			int    svId;
+			double range;            // m at the start of the log
+			double rate;             // m/s
+			int    cno;              // dBHz
+			int    elevation;        // deg
+			int    azimuth;          // deg
+		};
+
+		LogGenerator(const LogGenerator &);             // not copyable
+		LogGenerator & operator=(const LogGenerator &);
+
+		std::ofstream out;
+		std::vector<unsigned char> buffer;
+		size_t used;                 // bytes in buffer
+		unsigned long long state;    // random generator
+		Channel channel[GEN_MAX_SV];
+		int    numGPS;
+		int    week;
+		unsigned long tow;           // ms
+
+		// methods
+		unsigned long random(void);
+		int  flush(void);
+		unsigned char * beginUBX(int messageClass, int messageID, int length);
+		void endUBX(void);
+		void writeNMEA(const char * sentence);
+		void finish(size_t start);
+
+		void writeRAWX(void);
+		void writeRAW(void);
+		void writeSFRBX(void);
+		void writeMEASX(void);
+		void writeNAV(void);
+		void writeGSV(void);
+};
+
+#endif // GEN_UBX_H
@@ -0,0 +1,223 @@
+//**********************************************************************
+// File:			ReplayUBX.cpp
+// Programmer:		Guoyu Fu
+// Description:		Replays a receiver log through a pseudo terminal
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <chrono>
+#include <thread>
+
+#include "ReplayUBX.h"
+
+#ifndef _WIN32
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
+using namespace std;
+
+// LogReplayer: default constructor
+LogReplayer::LogReplayer()
+{
+	baud = REPLAY_DEFAULT_BAUD;
+	bytesWritten = 0;
+	master = -1;
+}
+
+// ~LogReplayer: destructor
+LogReplayer::~LogReplayer(void)
+{
+	close();
+}
+
+// open: opens the log to replay
+//   returns 0 on success, -1 if the file cannot be opened
+int LogReplayer::open(const string &fname)
+{
+	in.open(fname.c_str(), ios::in | ios::binary);
+	return(in.is_open() ? 0 : -1);
+}
+
+#ifndef _WIN32
+
+// openPty: creates the pty in raw mode
+//   returns 0 and the slave device name on success, -1 on error
+int LogReplayer::openPty(string &slaveName)
+{
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master < 0)
+		return(-1);
+	if(grantpt(master) != 0 || unlockpt(master) != 0 || ptsname(master) == 0)
+	{
+		close();
+		return(-1);
+	}
+	slave = ptsname(master);
+
+	// raw mode, so that no byte of the binary stream is translated; the
+	// settings stay with the pty after this descriptor is closed
+	int fd = ::open(slave.c_str(), O_RDWR | O_NOCTTY);
+	if(fd < 0)
+	{
+		close();
+		return(-1);
+	}
+	termios mode;
+	tcgetattr(fd, &mode);
+	cfmakeraw(&mode);
+	tcsetattr(fd, TCSANOW, &mode);
+	::close(fd);
+
+	slaveName = slave;
+	return(0);
+}
+
+// waitReader: waits until a reader has opened the slave
+//   timeoutMs: longest wait, < 0 => no limit
+//   returns 0 once a reader is there, -1 on timeout
+int LogReplayer::waitReader(int timeoutMs)
+{
+	pollfd fd;
+	fd.fd = master;
+	fd.events = POLLOUT;
+
+	// the master reports a hangup while no descriptor of the slave is open
+	for(int waited = 0; timeoutMs < 0 || waited < timeoutMs; waited += 100)
+	{
+		fd.revents = 0;
+		if(poll(&fd, 1, 0) >= 0 && !(fd.revents & POLLHUP))
+			return(0);
+		this_thread::sleep_for(chrono::milliseconds(100));
+	}
+	return(-1);
+}
+
+// run: writes the whole log at the byte rate of the line
+//   returns 0 on success, -1 on a write error
+int LogReplayer::run(void)
+{
+	double bytesPerSecond = baud / 10.0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::steady_clock::time_point next = start;
+
+	buffer.resize(static_cast<size_t>(bytesPerSecond * REPLAY_TICK_MS / 1000.0) + 1);
+
+	while(in)
+	{
+		next += chrono::milliseconds(REPLAY_TICK_MS);
+		this_thread::sleep_until(next);
+
+		// bytes due by now, the schedule does not drift with late wakeups
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		unsigned long long due = static_cast<unsigned long long>(seconds * bytesPerSecond);
+		if(due <= bytesWritten)
+			continue;
+		size_t length = static_cast<size_t>(due - bytesWritten);
+		if(length > buffer.size())
+			buffer.resize(length);
+
+		in.read(&buffer[0], length);
+		if(writeAll(&buffer[0], static_cast<size_t>(in.gcount())) != 0)
+			return(-1);
+	}
+
+	drain();
+	return(0);
+}
+
+// close: closes the pty and the log, a reader sees the end of the stream
+void LogReplayer::close(void)
+{
+	if(master >= 0)
+		::close(master);
+	master = -1;
+	if(in.is_open())
+		in.close();
+}
+
+// writeAll: writes a block to the master
+int LogReplayer::writeAll(const char * data, size_t length)
+{
+	while(length > 0)
+	{
+		ssize_t n = write(master, data, length);
+		if(n < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return(-1);
+		}
+		data += n;
+		length -= n;
+		bytesWritten += n;
+	}
+	return(0);
+}
+
+// drain: waits until the reader has taken the bytes queued in the pty
+void LogReplayer::drain(void)
+{
+	int fd = ::open(slave.c_str(), O_RDWR | O_NOCTTY);
+	if(fd < 0)
+		return;
+
+	int queued = 1;
+	for(int waited = 0; waited < REPLAY_DRAIN_MS && queued > 0; waited += REPLAY_TICK_MS)
+	{
+		if(ioctl(fd, FIONREAD, &queued) != 0)
+			break;
+		if(queued > 0)
+			this_thread::sleep_for(chrono::milliseconds(REPLAY_TICK_MS));
+	}
+	::close(fd);
+}
+
+#else  // _WIN32
+
+// no pseudo terminals on Windows, replay to a null-modem COM pair instead
+int LogReplayer::openPty(string &slaveName)
+{
+	return(-1);
+}
+
+int LogReplayer::waitReader(int timeoutMs)
+{
+	return(-1);
+}
+
+int LogReplayer::run(void)
+{
+	return(-1);
+}
+
+void LogReplayer::close(void)
+{
+	if(in.is_open())
+		in.close();
+}
+
+int LogReplayer::writeAll(const char * data, size_t length)
+{
+	return(-1);
+}
+
+void LogReplayer::drain(void)
+{
+}
+
+#endif // _WIN32
@@ -0,0 +1,73 @@
+//**********************************************************************
+// File:			ReplayUBX.h
+// Programmer:		Guoyu Fu
+// Description:		Replays a receiver log through a pseudo terminal
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Makes a recorded log look like a receiver on a serial port: the log
+// is written to the master side of a pty at the byte rate of a serial
+// line (10 bits per byte), so a parser reading the slave side sees the
+// frames arrive as they would live.  Used to measure end-to-end
+// latencies (LibLatency.h) without a receiver.
+//
+// Replay waits until a reader has opened the slave, and at the end
+// waits until the reader has taken all bytes before closing the
+// master, which the reader sees as the end of the stream.  POSIX only.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef REPLAY_UBX_H
+#define REPLAY_UBX_H
+
+// defined constants
+#define REPLAY_DEFAULT_BAUD  115200
+#define REPLAY_TICK_MS       5         // time between writes
+#define REPLAY_DRAIN_MS      5000      // longest wait for the reader at the end
+
+// included libraries
+#include <fstream>
+#include <string>
+#include <vector>
+
+// definition of LogReplayer class
+class LogReplayer
+{
+	public:
+		// constructors
+		LogReplayer();
+
+		// destructor
+		~LogReplayer(void);
+
+		// methods
+		int  open(const std::string &fname);
+		int  openPty(std::string &slaveName);
+		int  waitReader(int timeoutMs);
+		int  run(void);
+		void close(void);
+
+		// settings
+		int baud;                       // bits per second, 10 bits per byte
+
+		// statistics
+		unsigned long long bytesWritten;
+
+	private:
+		LogReplayer(const LogReplayer &);             // not copyable
+		LogReplayer & operator=(const LogReplayer &);
+
+		std::ifstream in;
+		std::string slave;
+		int master;                     // pty master descriptor, -1 if none
+		std::vector<char> buffer;
+
+		// methods
+		int  writeAll(const char * data, size_t length);
+		void drain(void);
+};
+
+#endif // REPLAY_UBX_H
@@ -0,0 +1,103 @@
+// included libraries
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include "GenUBX.h"
+using namespace std;
+
+// parseSize: bytes from a count with an optional K, M or G suffix
+static unsigned long long parseSize(const string &text)
+{
+	char * end;
+	double value = strtod(text.c_str(), &end);
+	switch(*end)
+	{
+		case 'G': case 'g':
+			value *= 1024.0;
+			// fall through
+		case 'M': case 'm':
+			value *= 1024.0;
+			// fall through
+		case 'K': case 'k':
+			value *= 1024.0;
+			break;
+	}
+	return(value > 0.0 ? static_cast<unsigned long long>(value) : 0);
+}
+
+// main program module
+//   genubx [-s size] [-n SVs] [-m mix] [-c corruption rate] [-i interval ms] [-seed n] output.ubx
+int main(int argc, char* argv[])
+{
+	LogGenerator generator;
+	unsigned long long size = 100ULL << 20;
+	string output;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg == "-s" && i + 1 < argc)
+			size = parseSize(argv[++i]);
+		else if(arg == "-n" && i + 1 < argc)
+			generator.numSV = atoi(argv[++i]);
+		else if(arg == "-m" && i + 1 < argc)
+		{
+			if(generator.setMix(argv[++i]) != 0)
+			{
+				cout << "Unknown message mix " << argv[i] << " (kinds: rawx, raw, sfrbx, measx, nav, gsv)" << endl;
+				return(1);
+			}
+		}
+		else if(arg == "-c" && i + 1 < argc)
+			generator.corruptionRate = atof(argv[++i]);
+		else if(arg == "-i" && i + 1 < argc)
+			generator.intervalMs = atoi(argv[++i]);
+		else if(arg == "-seed" && i + 1 < argc)
+			generator.seed = strtoull(argv[++i], 0, 10);
+		else
+			output = arg;
+	}
+
+	if(output.empty())
+	{
+		cout << "usage: genubx [-s size[K|M|G]] [-n SVs] [-m rawx=1,sfrbx,measx,nav,gsv] "
+		     << "[-c corruption rate] [-i interval ms] [-seed n] output.ubx" << endl;
+		return(1);
+	}
+
+	if(generator.open(output) != 0)
+	{
+		cout << "Unable to open output file!" << endl;
+		return(1);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	const unsigned long long block = 256ULL << 20;
+	for(unsigned long long done = 0; done < size; done += block)
+	{
+		if(generator.generate(size - done < block ? size - done : block) != 0)
+		{
+			cout << endl << "Write error!" << endl;
+			return(1);
+		}
+		cout << "\r" << (generator.bytesWritten >> 20) << " MB" << flush;
+	}
+	if(generator.close() != 0)
+	{
+		cout << endl << "Write error!" << endl;
+		return(1);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "\r" << generator.bytesWritten << " bytes, " << generator.frames << " frames, "
+	     << generator.epochs << " epochs" << endl;
+	cout << "corrupted: " << generator.corrupted[GEN_FLIP] << " changed, "
+	     << generator.corrupted[GEN_TRUNCATE] << " truncated, "
+	     << generator.corrupted[GEN_GARBAGE] << " after garbage" << endl;
+	cout << fixed << setprecision(1) << seconds << " s, "
+	     << (seconds > 0.0 ? generator.bytesWritten / 1048576.0 / seconds : 0.0) << " MB/s" << endl;
+
+	return(0);
+}
@@ -0,0 +1,88 @@
+// included libraries
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "BenchUBX.h"
+using namespace std;
+
+// logs measured when none are given on the command line
+static const char * corpus[] = {
+	"Site1-Northside-21Nov2012.ubx",
+	"Site2-Doherty-19Nov2012.ubx",
+	"cleanStatic_final_r1.ubx",
+	"cleanStatic_final_r2.ubx",
+	"cleanStatic_final_r3.ubx",
+	"cleanStatic_final_r4.ubx",
+	"cleanStatic_receiveroffset.ubx",
+	"cleanStatic_receiveroffset_2.ubx",
+	"ds4_final_r1.ubx",
+	"ds4_final_r2.ubx",
+	"ds4_final_r3.ubx",
+	"ds4_final_r4.ubx",
+	"ds4_final_r5.ubx",
+	"6t-ds4.ubx",
+	"6t-ds4-final-r2.ubx",
+	"6t-nosbasintegrity.ubx",
+	"COM6_160414_173742.ubx",
+	"COM6_160414_173837.ubx",
+	"COM6_160414_174644.ubx",
+	"COM6_160414_175406.ubx",
+	"COM6_160414_175639.ubx",
+	"COM6_160417_025533.ubx",
+	"COM6_160417_025815.ubx",
+	"COM6_160417_030239.ubx",
+	"COM6_160417_030327.ubx",
+	"COM6_160417_030640.ubx"
+};
+
+// main program module
+//   benchubx [-r repeats] [-o report.json] [-d corpus directory] [log ...]
+int main(int argc, char* argv[])
+{
+	ThroughputBench bench;
+	string report = "benchmark.json";
+	string directory = "../ParseUBX/";
+	vector<string> inputs;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg == "-r" && i + 1 < argc)
+			bench.repeats = atoi(argv[++i]);
+		else if(arg == "-o" && i + 1 < argc)
+			report = argv[++i];
+		else if(arg == "-d" && i + 1 < argc)
+			directory = string(argv[++i]) + "/";
+		else
+			inputs.push_back(arg);
+	}
+	if(bench.repeats < 1)
+		bench.repeats = 1;
+
+	if(inputs.empty())
+		for(unsigned int i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++)
+			inputs.push_back(directory + corpus[i]);
+
+	for(unsigned int i = 0; i < inputs.size(); i++)
+	{
+		cout << i + 1 << "/" << inputs.size() << " " << inputs[i] << endl;
+		bench.run(inputs[i]);
+	}
+
+	if(bench.results.empty())
+	{
+		cout << "No logs could be read." << endl;
+		return(1);
+	}
+
+	bench.writeSummary(cout);
+	if(bench.writeJSON(report) != 0)
+	{
+		cout << "Unable to write " << report << endl;
+		return(1);
+	}
+	cout << "Results written to " << report << endl;
+
+	return(0);
+}
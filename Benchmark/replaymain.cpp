@@ -0,0 +1,82 @@
+//**********************************************************************
+// File:			replaymain.cpp
+// Programmer:		Guoyu Fu
+// Description:		Replays a receiver log through a pseudo terminal
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Prints the slave device, then waits for a reader, e.g.
+//   replayubx -b 115200 ../ParseUBX/ds3_r2.ubx
+//   ParseUBX /dev/pts/N ds3_r2.csv ds3_r2-latency.csv
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include "ReplayUBX.h"
+using namespace std;
+
+// main program module
+//   replayubx [-b baud] [-w wait s] input.ubx
+int main(int argc, char* argv[])
+{
+	LogReplayer replayer;
+	int wait = 60;    // s for a reader to open the slave
+	string input;
+	string slave;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg == "-b" && i + 1 < argc)
+			replayer.baud = atoi(argv[++i]);
+		else if(arg == "-w" && i + 1 < argc)
+			wait = atoi(argv[++i]);
+		else
+			input = arg;
+	}
+
+	if(input.empty() || replayer.baud <= 0)
+	{
+		cout << "usage: replayubx [-b baud] [-w wait s] input.ubx" << endl;
+		return(1);
+	}
+
+	if(replayer.open(input) != 0)
+	{
+		cout << "Unable to open input file!" << endl;
+		return(1);
+	}
+	if(replayer.openPty(slave) != 0)
+	{
+		cout << "Unable to create a pseudo terminal!" << endl;
+		return(1);
+	}
+
+	cout << slave << endl;
+	if(replayer.waitReader(wait * 1000) != 0)
+	{
+		cout << "No reader opened " << slave << endl;
+		return(1);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if(replayer.run() != 0)
+	{
+		cout << "Write error!" << endl;
+		return(1);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	replayer.close();
+
+	cout << replayer.bytesWritten << " bytes in " << fixed << setprecision(1) << seconds << " s" << endl;
+	return(0);
+}
@@ -0,0 +1,280 @@
+//**********************************************************************
+// File:			BatchPositioner.cpp
+// Programmer:		Guoyu Fu
+// Description:		Epoch-parallel batch positioning over a whole log
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+#include <thread>
+
+#include "BatchPositioner.h"
+#include "LeastSquares.h"
+#include "DirectSolution.h"
+#include "SVState.h"
+
+using namespace std;
+
+
+// BatchPositioner: default constructor
+BatchPositioner::BatchPositioner()
+{
+	nextSegment.store(0);
+	segmentSize = BATCH_SEGMENT_EPOCHS;
+	numSegments = 0;
+}
+
+// setCorrections: correction steps applied to every epoch (copied)
+void BatchPositioner::setCorrections(const CorrectionStage &stage)
+{
+	corrections = stage;
+}
+
+// addEpoch: stores the rows of epoch that have an SV state
+//   klob: ionospheric model in effect at this epoch
+//   returns the epoch index
+int BatchPositioner::addEpoch(const EpochSVData &epoch, const KlobucharParams &klob)
+{
+	BatchEpoch e;
+
+	// models only change every few days, keep one copy per change
+	bool same = !klobs.empty() && klobs.back().valid == klob.valid;
+	for(int k = 0; same && k < 4; k++)
+		same = klobs.back().alpha[k] == klob.alpha[k] && klobs.back().beta[k] == klob.beta[k];
+	if(!same)
+		klobs.push_back(klob);
+
+	e.week  = epoch.week;
+	e.tow   = epoch.tow;
+	e.first = sv.size();
+	e.numSV = 0;
+	e.klob  = klobs.size() - 1;
+
+	for(unsigned int i = 0; i < epoch.numSV; i++)
+	{
+		if(!epoch.valid[i])
+			continue;  // no orbit for this SV
+
+		sv.push_back(epoch.sv[i]);
+		pr.push_back(epoch.pr[i]);
+		x.push_back(epoch.x[i]);
+		y.push_back(epoch.y[i]);
+		z.push_back(epoch.z[i]);
+		clockBias.push_back(epoch.clockBias[i]);
+		relativistic.push_back(epoch.relativistic[i]);
+		e.numSV++;
+	}
+
+	epochs.push_back(e);
+
+	return(epochs.size() - 1);
+}
+
+// solve: solves every stored epoch
+//   threads: worker threads, 0 => one per hardware thread
+//   segmentEpochs: epochs per independently seeded segment
+//   returns the number of epochs without a valid fix
+int BatchPositioner::solve(unsigned int threads, unsigned int segmentEpochs)
+{
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+	if(segmentEpochs == 0)
+		segmentEpochs = BATCH_SEGMENT_EPOCHS;
+
+	segmentSize = segmentEpochs;
+	numSegments = (epochs.size() + segmentSize - 1) / segmentSize;
+	if(threads > numSegments)
+		threads = numSegments;
+	nextSegment.store(0);
+	results.resize(epochs.size());
+
+	// the calling thread works too
+	vector<thread> pool;
+	for(unsigned int t = 1; t < threads; t++)
+		pool.push_back(thread(&BatchPositioner::worker, this));
+	worker();
+	for(unsigned int t = 0; t < pool.size(); t++)
+		pool[t].join();
+
+	int failed = 0;
+	for(unsigned int i = 0; i < results.size(); i++)
+		if(results[i].errorcode != 0)
+			failed++;
+
+	return(failed);
+}
+
+// clear: drops all epochs and results
+void BatchPositioner::clear(void)
+{
+	epochs.clear();
+	sv.clear();
+	pr.clear();
+	x.clear();
+	y.clear();
+	z.clear();
+	clockBias.clear();
+	relativistic.clear();
+	klobs.clear();
+	results.clear();
+}
+
+// worker: solves segments until none are left
+void BatchPositioner::worker(void)
+{
+	CorrectionStage stage = corrections;  // private copy, klob changes per epoch
+
+	while(true)
+	{
+		unsigned int s = nextSegment.fetch_add(1);
+		if(s >= numSegments)
+			break;
+
+		unsigned int first = s * segmentSize;
+		unsigned int last  = first + segmentSize;
+		if(last > epochs.size())
+			last = epochs.size();
+
+		solveSegment(first, last, stage);
+	}
+}
+
+// solveSegment: solves epochs [first, last) in sequence, warm starting each
+//   epoch from the one before as the sequential solver does
+void BatchPositioner::solveSegment(unsigned int first, unsigned int last, CorrectionStage &stage)
+{
+	EpochSVData epoch;
+	SequentialSolver solver;  // cold start, seeded on the first epoch
+
+	for(unsigned int n = first; n < last; n++)
+	{
+		const BatchEpoch &e = epochs[n];
+		BatchFix &fix = results[n];
+
+		// rebuild the epoch from the stored rows
+		epoch.week  = e.week;
+		epoch.tow   = e.tow;
+		epoch.numSV = e.numSV < MAX_EPOCH_SV ? e.numSV : MAX_EPOCH_SV;
+		for(unsigned int i = 0; i < epoch.numSV; i++)
+		{
+			unsigned int r = e.first + i;
+			epoch.sv[i] = sv[r];
+			epoch.pr[i] = pr[r];
+			epoch.x[i]  = x[r];
+			epoch.y[i]  = y[r];
+			epoch.z[i]  = z[r];
+			epoch.clockBias[i]    = clockBias[r];
+			epoch.relativistic[i] = relativistic[r];
+			epoch.valid[i] = 1;
+		}
+
+		stage.klob = klobs[e.klob];
+		solver.solve(epoch, stage, fix);
+	}
+}
+
+
+// epochRows: rows of the valid SVs of epoch, the pseudoranges corrected
+//   for the SV clock and the receiver clock estimate clockBias (meters)
+//   returns the number of rows
+static unsigned int epochRows(const EpochSVData &epoch, double clockBias,
+                              double rowX[], double rowY[], double rowZ[], double rowPR[])
+{
+	unsigned int rows = 0;
+
+	for(unsigned int i = 0; i < epoch.numSV && rows < LSQ_MAX_ROWS; i++)
+	{
+		if(!epoch.valid[i])
+			continue;  // no orbit for this SV
+		rowX[rows]  = epoch.x[i];
+		rowY[rows]  = epoch.y[i];
+		rowZ[rows]  = epoch.z[i];
+		rowPR[rows] = epoch.pr[i] + epoch.clockBias[i] * GPS_SPEED_OF_LIGHT - clockBias;
+		rows++;
+	}
+
+	return(rows);
+}
+
+
+// SequentialSolver: default constructor
+SequentialSolver::SequentialSolver()
+{
+	reset();
+}
+
+// reset: forgets the previous solution, the next epoch starts cold
+void SequentialSolver::reset(void)
+{
+	for(int i = 0; i < 4; i++)
+		solution[i] = 0.0;
+	position[0] = position[1] = position[2] = 0.0;  // unknown until the first fix
+	userClockBias = 0.0;
+}
+
+// solve: corrects the valid rows of epoch and solves them, starting
+//   from the solution of the previous epoch
+//   returns the solver error code (also in fix.errorcode)
+int SequentialSolver::solve(EpochSVData &epoch, CorrectionStage &stage, BatchFix &fix)
+{
+	double rowX[LSQ_MAX_ROWS], rowY[LSQ_MAX_ROWS], rowZ[LSQ_MAX_ROWS], rowPR[LSQ_MAX_ROWS];
+	unsigned int rows;
+
+	fix.week  = epoch.week;
+	fix.tow   = epoch.tow;
+	fix.x = fix.y = fix.z = 0.0;
+	fix.clockBias = 0.0;
+	fix.gdop  = 0.0;
+
+	// without a receiver position (cold start) the steps that need one
+	// (troposphere, ionosphere, elevation mask) are skipped on this pass
+	bool cold = position[0] * position[0] + position[1] * position[1] +
+		position[2] * position[2] <= SEED_MIN_RADIUS * SEED_MIN_RADIUS;
+	EpochSVData measured;
+	if(cold)
+		measured = epoch;
+
+	stage.apply(epoch, position, userClockBias);
+	rows = epochRows(epoch, userClockBias, rowX, rowY, rowZ, rowPR);
+
+	// closed form seed at the start and after clock jumps or gaps
+	if(seedSolution(rowX, rowY, rowZ, rowPR, rows, solution) == 1 && cold)
+	{	// correct the measurements again at the seed, so the first epoch of
+		// a log or segment gets every step, as the epochs after it do
+		epoch = measured;
+		stage.apply(epoch, solution, userClockBias);
+		rows = epochRows(epoch, userClockBias, rowX, rowY, rowZ, rowPR);
+	}
+	fix.numSV = rows;
+
+	fix.errorcode = nllsFixed<4>(rowX, rowY, rowZ, rowPR, NULL, rows, solution, &geometry);
+
+	// the next epoch starts from this one, good or bad, as in the sequential solver
+	position[0] = solution[0];
+	position[1] = solution[1];
+	position[2] = solution[2];
+
+	if(fix.errorcode == 0)
+	{
+		userClockBias += solution[3];
+
+		fix.x = solution[0];
+		fix.y = solution[1];
+		fix.z = solution[2];
+		fix.clockBias = userClockBias / GPS_SPEED_OF_LIGHT;
+		fix.gdop = geometry.gdop();
+	}
+
+	return(fix.errorcode);
+}
@@ -0,0 +1,111 @@
+//**********************************************************************
+// File:			BatchPositioner.h
+// Programmer:		Guoyu Fu
+// Description:		Epoch-parallel batch positioning over a whole log
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Epochs are collected with their SV states first, then split into
+// segments of consecutive epochs.  Each segment starts cold from the
+// closed form (Bancroft) solution, its first epoch corrected again at
+// that seed so no correction or the elevation mask is skipped, and warm
+// starts epoch to epoch inside the segment, exactly like the sequential
+// solver.  Segments are independent, so a pool of worker threads takes
+// them in any order; every fix is written to its own slot and the
+// results come back in epoch order.
+//
+// SequentialSolver is that warm started per-epoch solver on its own,
+// for callers that feed one receiver's epochs in order.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef BATCH_POSITIONER_H
+#define BATCH_POSITIONER_H
+
+// defined constants
+#define BATCH_SEGMENT_EPOCHS  300   // epochs per independently seeded segment
+
+// included libraries
+#include <vector>
+#include <atomic>
+
+#include "EpochData.h"
+#include "Corrections.h"
+#include "LeastSquares.h"
+
+// custom data types
+struct BatchFix {
+	int    week;           // GPS week of epoch
+	double tow;            // GPS time of week of epoch (seconds)
+	double x, y, z;        // receiver ECEF position (meters)
+	double clockBias;      // receiver clock bias (seconds)
+	unsigned int numSV;    // SVs used in the solution
+	double gdop;           // geometric dilution of precision
+	int    errorcode;      // solver return code (0 => fix valid)
+};
+
+// definition of SequentialSolver class
+class SequentialSolver
+{
+	public:
+		// constructors
+		SequentialSolver();
+
+		// methods
+		int  solve(EpochSVData &epoch, CorrectionStage &stage, BatchFix &fix);
+		void reset(void);
+
+	private:
+		double solution[4];       // last solution (x, y, z, clock bias residual)
+		double position[3];       // receiver position for the corrections
+		double userClockBias;     // accumulated receiver clock bias (meters)
+		SolutionGeometry<4> geometry;
+};
+
+// definition of BatchPositioner class
+class BatchPositioner
+{
+	public:
+		// constructors
+		BatchPositioner();
+
+		// methods
+		void setCorrections(const CorrectionStage &stage);
+		int  addEpoch(const EpochSVData &epoch, const KlobucharParams &klob);
+		int  solve(unsigned int threads = 0, unsigned int segmentEpochs = BATCH_SEGMENT_EPOCHS);
+		void clear(void);
+
+		unsigned int numEpochs(void) const { return(epochs.size()); }
+		const std::vector<BatchFix> & fixes(void) const { return(results); }
+
+	private:
+		struct BatchEpoch {
+			int    week;
+			double tow;
+			unsigned int first;    // first row in the row columns
+			unsigned int numSV;    // rows of this epoch
+			unsigned int klob;     // index of ionospheric model in use
+		};
+
+		void worker(void);
+		void solveSegment(unsigned int first, unsigned int last, CorrectionStage &stage);
+
+		// epochs and their SV rows (only rows with an SV state are kept)
+		std::vector<BatchEpoch> epochs;
+		std::vector<int>    sv;
+		std::vector<double> pr, x, y, z, clockBias, relativistic;
+		std::vector<KlobucharParams> klobs;
+
+		std::vector<BatchFix> results;
+		CorrectionStage corrections;
+
+		// segment dispatch
+		std::atomic<unsigned int> nextSegment;
+		unsigned int segmentSize;
+		unsigned int numSegments;
+};
+
+#endif // BATCH_POSITIONER_H
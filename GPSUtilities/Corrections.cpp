@@ -0,0 +1,412 @@
+//**********************************************************************
+// File:			Corrections.cpp
+// Programmer:		Guoyu Fu
+// Description:		Batch pseudorange error corrections
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Each kernel is written as straight loops over the epoch columns with
+// the branches of the reference algorithms turned into selects, so the
+// compiler can vectorize them across SVs.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+#include <cstddef>
+
+#include "Corrections.h"
+#include "SVState.h"
+
+using namespace std;
+
+// Niell mapping function coefficients at latitudes 15, 30, 45, 60 and 75 degrees
+static const double niellHydroAvg[3][5] = {
+	{ 1.2769934e-3, 1.2683230e-3, 1.2465397e-3, 1.2196049e-3, 1.2045996e-3 },
+	{ 2.9153695e-3, 2.9152299e-3, 2.9288445e-3, 2.9022565e-3, 2.9024912e-3 },
+	{ 62.610505e-3, 62.837393e-3, 63.721774e-3, 63.824265e-3, 64.258455e-3 } };
+static const double niellHydroAmp[3][5] = {
+	{ 0.0,          1.2709626e-5, 2.6523662e-5, 3.4000452e-5, 4.1202191e-5 },
+	{ 0.0,          2.1414979e-5, 3.0160779e-5, 7.2562722e-5, 11.723375e-5 },
+	{ 0.0,          9.0128400e-5, 4.3497037e-5, 84.795348e-5, 170.37206e-5 } };
+static const double niellWet[3][5] = {
+	{ 5.8021897e-4, 5.6794847e-4, 5.8118019e-4, 5.9727542e-4, 6.1641693e-4 },
+	{ 1.4275268e-3, 1.5138625e-3, 1.4572752e-3, 1.5007428e-3, 1.7599082e-3 },
+	{ 4.3472961e-2, 4.6729510e-2, 4.3908931e-2, 4.4626982e-2, 5.4736038e-2 } };
+static const double niellHeight[3] = { 2.53e-5, 5.49e-3, 1.14e-3 };
+
+
+// ecefToGeodetic: converts ECEF (meters) to WGS-84 latitude/longitude (radians)
+//   and height above ellipsoid (meters)
+void ecefToGeodetic(const double ecef[3], double &lat, double &lon, double &height)
+{
+	double p = sqrt(ecef[0] * ecef[0] + ecef[1] * ecef[1]);
+	double n = WGS84_A;
+
+	lon = atan2(ecef[1], ecef[0]);
+	lat = atan2(ecef[2], p * (1.0 - WGS84_E2));
+
+	// fixed point iteration on latitude, converges to < 1 mm in 5 steps
+	for(int i = 0; i < 5; i++)
+	{
+		double sinLat = sin(lat);
+		n = WGS84_A / sqrt(1.0 - WGS84_E2 * sinLat * sinLat);
+		lat = atan2(ecef[2] + n * WGS84_E2 * sinLat, p);
+	}
+
+	height = p / cos(lat) - n;
+}
+
+// lineOfSightENU: receiver to SV vectors of every row rotated into local
+//   east/north/up; branch free so the loop vectorizes
+static void lineOfSightENU(const EpochSVData &data, const double receiver[3], double lat, double lon,
+                           double e[], double n[], double u[])
+{
+	double sinLat = sin(lat), cosLat = cos(lat);
+	double sinLon = sin(lon), cosLon = cos(lon);
+	double rx = receiver[0], ry = receiver[1], rz = receiver[2];
+	unsigned int rows = data.numSV < MAX_EPOCH_SV ? data.numSV : MAX_EPOCH_SV;
+
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		double dx = data.x[i] - rx;
+		double dy = data.y[i] - ry;
+		double dz = data.z[i] - rz;
+
+		e[i] = -sinLon * dx + cosLon * dy;
+		n[i] = -sinLat * cosLon * dx - sinLat * sinLon * dy + cosLat * dz;
+		u[i] =  cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+	}
+}
+
+// computeElevAzim: fills elevation/azimuth columns of data for a receiver position
+void computeElevAzim(EpochSVData &data, const double receiver[3])
+{
+	double lat, lon, height;
+	ecefToGeodetic(receiver, lat, lon, height);
+	computeElevAzim(data, receiver, lat, lon);
+}
+
+// computeElevAzim: same, with the receiver geodetic position already known
+void computeElevAzim(EpochSVData &data, const double receiver[3], double lat, double lon)
+{
+	double e[MAX_EPOCH_SV], n[MAX_EPOCH_SV], u[MAX_EPOCH_SV];
+	lineOfSightENU(data, receiver, lat, lon, e, n, u);
+
+	for(unsigned int i = 0; i < data.numSV && i < MAX_EPOCH_SV; i++)
+	{
+		data.elev[i] = atan2(u[i], sqrt(e[i] * e[i] + n[i] * n[i]));
+		data.azim[i] = atan2(e[i], n[i]);
+	}
+}
+
+// maskElevation: drops the rows below the elevation mask (radians) and the
+//   rows without an SV state, compacting every column in place so later
+//   stages and the solver only see the rows kept
+//   returns the number of rows dropped
+int maskElevation(EpochSVData &data, const double receiver[3], double lat, double lon, double mask)
+{
+	double e[MAX_EPOCH_SV], n[MAX_EPOCH_SV], u[MAX_EPOCH_SV];
+	int keep[MAX_EPOCH_SV];
+	unsigned int rows = data.numSV < MAX_EPOCH_SV ? data.numSV : MAX_EPOCH_SV;
+
+	lineOfSightENU(data, receiver, lat, lon, e, n, u);
+
+	// sin(elev) >= sin(mask) without the square root: u|u| >= s|s| r^2
+	double s = sin(mask);
+	double limit = s * fabs(s);
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		double r2 = e[i] * e[i] + n[i] * n[i] + u[i] * u[i];
+		keep[i] = (u[i] * fabs(u[i]) >= limit * r2) & (data.valid[i] != 0);
+	}
+
+	// stream compaction: every row is written to the next free slot, the
+	// slot only advances for rows kept
+	unsigned int used = 0;
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		data.sv[used]           = data.sv[i];
+		data.pr[used]           = data.pr[i];
+		data.x[used]            = data.x[i];
+		data.y[used]            = data.y[i];
+		data.z[used]            = data.z[i];
+		data.clockBias[used]    = data.clockBias[i];
+		data.clockDrift[used]   = data.clockDrift[i];
+		data.relativistic[used] = data.relativistic[i];
+		data.iono[used]         = data.iono[i];
+		data.tropo[used]        = data.tropo[i];
+		data.valid[used]        = data.valid[i];
+		used += keep[i];
+	}
+
+	data.numSV = used;
+	return(rows - used);
+}
+
+// klobucharCorrection: removes the broadcast ionospheric model delay (IS-GPS-200
+//   20.3.3.5.2.5) from the pseudorange of every valid row
+//   lat/lon: receiver geodetic position (radians)
+int klobucharCorrection(EpochSVData &data, const KlobucharParams &klob, double lat, double lon)
+{
+	if(!klob.valid)
+		return(-1);
+
+	// the model works in semicircles
+	double phiU = lat / GPS_PI;
+	double lamU = lon / GPS_PI;
+	double a0 = klob.alpha[0], a1 = klob.alpha[1], a2 = klob.alpha[2], a3 = klob.alpha[3];
+	double b0 = klob.beta[0],  b1 = klob.beta[1],  b2 = klob.beta[2],  b3 = klob.beta[3];
+	double tow = data.tow;
+	unsigned int n = data.numSV;
+
+	for(unsigned int i = 0; i < n; i++)
+	{
+		double el = data.elev[i] / GPS_PI;
+		double az = data.azim[i];
+
+		// earth centred angle and ionospheric pierce point
+		double psi  = 0.0137 / (el + 0.11) - 0.022;
+		double phiI = phiU + psi * cos(az);
+		phiI = phiI >  0.416 ?  0.416 : phiI;
+		phiI = phiI < -0.416 ? -0.416 : phiI;
+		double lamI = lamU + psi * sin(az) / cos(phiI * GPS_PI);
+		double phiM = phiI + 0.064 * cos((lamI - 1.617) * GPS_PI);
+
+		// local time at pierce point
+		double t = 43200.0 * lamI + tow;
+		t -= floor(t / 86400.0) * 86400.0;
+
+		// obliquity factor, period and amplitude
+		double f   = 1.0 + 16.0 * (0.53 - el) * (0.53 - el) * (0.53 - el);
+		double per = b0 + phiM * (b1 + phiM * (b2 + phiM * b3));
+		double amp = a0 + phiM * (a1 + phiM * (a2 + phiM * a3));
+		per = per < 72000.0 ? 72000.0 : per;
+		amp = amp < 0.0 ? 0.0 : amp;
+
+		double x  = 2.0 * GPS_PI * (t - 50400.0) / per;
+		double x2 = x * x;
+		double day = amp * (1.0 - x2 / 2.0 + x2 * x2 / 24.0);
+		double delay = f * (5.0e-9 + (fabs(x) < 1.57 ? day : 0.0)) * GPS_SPEED_OF_LIGHT;
+
+		// rows without an SV state carry no usable geometry
+		delay = data.valid[i] ? delay : 0.0;
+		data.iono[i] = delay;
+		data.pr[i] -= delay;
+	}
+
+	return(0);
+}
+
+// niellInterp: linear interpolation of a Niell coefficient row in |latitude| (degrees)
+static double niellInterp(const double coef[5], double latDeg)
+{
+	int i = (int)(latDeg / 15.0);
+	if(i < 1)
+		return(coef[0]);
+	if(i > 4)
+		return(coef[4]);
+	return(coef[i - 1] * (1.0 - latDeg / 15.0 + i) + coef[i] * (latDeg / 15.0 - i));
+}
+
+// niellMap: continued fraction form of the Niell mapping functions
+static inline double niellMap(double sinEl, double a, double b, double c)
+{
+	return((1.0 + a / (1.0 + b / (1.0 + c))) / (sinEl + a / (sinEl + b / (sinEl + c))));
+}
+
+// dayOfYear: converts GPS week and seconds of week to fractional day of year
+static double dayOfYear(int week, double tow)
+{
+	// GPS time started on 1980 Jan 6, day 5 counted from 1980 Jan 1
+	double days = week * 7.0 + 5.0 + tow / 86400.0;
+	int year = 1980;
+
+	while(true)
+	{
+		int length = ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0) ? 366 : 365;
+		if(days < length)
+			break;
+		days -= length;
+		year++;
+	}
+
+	return(days + 1.0);
+}
+
+// CorrectionStage: default constructor, no steps
+CorrectionStage::CorrectionStage()
+{
+	numSteps = 0;
+	elevationMask = ELEVATION_MASK * GPS_PI / 180.0;
+}
+
+// add: appends a step, steps run in the order they were added
+int CorrectionStage::add(CorrectionStep step)
+{
+	if(step == NULL || numSteps >= MAX_CORRECTION_STEPS)
+		return(-1);
+
+	steps[numSteps++] = step;
+
+	return(0);
+}
+
+// clear: removes all steps
+void CorrectionStage::clear(void)
+{
+	numSteps = 0;
+}
+
+// apply: runs every step over the epoch
+//   receiver: approximate receiver ECEF position; steps that need the
+//   receiver geometry are skipped until it is known (cold start)
+//   clockBias: receiver clock bias estimate in meters, 0 if unknown
+//   once it is known, rows below elevationMask are removed from data first
+//   returns the number of steps that reported an error
+int CorrectionStage::apply(EpochSVData &data, const double receiver[3], double clockBias)
+{
+	CorrectionContext ctx;
+	int failed = 0;
+
+	ctx.receiver[0] = receiver[0];
+	ctx.receiver[1] = receiver[1];
+	ctx.receiver[2] = receiver[2];
+	ctx.clockBias = clockBias;
+	ctx.havePosition = (receiver[0] * receiver[0] + receiver[1] * receiver[1] +
+		receiver[2] * receiver[2]) > 6.0e6 * 6.0e6;
+	ctx.lat = ctx.lon = ctx.height = 0.0;
+	ctx.dayOfYear = dayOfYear(data.week, data.tow);
+	ctx.klob = klob;
+
+	for(unsigned int i = 0; i < data.numSV; i++)
+	{
+		data.iono[i] = 0.0;
+		data.tropo[i] = 0.0;
+	}
+
+	// geometry shared by every step is computed once per epoch
+	if(ctx.havePosition)
+	{
+		ecefToGeodetic(ctx.receiver, ctx.lat, ctx.lon, ctx.height);
+		if(elevationMask > NO_ELEVATION_MASK)
+			maskElevation(data, ctx.receiver, ctx.lat, ctx.lon, elevationMask);
+		computeElevAzim(data, ctx.receiver, ctx.lat, ctx.lon);
+	}
+
+	for(unsigned int s = 0; s < numSteps; s++)
+	{
+		if(steps[s](data, ctx) < 0)
+			failed++;
+	}
+
+	return(failed);
+}
+
+// relativisticStep: applies the SV clock relativistic term to the pseudorange
+int relativisticStep(EpochSVData &data, const CorrectionContext & /*ctx*/)
+{
+	for(unsigned int i = 0; i < data.numSV; i++)
+	{
+		double corr = data.relativistic[i] * GPS_SPEED_OF_LIGHT;
+		data.pr[i] += data.valid[i] ? corr : 0.0;
+	}
+
+	return(0);
+}
+
+// sagnacStep: rotates SV positions from the transmit time ECEF frame into the
+//   receive time frame (earth rotation during signal flight)
+int sagnacStep(EpochSVData &data, const CorrectionContext &ctx)
+{
+	for(unsigned int i = 0; i < data.numSV; i++)
+	{
+		// the pseudorange holds the receiver clock bias (up to +-1 ms), which
+		// would turn the SV by ~7.3e-8 rad, ~2 m along track; the geometric
+		// range is used once the position is known, else the clock estimates
+		// are taken out of the pseudorange
+		double range;
+		if(ctx.havePosition)
+		{
+			double dx = data.x[i] - ctx.receiver[0];
+			double dy = data.y[i] - ctx.receiver[1];
+			double dz = data.z[i] - ctx.receiver[2];
+			range = sqrt(dx * dx + dy * dy + dz * dz);
+		}
+		else
+			range = data.pr[i] - ctx.clockBias + data.clockBias[i] * GPS_SPEED_OF_LIGHT;
+
+		double theta = GPS_OMEGA_E * range / GPS_SPEED_OF_LIGHT;
+		double c = cos(theta), s = sin(theta);
+		double x = data.x[i], y = data.y[i];
+
+		data.x[i] =  c * x + s * y;
+		data.y[i] = -s * x + c * y;
+	}
+
+	return(0);
+}
+
+// klobucharStep: broadcast ionospheric model, needs the receiver position
+int klobucharStep(EpochSVData &data, const CorrectionContext &ctx)
+{
+	if(!ctx.havePosition || !ctx.klob.valid)
+		return(0);
+
+	return(klobucharCorrection(data, ctx.klob, ctx.lat, ctx.lon));
+}
+
+// troposphereStep: Saastamoinen zenith delays of the standard atmosphere
+//   mapped to each SV with the Niell mapping functions
+int troposphereStep(EpochSVData &data, const CorrectionContext &ctx)
+{
+	if(!ctx.havePosition)
+		return(0);
+
+	// model is undefined far outside the troposphere
+	if(ctx.height < -100.0 || ctx.height > 1.0e4)
+		return(-1);
+
+	// zenith delays and mapping coefficients are the same for every SV
+	double hgt  = ctx.height < 0.0 ? 0.0 : ctx.height;
+	double pres = 1013.25 * pow(1.0 - 2.2557e-5 * hgt, 5.2568);
+	double temp = 15.0 - 6.5e-3 * hgt + 273.16;
+	double e    = 6.108 * STD_HUMIDITY * exp((17.15 * temp - 4684.0) / (temp - 38.45));
+	double zhd  = 0.0022768 * pres / (1.0 - 0.00266 * cos(2.0 * ctx.lat) - 0.00028 * hgt / 1.0e3);
+	double zwd  = 0.002277 * (1255.0 / temp + 0.05) * e;
+
+	double latDeg = ctx.lat * 180.0 / GPS_PI;
+	double y = (ctx.dayOfYear - 28.0) / 365.25 + (latDeg < 0.0 ? 0.5 : 0.0);
+	double cosY = cos(2.0 * GPS_PI * y);
+	double ah[3], aw[3];
+
+	latDeg = fabs(latDeg);
+	for(int k = 0; k < 3; k++)
+	{
+		ah[k] = niellInterp(niellHydroAvg[k], latDeg) - niellInterp(niellHydroAmp[k], latDeg) * cosY;
+		aw[k] = niellInterp(niellWet[k], latDeg);
+	}
+
+	for(unsigned int i = 0; i < data.numSV; i++)
+	{
+		double el = data.elev[i];
+		double sinEl = sin(el > 0.0 ? el : 1.0);
+
+		// hydrostatic mapping with the Niell height correction
+		double mh = niellMap(sinEl, ah[0], ah[1], ah[2]) +
+			(1.0 / sinEl - niellMap(sinEl, niellHeight[0], niellHeight[1], niellHeight[2])) * hgt / 1.0e3;
+		double mw = niellMap(sinEl, aw[0], aw[1], aw[2]);
+		double delay = zhd * mh + zwd * mw;
+
+		// SVs below the horizon or without a state get no correction
+		delay = (data.valid[i] && el > 0.0) ? delay : 0.0;
+		data.tropo[i] = delay;
+		data.pr[i] -= delay;
+	}
+
+	return(0);
+}
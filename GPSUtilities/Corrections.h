@@ -0,0 +1,88 @@
+//**********************************************************************
+// File:			Corrections.h
+// Programmer:		Guoyu Fu
+// Description:		Batch pseudorange error corrections
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Correction kernels operate on every row of an EpochSVData at once and
+// remove the modelled error from the pseudorange column in place.
+// CorrectionStage chains the kernels between measurement decoding and
+// the position solver; each step is a plain function so callers can
+// add, drop or reorder corrections without touching the solver.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef CORRECTIONS_H
+#define CORRECTIONS_H
+
+// defined constants
+#define WGS84_A         6378137.0          // WGS-84 semi-major axis (meters)
+#define WGS84_E2        6.69437999014e-3   // WGS-84 first eccentricity squared
+#define KLOB_FLAG_VALID 0x04               // AID-HUI flags: Klobuchar parameters valid
+#define MAX_CORRECTION_STEPS 8             // steps held by a CorrectionStage
+#define STD_HUMIDITY    0.7                // relative humidity of the standard atmosphere
+#define ELEVATION_MASK  10.0               // default elevation mask (degrees)
+#define NO_ELEVATION_MASK -2.0             // elevation mask value that keeps every SV (radians)
+
+// included libraries
+#include "EpochData.h"
+
+// custom data types
+struct KlobucharParams {
+	double alpha[4];  // amplitude coefficients (s, s/semicircle, s/semicircle^2, s/semicircle^3)
+	double beta[4];   // period coefficients (s, s/semicircle, s/semicircle^2, s/semicircle^3)
+	bool   valid;     // parameters have been received
+
+	KlobucharParams() : valid(false) {}
+};
+
+struct CorrectionContext {
+	double receiver[3];    // approximate receiver ECEF position (meters)
+	double lat, lon;       // receiver geodetic position (radians)
+	double height;         // receiver height above ellipsoid (meters)
+	double dayOfYear;      // day of year of epoch (1.0 = Jan 1 00:00)
+	double clockBias;      // receiver clock bias estimate (meters), 0 if unknown
+	bool   havePosition;   // receiver position (and elev/azim columns) usable
+	KlobucharParams klob;  // broadcast ionospheric model
+};
+
+typedef int (*CorrectionStep)(EpochSVData &data, const CorrectionContext &ctx);
+
+// definition of CorrectionStage class
+class CorrectionStage
+{
+	public:
+		// constructors
+		CorrectionStage();
+
+		// methods
+		int  add(CorrectionStep step);
+		void clear(void);
+		int  apply(EpochSVData &data, const double receiver[3], double clockBias = 0.0);
+
+		KlobucharParams klob;  // broadcast ionospheric model handed to the steps
+		double elevationMask;  // rows below this elevation are dropped (radians)
+
+	private:
+		CorrectionStep steps[MAX_CORRECTION_STEPS];
+		unsigned int   numSteps;
+};
+
+// function prototypes
+void ecefToGeodetic(const double ecef[3], double &lat, double &lon, double &height);
+void computeElevAzim(EpochSVData &data, const double receiver[3]);
+void computeElevAzim(EpochSVData &data, const double receiver[3], double lat, double lon);
+int  maskElevation(EpochSVData &data, const double receiver[3], double lat, double lon, double mask);
+int  klobucharCorrection(EpochSVData &data, const KlobucharParams &klob, double lat, double lon);
+
+// correction steps
+int relativisticStep(EpochSVData &data, const CorrectionContext &ctx);
+int sagnacStep(EpochSVData &data, const CorrectionContext &ctx);
+int klobucharStep(EpochSVData &data, const CorrectionContext &ctx);
+int troposphereStep(EpochSVData &data, const CorrectionContext &ctx);
+
+#endif // CORRECTIONS_H
@@ -0,0 +1,162 @@
+//**********************************************************************
+// File:			DirectSolution.cpp
+// Programmer:		Guoyu Fu
+// Description:		Closed form (Bancroft) position solution and seeding
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Reference: S. Bancroft, "An Algebraic Solution of the GPS Equations",
+// IEEE Trans. AES-21, 1985.  Lengths are scaled to BANCROFT_SCALE so the
+// normal matrix stays well conditioned.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+
+#include "DirectSolution.h"
+#include "LeastSquares.h"
+#include "Corrections.h"
+
+using namespace std;
+
+
+// lorentz: Lorentz inner product <a,b> = a0 b0 + a1 b1 + a2 b2 - a3 b3
+static inline double lorentz(const double a[4], const double b[4])
+{
+	return(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] - a[3] * b[3]);
+}
+
+// bancroftSolution: closed form receiver position and clock bias
+//   x, y, z: SV positions; pr: corrected pseudoranges (meters)
+//   solution: receiver x, y, z and clock bias (meters) out
+//   returns 0 on success, -1 too few/many rows, -3 singular geometry
+int bancroftSolution(const double x[], const double y[], const double z[], const double pr[],
+                     unsigned int rows, double solution[4])
+{
+	if(rows < 4 || rows > LSQ_MAX_ROWS)
+		return(-1);
+
+	NormalEquations<4> ne;
+	double row[4];
+	double sumOnes[4] = { 0.0, 0.0, 0.0, 0.0 };  // B'1
+	double u[4], v[4];
+
+	// B = [x y z pr], a = <B_i,B_i>/2; least squares u = B+ 1, v = B+ a
+	ne.reset();
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		row[0] = x[i] / BANCROFT_SCALE;
+		row[1] = y[i] / BANCROFT_SCALE;
+		row[2] = z[i] / BANCROFT_SCALE;
+		row[3] = pr[i] / BANCROFT_SCALE;
+		ne.addRow(row, 0.5 * lorentz(row, row));
+		for(int k = 0; k < 4; k++)
+			sumOnes[k] += row[k];
+	}
+	if(ne.factor() != 0)
+		return(-3);
+	ne.solve(sumOnes, u);
+	ne.solve(v);
+
+	// receiver state w = v + L u, where L = <w,w>/2 solves
+	// <u,u>/2 L^2 + (<u,v> - 1) L + <v,v>/2 = 0
+	double qa = 0.5 * lorentz(u, u);
+	double qb = lorentz(u, v) - 1.0;
+	double qc = 0.5 * lorentz(v, v);
+	double disc = qb * qb - 4.0 * qa * qc;
+	disc = disc > 0.0 ? sqrt(disc) : 0.0;
+
+	double roots[2];
+	int numRoots;
+	if(qa != 0.0)
+	{
+		roots[0] = (-qb + disc) / (2.0 * qa);
+		roots[1] = (-qb - disc) / (2.0 * qa);
+		numRoots = 2;
+	}
+	else if(qb != 0.0)
+	{
+		roots[0] = -qc / qb;
+		numRoots = 1;
+	}
+	else
+	{
+		return(-3);
+	}
+
+	// of the two candidates keep the one on the earth's surface
+	double best = 1e300;
+	for(int r = 0; r < numRoots; r++)
+	{
+		double w[4];
+		for(int k = 0; k < 4; k++)
+			w[k] = v[k] + roots[r] * u[k];
+
+		double radius = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]) * BANCROFT_SCALE;
+		double offset = fabs(radius - WGS84_A);
+		if(offset < best)
+		{
+			best = offset;
+			solution[0] = w[0] * BANCROFT_SCALE;
+			solution[1] = w[1] * BANCROFT_SCALE;
+			solution[2] = w[2] * BANCROFT_SCALE;
+			solution[3] = -w[3] * BANCROFT_SCALE;
+		}
+	}
+
+	return(0);
+}
+
+// needsSeed: tells whether solution is too far off to start the iterative
+//   solver from: cold start, a receiver clock jump or a stale position
+bool needsSeed(const double x[], const double y[], const double z[], const double pr[],
+               unsigned int rows, const double solution[4])
+{
+	if(solution[0] * solution[0] + solution[1] * solution[1] + solution[2] * solution[2] <
+	   SEED_MIN_RADIUS * SEED_MIN_RADIUS)
+		return(true);
+	if(rows == 0)
+		return(false);
+
+	// pre-fit residuals: a common offset is the clock, a spread is the position
+	double sum = 0.0, minRes = 1e300, maxRes = -1e300;
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		double dx = x[i] - solution[0];
+		double dy = y[i] - solution[1];
+		double dz = z[i] - solution[2];
+		double res = pr[i] - sqrt(dx * dx + dy * dy + dz * dz);
+		sum += res;
+		minRes = res < minRes ? res : minRes;
+		maxRes = res > maxRes ? res : maxRes;
+	}
+
+	return(fabs(sum / rows) > SEED_CLOCK_JUMP || maxRes - minRes > SEED_RESIDUAL_SPREAD);
+}
+
+// seedSolution: replaces the position of solution with the closed form
+//   solution when needsSeed() says it is not a usable starting point
+//   returns 1 if solution was reseeded, 0 if it was kept, <0 if the
+//   closed form solution failed (solution unchanged)
+int seedSolution(const double x[], const double y[], const double z[], const double pr[],
+                 unsigned int rows, double solution[4])
+{
+	if(!needsSeed(x, y, z, pr, rows, solution))
+		return(0);
+
+	double seed[4];
+	int errorcode = bancroftSolution(x, y, z, pr, rows, seed);
+	if(errorcode != 0)
+		return(errorcode);
+
+	solution[0] = seed[0];
+	solution[1] = seed[1];
+	solution[2] = seed[2];
+
+	return(1);
+}
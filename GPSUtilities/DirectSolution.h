@@ -0,0 +1,37 @@
+//**********************************************************************
+// File:			DirectSolution.h
+// Programmer:		Guoyu Fu
+// Description:		Closed form (Bancroft) position solution and seeding
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Bancroft's method solves the pseudorange equations directly, without
+// an initial guess.  It is used to seed the iterative solver whenever
+// the previous solution is no good as a starting point: cold start, a
+// receiver clock jump, a gap in the data, or the start of a batch
+// segment.  With a good seed the iterative solver converges in one or
+// two iterations.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef DIRECT_SOLUTION_H
+#define DIRECT_SOLUTION_H
+
+// defined constants
+#define BANCROFT_SCALE        1.0e7    // length unit of the internal computation (meters)
+#define SEED_MIN_RADIUS       6.0e6    // solutions closer to earth centre are cold starts (meters)
+#define SEED_CLOCK_JUMP       3.0e4    // mean pre-fit residual taken as a clock jump (meters)
+#define SEED_RESIDUAL_SPREAD  1.0e3    // pre-fit residual spread taken as a stale position (meters)
+
+// function prototypes
+int bancroftSolution(const double x[], const double y[], const double z[], const double pr[],
+                     unsigned int rows, double solution[4]);
+bool needsSeed(const double x[], const double y[], const double z[], const double pr[],
+               unsigned int rows, const double solution[4]);
+int seedSolution(const double x[], const double y[], const double z[], const double pr[],
+                 unsigned int rows, double solution[4]);
+
+#endif // DIRECT_SOLUTION_H
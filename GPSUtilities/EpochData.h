@@ -0,0 +1,47 @@
+//**********************************************************************
+// File:			EpochData.h
+// Programmer:		Guoyu Fu
+// Description:		Per-epoch satellite data in structure-of-arrays form
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// One EpochSVData holds everything known about the SVs of a single
+// measurement epoch.  Each quantity is stored as its own column so the
+// batch kernels (SV state, corrections, solver) can sweep a column for
+// all SVs at once.  Row i of every column refers to the same SV.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef EPOCH_DATA_H
+#define EPOCH_DATA_H
+
+// defined constants
+#define MAX_EPOCH_SV  64   // maximum number of SVs in one epoch
+
+// custom data types
+struct EpochSVData {
+	int    week;          // GPS week of epoch
+	double tow;           // GPS time of week of epoch (seconds)
+	unsigned int numSV;   // number of valid rows
+
+	int    sv[MAX_EPOCH_SV];            // space vehicle number (PRN)
+	double pr[MAX_EPOCH_SV];            // pseudorange measurement (meters)
+	double x[MAX_EPOCH_SV];             // SV ECEF X position (meters)
+	double y[MAX_EPOCH_SV];             // SV ECEF Y position (meters)
+	double z[MAX_EPOCH_SV];             // SV ECEF Z position (meters)
+	double clockBias[MAX_EPOCH_SV];     // SV clock bias (seconds)
+	double clockDrift[MAX_EPOCH_SV];    // SV clock drift (seconds/second)
+	double relativistic[MAX_EPOCH_SV];  // SV relativistic clock term (seconds)
+	double elev[MAX_EPOCH_SV];          // SV elevation seen from receiver (radians)
+	double azim[MAX_EPOCH_SV];          // SV azimuth seen from receiver (radians)
+	double iono[MAX_EPOCH_SV];          // ionospheric delay removed from pr (meters)
+	double tropo[MAX_EPOCH_SV];         // tropospheric delay removed from pr (meters)
+	int    valid[MAX_EPOCH_SV];         // 1 => SV state available for row
+
+	EpochSVData() : week(0), tow(0.0), numSV(0) {}
+};
+
+#endif // EPOCH_DATA_H
@@ -0,0 +1,139 @@
+//**********************************************************************
+// File:			EpochStateCache.cpp
+// Programmer:		Guoyu Fu
+// Description:		SV states shared by several receivers, keyed by epoch
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+
+#include "EpochStateCache.h"
+
+using namespace std;
+
+
+// EpochStateCache: default constructor
+EpochStateCache::EpochStateCache()
+{
+	orbits = 0;
+	engine = 0;
+	hits   = 0;
+	misses = 0;
+
+	request.numSV = MAX_GPS_PRN;
+	for(int i = 0; i < MAX_GPS_PRN; i++)
+		request.sv[i] = i + 1;
+}
+
+// setSource: SV states come from the precise orbit store
+void EpochStateCache::setSource(OrbitInterpolator *orbitSource)
+{
+	orbits = orbitSource;
+	engine = 0;
+	clear();
+}
+
+// setSource: SV states come from the broadcast ephemeris engine
+void EpochStateCache::setSource(SVStateEngine *engineSource)
+{
+	engine = engineSource;
+	orbits = 0;
+	clear();
+}
+
+// prepare: evaluates all PRNs at the epoch unless already done
+//   returns the slot for apply(), -1 if no source is set
+int EpochStateCache::prepare(int week, double tow)
+{
+	if(orbits == 0 && engine == 0)
+		return(-1);
+
+	long long key = static_cast<long long>(floor((week * SECONDS_PER_WEEK + tow) * 1000.0 + 0.5));
+	map<long long, int>::const_iterator found = slots.find(key);
+	if(found != slots.end())
+	{
+		hits++;
+		return(found->second);
+	}
+	misses++;
+
+	request.week  = week;
+	request.tow   = tow;
+	request.numSV = MAX_GPS_PRN;
+	if(orbits != 0)
+		orbits->evaluate(request);
+	else
+		engine->evaluate(request);
+
+	StateSet set;
+	set.valid[0] = 0;
+	for(int i = 0; i < MAX_GPS_PRN; i++)
+	{
+		SVState &s = set.state[i + 1];
+		s.x = request.x[i];
+		s.y = request.y[i];
+		s.z = request.z[i];
+		s.clockBias    = request.clockBias[i];
+		s.clockDrift   = request.clockDrift[i];
+		s.relativistic = request.relativistic[i];
+		set.valid[i + 1] = request.valid[i];
+	}
+
+	sets.push_back(set);
+	slots[key] = sets.size() - 1;
+
+	return(sets.size() - 1);
+}
+
+// apply: copies the states of a prepared slot into the rows of epoch
+//   returns number of rows without a state (valid cleared)
+int EpochStateCache::apply(int slot, EpochSVData &epoch) const
+{
+	int unavailable = 0;
+
+	if(slot < 0 || slot >= static_cast<int>(sets.size()))
+	{
+		for(unsigned int i = 0; i < epoch.numSV; i++)
+			epoch.valid[i] = 0;
+		return(epoch.numSV);
+	}
+
+	const StateSet &set = sets[slot];
+	for(unsigned int i = 0; i < epoch.numSV; i++)
+	{
+		int sv = epoch.sv[i];
+		if(sv < 1 || sv > MAX_GPS_PRN || !set.valid[sv])
+		{
+			epoch.valid[i] = 0;
+			unavailable++;
+			continue;
+		}
+
+		const SVState &s = set.state[sv];
+		epoch.x[i] = s.x;
+		epoch.y[i] = s.y;
+		epoch.z[i] = s.z;
+		epoch.clockBias[i]    = s.clockBias;
+		epoch.clockDrift[i]   = s.clockDrift;
+		epoch.relativistic[i] = s.relativistic;
+		epoch.valid[i] = 1;
+	}
+
+	return(unavailable);
+}
+
+// clear: drops all slots (none may be in use)
+void EpochStateCache::clear(void)
+{
+	sets.clear();
+	slots.clear();
+}
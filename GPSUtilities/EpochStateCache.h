@@ -0,0 +1,65 @@
+//**********************************************************************
+// File:			EpochStateCache.h
+// Programmer:		Guoyu Fu
+// Description:		SV states shared by several receivers, keyed by epoch
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Receivers logging at the same time measure at the same epochs, so the
+// SV positions and clocks they need are the same.  prepare() evaluates
+// every PRN once per distinct epoch time (to the millisecond) from the
+// precise orbit store or the broadcast engine and returns a slot;
+// apply() then copies the states into any receiver's EpochSVData.
+// prepare() runs on one thread; once a set of slots is prepared,
+// apply() may be called on them from any number of threads until
+// clear().
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef EPOCH_STATE_CACHE_H
+#define EPOCH_STATE_CACHE_H
+
+// included libraries
+#include <map>
+#include <vector>
+
+#include "EpochData.h"
+#include "SVState.h"
+#include "OrbitStore.h"
+
+// definition of EpochStateCache class
+class EpochStateCache
+{
+	public:
+		// constructors
+		EpochStateCache();
+
+		// methods
+		void setSource(OrbitInterpolator *orbits);
+		void setSource(SVStateEngine *engine);
+		int  prepare(int week, double tow);
+		int  apply(int slot, EpochSVData &epoch) const;
+		void clear(void);
+		unsigned int numSlots(void) const { return(sets.size()); }
+
+		// statistics
+		unsigned long hits;
+		unsigned long misses;
+
+	private:
+		struct StateSet {
+			SVState state[MAX_GPS_PRN + 1];   // index is the PRN
+			int     valid[MAX_GPS_PRN + 1];
+		};
+
+		OrbitInterpolator * orbits;    // precise source, or
+		SVStateEngine *     engine;    // broadcast source
+		std::vector<StateSet> sets;
+		std::map<long long, int> slots;   // epoch time (ms) => index in sets
+		EpochSVData request;              // all PRNs, passed to the source
+};
+
+#endif // EPOCH_STATE_CACHE_H
@@ -22,6 +22,7 @@
 #include <cmath>
 
 #include "GPSUtilities.h"
+#include "DirectSolution.h"
 
 using namespace std;
 using namespace gpstk;
@@ -87,6 +88,78 @@ void loadRapidEphemeris(SP3EphemerisStore &ephem, unsigned int gpsWeek, unsigned
 }
 
 
+// openOrbitStore: maps storeFile, converting sp3Files into it first if it
+//   is missing or not a valid store
+//   returns 0 on success, <0 if the store can neither be opened nor built
+static int openOrbitStore(OrbitStore &store, const vector<string> &sp3Files, const string &storeFile)
+{
+	if(store.open(storeFile) == 0)
+		return(0);
+
+	cout << "converting to " << storeFile << "...";
+	int errorcode = convertSP3(sp3Files, storeFile);
+	if(errorcode != 0)
+		return(errorcode);
+
+	return(store.open(storeFile));
+}
+
+int loadOrbitStore(OrbitStore &store, unsigned int gpsWeek)
+{
+	vector<string> sp3Files;
+	ostringstream week;
+
+	string path(FINAL_EPHEMERIS_PATH);
+	string baseFileName(FINAL_EPHEMERIS_NAME);
+	string separator(PATH_SEPARATOR);
+	string fileExt(FINAL_EPHEMERIS_FILE_EXTENSION);
+
+	cout << "Loading ephemeris data for GPS week " << gpsWeek << "...";
+
+	week << setw(4) << setfill('0') << gpsWeek;
+
+	// final (precise) ephemeris for GPS week, one binary store per week
+	for(char day = '0'; day <= '6'; day++)
+		sp3Files.push_back(path + week.str() + separator + baseFileName + week.str() + day + fileExt);
+	string storeFile = path + week.str() + separator + baseFileName + week.str() + ORBIT_STORE_EXTENSION;
+
+	int errorcode = openOrbitStore(store, sp3Files, storeFile);
+	if(errorcode != 0)
+		cout << "Failed! (" << errorcode << ")" << endl;
+	else
+		cout << "Done!" << endl;
+	return(errorcode);
+}
+
+int loadRapidOrbitStore(OrbitStore &store, unsigned int gpsWeek, unsigned int dayOfWeek)
+{
+	vector<string> sp3Files;
+	ostringstream week;
+	ostringstream day;
+
+	string path(RAPID_EPHEMERIS_PATH);
+	string baseFileName(RAPID_EPHEMERIS_NAME);
+	string separator(PATH_SEPARATOR);
+	string fileExt(RAPID_EPHEMERIS_FILE_EXTENSION);
+
+	cout << "Loading rapid ephemeris data for GPS week " << gpsWeek;
+	cout << ", Day " << dayOfWeek << "...";
+
+	week << setw(4) << setfill('0') << gpsWeek;
+	day  << setw(1) << dayOfWeek;
+
+	// rapid ephemeris for the day, binary store next to the SP3 file
+	string baseName = path + week.str() + separator + baseFileName + week.str() + day.str();
+	sp3Files.push_back(baseName + fileExt);
+
+	int errorcode = openOrbitStore(store, sp3Files, baseName + ORBIT_STORE_EXTENSION);
+	if(errorcode != 0)
+		cout << "Failed! (" << errorcode << ")" << endl;
+	else
+		cout << "Done!" << endl;
+	return(errorcode);
+}
+
 void loadAlmanac(SEMAlmanacStore &almanac, DayTime &startTime, unsigned int days)
 {
 	unsigned int daysToLoad;
@@ -132,174 +205,108 @@ int calculateDOP(Matrix<double> &matrixDOP, Matrix<double> &dataSV, Vector<doubl
 	// validate/prepare input
 	if(solution.size() != 4)
 		return(-1);
-	if(dataSV.rows() < 4)
+	if(dataSV.rows() < 4 || dataSV.rows() > LSQ_MAX_ROWS)
 		return(-2);
 	if(dataSV.cols() != 4)
 		return(-3);
 	matrixDOP.resize(0,4);
 
-	Matrix<double> position(0,4);
-	Vector<double> tempRow(4);
-	double distSV;
+	double x[LSQ_MAX_ROWS], y[LSQ_MAX_ROWS], z[LSQ_MAX_ROWS];
+	double position[4];
+	double dop[4][4];
 
-	// build position matrix
 	for(unsigned int i = 0; i < dataSV.rows(); i++)
 	{
-		// calculate distance from user to i_th SV
-		distSV  = (solution(0) - dataSV(i,0)) * (solution(0) - dataSV(i,0));
-		distSV += (solution(1) - dataSV(i,1)) * (solution(1) - dataSV(i,1));
-		distSV += (solution(2) - dataSV(i,2)) * (solution(2) - dataSV(i,2));
-		distSV = sqrt(distSV);
-
-		// compute a row of the position matrix
-		tempRow(0) = (solution(0) - dataSV(i,0)) / distSV;
-		tempRow(1) = (solution(1) - dataSV(i,1)) / distSV;
-		tempRow(2) = (solution(2) - dataSV(i,2)) / distSV;
-		tempRow(3) = 1.0;
-
-		//add row to postion matrix
-		position = position && tempRow;
+		x[i] = dataSV(i,0);
+		y[i] = dataSV(i,1);
+		z[i] = dataSV(i,2);
 	}
+	for(unsigned int j = 0; j < 4; j++)
+		position[j] = solution(j);
 
 	// compute generalized inverse of position matrix
-	try
-	{
-		matrixDOP = inverseChol(transpose(position)*position);
-	}
-	catch(...)
-	{
+	if(dopFixed<4>(x, y, z, NULL, dataSV.rows(), position, dop) != 0)
 		return(-4);
-	}
+
+	matrixDOP.resize(4,4);
+	for(unsigned int i = 0; i < 4; i++)
+		for(unsigned int j = 0; j < 4; j++)
+			matrixDOP(i,j) = dop[i][j];
 
 	return(0);
 }
 
-int solutionNLLS(Matrix<double> &dataSV, Vector<double> &solution)
+// calculateDOP: DOP matrix from the geometry left by solutionNLLS, no
+//   line of sight or normal matrix is rebuilt
+int calculateDOP(Matrix<double> &matrixDOP, const SolutionGeometry<4> &geometry)
+{
+	if(!geometry.valid)
+		return(-4);
+
+	double dop[4][4];
+	geometry.covariance(dop);
+
+	matrixDOP.resize(4,4);
+	for(unsigned int i = 0; i < 4; i++)
+		for(unsigned int j = 0; j < 4; j++)
+			matrixDOP(i,j) = dop[i][j];
+
+	return(0);
+}
+
+// solutionNLLS: gpstk matrix front end of nllsFixed<4>, kept for legacy
+//   callers; the solvers fill nllsFixed's columns from EpochSVData directly
+int solutionNLLS(Matrix<double> &dataSV, Vector<double> &solution, SolutionGeometry<4> *geometry)
 {
 	// validate input
-	if(dataSV.rows() < 4)
+	if(dataSV.rows() < 4 || dataSV.rows() > LSQ_MAX_ROWS)
 		return(-1);
 	if(solution.size() != 4)
 		return(-2);
 
-	// initialize
-	Matrix<double> jacobian(dataSV.rows(),4);
-	Matrix<double> invJacobian;
-	Vector<double> rangesSV(dataSV.rows());
-	Vector<double> pseudoRanges(dataSV.rows());
-	Vector<double> shiftVector(4,0.0);
-	Vector<double> positionSV(3);
-	double positionShiftMag = 1e22;
+	// copy into the fixed size solver's columns
+	double x[LSQ_MAX_ROWS], y[LSQ_MAX_ROWS], z[LSQ_MAX_ROWS];
+	double pseudoRanges[LSQ_MAX_ROWS];
+	double position[4];
 
-	// extract pseudorange vector
 	for(unsigned int i = 0; i < dataSV.rows(); i++)
-		pseudoRanges(i) = dataSV(i,3);
-
-
-	// iterate
-	int itr = 0;
-	while(itr < MAX_ITERATIONS && positionShiftMag > SOLUTION_TOLERANCE)
 	{
-		// build current Jacobian
-		for(unsigned int i = 0; i < dataSV.rows(); i++)
-		{
-			rangesSV(i) = 0.0;
-			for(unsigned int j = 0; j < 3; j++)
-			{
-				positionSV(j) = dataSV(i,j) - solution(j);
-				rangesSV(i) += positionSV(j) * positionSV(j);
-			}
-			rangesSV(i) = sqrt(rangesSV(i));
-
-			for(unsigned int j = 0; j < 3; j++)
-			{
-				jacobian(i,j) = -1 * positionSV(j) / rangesSV(i);
-			}
-			jacobian(i,3) = 1.0; //SPEED_OF_LIGHT;
-		}
-
-		if(DEBUG)
-		{	// dump jacobian
-			cout << "\nJacobian:" << endl;
-			for(unsigned int i = 0; i < jacobian.rows(); i++)
-			{
-				for(unsigned int j = 0; j < jacobian.cols(); j++)
-					cout << setprecision(15) << jacobian(i,j) << " ";
-				cout << endl;
-			}
-			cout << endl;
-		}
+		x[i] = dataSV(i,0);
+		y[i] = dataSV(i,1);
+		z[i] = dataSV(i,2);
+		pseudoRanges[i] = dataSV(i,3);
+	}
+	for(unsigned int j = 0; j < 4; j++)
+		position[j] = solution(j);
 
-		// compute generalized inverse of Jacobian
-		try
-		{
-			invJacobian = inverseChol(transpose(jacobian)*jacobian);
-		}
-		catch(...)
-		{
-			if(DEBUG)
-			{	// dump jacobian
-				cout << "\nError inverting Jacobian:" << endl;
-				for(unsigned int i = 0; i < jacobian.rows(); i++)
-				{
-					for(unsigned int j = 0; j < jacobian.cols(); j++)
-						cout << setprecision(15) << jacobian(i,j) << " ";
-					cout << endl;
-				}
-				cout << endl;
-
-				// dump input data
-				cout << "\nSpace vehicle data input:" << endl;
-				for(unsigned int i = 0; i < dataSV.rows(); i++)
-				{
-					for(unsigned int j = 0; j < dataSV.cols(); j++)
-						cout << setprecision(15) << dataSV(i,j) << " ";
-					cout << endl;
-				}
-				cout << endl;
-
-				// dump initial solution
-				cout << "\nInitial solution input:" << endl;
-				for(unsigned int i = 0; i < solution.size(); i++)
-					cout << setprecision(15) << solution(i) << " ";
-				cout << endl;
-			}
-			return(-3);
-		}
+	// closed form seed when the initial guess is unusable (cold start, clock jump, gap)
+	seedSolution(x, y, z, pseudoRanges, dataSV.rows(), position);
 
-		shiftVector = (invJacobian * transpose(jacobian)) * (pseudoRanges - rangesSV);
+	int errorcode = nllsFixed<4>(x, y, z, pseudoRanges, NULL, dataSV.rows(), position, geometry);
 
-		if(DEBUG)
+	if(DEBUG && errorcode == -3)
+	{
+		// dump input data
+		cout << "\nSpace vehicle data input:" << endl;
+		for(unsigned int i = 0; i < dataSV.rows(); i++)
 		{
-			for(unsigned int k = 0; k < shiftVector.size(); k++)
-				cout << shiftVector(k) << " ";
+			for(unsigned int j = 0; j < dataSV.cols(); j++)
+				cout << setprecision(15) << dataSV(i,j) << " ";
 			cout << endl;
 		}
+		cout << endl;
 
-		// update solution using shift vector
-		solution += shiftVector;
-
-		// update termination conditions
-		positionShiftMag = sqrt(shiftVector(0) * shiftVector(0) +
-								shiftVector(1) * shiftVector(1) +
-								shiftVector(2) * shiftVector(2));
-		itr++;
-	}
-
-	if(itr >= MAX_ITERATIONS)
-		return(-4);
-
-	// save final clock bias term in solution
-	// Note: the time residual in the shift vector is the clock bias of the solution
-	solution(3) = shiftVector(3);
-
-	if(DEBUG)
-	{
-		for(unsigned int k = 0; k < shiftVector.size(); k++)
-			cout << shiftVector(k)/SPEED_OF_LIGHT << " ";
+		// dump initial solution
+		cout << "\nInitial solution input:" << endl;
+		for(unsigned int i = 0; i < solution.size(); i++)
+			cout << setprecision(15) << solution(i) << " ";
 		cout << endl;
 	}
 
-	return(0);
-}
+	// save solution (last iterate if the solver stopped early)
+	// Note: the time residual in the final shift vector is the clock bias of the solution
+	for(unsigned int j = 0; j < 4; j++)
+		solution(j) = position[j];
 
+	return(errorcode);
+}
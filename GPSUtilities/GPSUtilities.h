@@ -16,8 +16,6 @@
 
 // defined constants
 #define SPEED_OF_LIGHT      299792458   // in m/s
-#define MAX_ITERATIONS      20          // maximum number of iteration
-#define SOLUTION_TOLERANCE  0.10        // GPS solution tolerance
 #define DEBUG               false       // turn off debug features
 
 // system specific file location
@@ -37,6 +35,8 @@
 #include "DayTime.hpp"
 #include "Matrix.hpp"
 #include "Vector.hpp"
+#include "LeastSquares.h"
+#include "OrbitStore.h"
 
 using namespace gpstk;
 
@@ -44,8 +44,11 @@ using namespace gpstk;
 // method prototypes
 void loadEphemeris(SP3EphemerisStore &ephem, unsigned int gpsWeek);
 void loadRapidEphemeris(SP3EphemerisStore &ephem, unsigned int gpsWeek, unsigned int dayOfWeek);
+int loadOrbitStore(OrbitStore &store, unsigned int gpsWeek);
+int loadRapidOrbitStore(OrbitStore &store, unsigned int gpsWeek, unsigned int dayOfWeek);
 void loadAlmanac(SEMAlmanacStore &almanac, DayTime &startTime, unsigned int days);
 
 int calculateDOP(Matrix<double> &matrixDOP, Matrix<double> &dataSV, Vector<double> solution);
-int solutionNLLS(Matrix<double> &dataSV, Vector<double> &solution);
+int calculateDOP(Matrix<double> &matrixDOP, const SolutionGeometry<4> &geometry);
+int solutionNLLS(Matrix<double> &dataSV, Vector<double> &solution, SolutionGeometry<4> *geometry = NULL);
 
@@ -0,0 +1,349 @@
+//**********************************************************************
+// File:			LeastSquares.h
+// Programmer:		Guoyu Fu
+// Description:		Fixed-size least squares core for GPS positioning
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// The number of unknowns N is a template parameter: 4 for position and
+// one receiver clock, 5 to 7 when each GNSS (clock group) gets its own
+// clock term.  All storage lives on the stack and every loop bound is a
+// compile time constant, so the normal equations are accumulated in
+// place and the Cholesky factorization unrolls completely.  No heap
+// allocation happens per row, per iteration or per fix.
+//
+// The solver can hand back the geometry of its final iteration (line of
+// sight unit vectors, factored H'H, post-fit residuals) so DOP, velocity
+// and integrity checks reuse it instead of rebuilding it.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef LEAST_SQUARES_H
+#define LEAST_SQUARES_H
+
+// defined constants
+#define MAX_ITERATIONS      20          // maximum number of iteration
+#define SOLUTION_TOLERANCE  0.10        // GPS solution tolerance
+#define LSQ_MIN_UNKNOWNS    4           // x, y, z, one clock
+#define LSQ_MAX_UNKNOWNS    7           // x, y, z, four clocks
+#define LSQ_MAX_ROWS        MAX_EPOCH_SV
+
+// included libraries
+#include <cmath>
+#include <cstddef>
+
+#include "EpochData.h"
+
+// definition of NormalEquations class
+//   accumulates H'H and H'r one row at a time, only the lower triangle
+//   of H'H is kept
+template<int N>
+class NormalEquations
+{
+	// N outside LSQ_MIN_UNKNOWNS .. LSQ_MAX_UNKNOWNS fails to compile
+	typedef char unknownsInRange[(N >= LSQ_MIN_UNKNOWNS && N <= LSQ_MAX_UNKNOWNS) ? 1 : -1];
+
+	public:
+		// methods
+		void reset(void)
+		{
+			for(int i = 0; i < N; i++)
+			{
+				b[i] = 0.0;
+				for(int j = 0; j < N; j++)
+					a[i][j] = 0.0;
+			}
+		}
+
+		void addRow(const double h[N], double r)
+		{
+			for(int i = 0; i < N; i++)
+			{
+				b[i] += h[i] * r;
+				for(int j = 0; j <= i; j++)
+					a[i][j] += h[i] * h[j];
+			}
+		}
+
+		// factor: Cholesky factorization in place (a = L L'),
+		//   returns -1 if H'H is not positive definite
+		int factor(void)
+		{
+			for(int j = 0; j < N; j++)
+			{
+				double d = a[j][j];
+				for(int k = 0; k < j; k++)
+					d -= a[j][k] * a[j][k];
+				if(!(d > 0.0))
+					return(-1);
+				a[j][j] = sqrt(d);
+				invDiag[j] = 1.0 / a[j][j];
+
+				for(int i = j + 1; i < N; i++)
+				{
+					double s = a[i][j];
+					for(int k = 0; k < j; k++)
+						s -= a[i][k] * a[j][k];
+					a[i][j] = s * invDiag[j];
+				}
+			}
+			return(0);
+		}
+
+		// solve: x = (H'H)^-1 H'r, after factor()
+		void solve(double x[N]) const
+		{
+			solve(b, x);
+		}
+
+		// solve: x = (H'H)^-1 rhs, after factor()
+		void solve(const double rhs[N], double x[N]) const
+		{
+			double y[N];
+			for(int i = 0; i < N; i++)
+			{
+				double s = rhs[i];
+				for(int k = 0; k < i; k++)
+					s -= a[i][k] * y[k];
+				y[i] = s * invDiag[i];
+			}
+			for(int i = N - 1; i >= 0; i--)
+			{
+				double s = y[i];
+				for(int k = i + 1; k < N; k++)
+					s -= a[k][i] * x[k];
+				x[i] = s * invDiag[i];
+			}
+		}
+
+		// inverse: full (H'H)^-1, after factor()
+		void inverse(double inv[N][N]) const
+		{
+			double linv[N][N];  // L^-1, lower triangle
+			for(int j = 0; j < N; j++)
+			{
+				linv[j][j] = invDiag[j];
+				for(int i = j + 1; i < N; i++)
+				{
+					double s = 0.0;
+					for(int k = j; k < i; k++)
+						s -= a[i][k] * linv[k][j];
+					linv[i][j] = s * invDiag[i];
+				}
+			}
+			for(int i = 0; i < N; i++)
+			{
+				for(int j = 0; j <= i; j++)
+				{
+					double s = 0.0;
+					for(int k = i; k < N; k++)
+						s += linv[k][i] * linv[k][j];
+					inv[i][j] = s;
+					inv[j][i] = s;
+				}
+			}
+		}
+
+		double a[N][N];      // H'H, then its Cholesky factor
+		double b[N];         // H'r
+		double invDiag[N];   // reciprocals of the factor diagonal
+};
+
+// lsqRow: one row of the design matrix for SV i at solution
+//   returns the geometric range from solution to the SV
+template<int N>
+inline double lsqRow(double h[N], double x, double y, double z, int group, const double solution[N])
+{
+	double dx = x - solution[0];
+	double dy = y - solution[1];
+	double dz = z - solution[2];
+	double range = sqrt(dx * dx + dy * dy + dz * dz);
+	double inv = 1.0 / range;
+
+	h[0] = -dx * inv;
+	h[1] = -dy * inv;
+	h[2] = -dz * inv;
+	for(int k = 3; k < N; k++)
+		h[k] = (k - 3 == group) ? 1.0 : 0.0;
+
+	return(range);
+}
+
+// definition of SolutionGeometry class
+//   geometry of the last solver iteration
+template<int N>
+class SolutionGeometry
+{
+	public:
+		// constructors
+		SolutionGeometry() : rows(0), iterations(0), valid(false) {}
+
+		// methods
+		//   covariance: (H'H)^-1, the DOP matrix
+		void covariance(double cov[N][N]) const
+		{
+			normal.inverse(cov);
+		}
+
+		//   gdop, pdop: dilution of precision from the factored H'H
+		double gdop(void) const
+		{
+			double cov[N][N];
+			double trace = 0.0;
+			normal.inverse(cov);
+			for(int k = 0; k < N; k++)
+				trace += cov[k][k];
+			return(sqrt(trace));
+		}
+
+		double pdop(void) const
+		{
+			double cov[N][N];
+			normal.inverse(cov);
+			return(sqrt(cov[0][0] + cov[1][1] + cov[2][2]));
+		}
+
+		//   sumSquaredResiduals: post-fit residual test statistic
+		double sumSquaredResiduals(void) const
+		{
+			double sum = 0.0;
+			for(unsigned int i = 0; i < rows; i++)
+				sum += residual[i] * residual[i];
+			return(sum);
+		}
+
+		unsigned int rows;                 // rows used in the solution
+		int  iterations;                   // iterations taken
+		bool valid;                        // solver converged
+		double ux[LSQ_MAX_ROWS];           // unit vector receiver to SV
+		double uy[LSQ_MAX_ROWS];
+		double uz[LSQ_MAX_ROWS];
+		double range[LSQ_MAX_ROWS];        // geometric range at linearization point
+		double residual[LSQ_MAX_ROWS];     // post-fit pseudorange residual
+		unsigned char group[LSQ_MAX_ROWS]; // clock group of row
+		NormalEquations<N> normal;         // H'H at the final iteration, factored
+};
+
+// nllsFixed: iterative nonlinear least squares position solution
+//   x, y, z: SV positions; pr: corrected pseudoranges
+//   group: clock group (0 .. N-4) of each row, NULL => all rows group 0
+//   solution: initial guess in, solution out (x, y, z, clock terms)
+//   the clock terms are not part of the predicted range, each iteration
+//   re-estimates them completely and the final estimate is returned
+//   geometry: if not NULL, receives the geometry of the final iteration
+//   returns 0 on success, -1 too few/many rows, -2 bad clock group,
+//   -3 singular geometry, -4 no convergence
+template<int N>
+int nllsFixed(const double x[], const double y[], const double z[], const double pr[],
+              const unsigned char group[], unsigned int rows, double solution[N],
+              SolutionGeometry<N> *geometry = NULL)
+{
+	// validate input
+	if(rows < N || rows > LSQ_MAX_ROWS)
+		return(-1);
+	if(group != NULL)
+	{
+		for(unsigned int i = 0; i < rows; i++)
+			if(group[i] > N - LSQ_MIN_UNKNOWNS)
+				return(-2);
+	}
+
+	SolutionGeometry<N> local;
+	SolutionGeometry<N> &geom = geometry ? *geometry : local;
+	NormalEquations<N> &ne = geom.normal;
+	double h[N];
+	double shift[N];
+	double shiftMag = 1e22;
+
+	geom.rows  = rows;
+	geom.valid = false;
+
+	int itr = 0;
+	while(itr < MAX_ITERATIONS && shiftMag > SOLUTION_TOLERANCE)
+	{
+		ne.reset();
+		for(unsigned int i = 0; i < rows; i++)
+		{
+			int g = group ? group[i] : 0;
+			double range = lsqRow<N>(h, x[i], y[i], z[i], g, solution);
+			ne.addRow(h, pr[i] - range);
+
+			if(geometry)
+			{
+				geom.ux[i] = -h[0];
+				geom.uy[i] = -h[1];
+				geom.uz[i] = -h[2];
+				geom.range[i] = range;
+				geom.residual[i] = pr[i] - range;
+				geom.group[i] = (unsigned char)g;
+			}
+		}
+
+		if(ne.factor() != 0)
+			return(-3);
+		ne.solve(shift);
+
+		// update solution using shift vector
+		solution[0] += shift[0];
+		solution[1] += shift[1];
+		solution[2] += shift[2];
+
+		shiftMag = sqrt(shift[0] * shift[0] + shift[1] * shift[1] + shift[2] * shift[2]);
+		itr++;
+	}
+
+	geom.iterations = itr;
+	if(itr >= MAX_ITERATIONS)
+		return(-4);
+
+	for(int k = 3; k < N; k++)
+		solution[k] = shift[k];
+
+	// pre-fit residuals of the last iteration minus the fitted correction
+	if(geometry)
+	{
+		for(unsigned int i = 0; i < rows; i++)
+		{
+			geom.residual[i] += geom.ux[i] * shift[0] + geom.uy[i] * shift[1] +
+				geom.uz[i] * shift[2] - shift[3 + geom.group[i]];
+		}
+	}
+	geom.valid = true;
+
+	return(0);
+}
+
+// dopFixed: (H'H)^-1 of the geometry at solution
+//   returns 0 on success, -1 too few/many rows, -2 bad clock group,
+//   -3 singular geometry
+template<int N>
+int dopFixed(const double x[], const double y[], const double z[], const unsigned char group[],
+             unsigned int rows, const double solution[N], double dop[N][N])
+{
+	if(rows < N || rows > LSQ_MAX_ROWS)
+		return(-1);
+
+	NormalEquations<N> ne;
+	double h[N];
+
+	ne.reset();
+	for(unsigned int i = 0; i < rows; i++)
+	{
+		int c = group ? group[i] : 0;
+		if(c > N - LSQ_MIN_UNKNOWNS)
+			return(-2);
+		lsqRow<N>(h, x[i], y[i], z[i], c, solution);
+		ne.addRow(h, 0.0);
+	}
+
+	if(ne.factor() != 0)
+		return(-3);
+	ne.inverse(dop);
+
+	return(0);
+}
+
+#endif // LEAST_SQUARES_H
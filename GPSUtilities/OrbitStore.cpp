@@ -0,0 +1,549 @@
+//**********************************************************************
+// File:			OrbitStore.cpp
+// Programmer:		Guoyu Fu
+// Description:		Binary SP3 orbit/clock store with memory-mapped access
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// The store is written to a temporary file and renamed into place, so a
+// process mapping it never sees a partly written table.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "OrbitStore.h"
+
+using namespace std;
+
+// defined constants
+#define GPS_EPOCH_DAYS  3657   // 1980 Jan 6 in days from 1970 Jan 1
+
+// custom data types
+struct SP3Epoch {
+	double time;                      // seconds from the GPS epoch
+	OrbitRecord rec[ORBIT_MAX_SV];
+};
+
+
+// daysFromCivil: days from 1970 Jan 1 to a Gregorian calendar date
+static long daysFromCivil(int year, int month, int day)
+{
+	year -= month <= 2;
+	long era = (year >= 0 ? year : year - 399) / 400;
+	long yoe = year - era * 400;
+	long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return(era * 146097 + doe - 719468);
+}
+
+// tempName: a temporary file next to fname, unique per process and call,
+//   so conversions running at once never write the same file
+static string tempName(const string &fname)
+{
+	static atomic<unsigned int> calls(0);
+#ifdef _WIN32
+	unsigned long pid = GetCurrentProcessId();
+#else
+	unsigned long pid = (unsigned long)getpid();
+#endif
+	ostringstream name;
+	name << fname << "." << pid << "." << calls++ << ".tmp";
+	return(name.str());
+}
+
+static bool epochBefore(const SP3Epoch &a, const SP3Epoch &b)
+{
+	return(a.time < b.time);
+}
+
+// readSP3: appends the GPS position/clock records of one SP3 (a/c/d) file
+//   interval: epoch interval from the header (0 if not given)
+//   returns 0 on success, -1 if the file cannot be read
+static int readSP3(const string &fname, vector<SP3Epoch> &epochs, double &interval)
+{
+	ifstream in(fname.c_str());
+	string line;
+	SP3Epoch *current = 0;
+
+	if(!in.is_open())
+		return(-1);
+
+	while(getline(in, line))
+	{
+		if(line.size() >= 2 && line[0] == '#' && line[1] == '#')
+		{	// second header line: week, seconds of week, epoch interval
+			int week;
+			double sow, step;
+			if(sscanf(line.c_str() + 2, "%d %lf %lf", &week, &sow, &step) == 3)
+				interval = step;
+		}
+		else if(line.size() >= 2 && line[0] == '*')
+		{	// epoch header, calendar date in GPS time
+			int year, month, day, hour, minute;
+			double second;
+			if(sscanf(line.c_str() + 1, "%d %d %d %d %d %lf", &year, &month, &day, &hour, &minute, &second) != 6)
+			{
+				current = 0;
+				continue;
+			}
+
+			epochs.push_back(SP3Epoch());
+			current = &epochs.back();
+			current->time = (daysFromCivil(year, month, day) - GPS_EPOCH_DAYS) * 86400.0 +
+				hour * 3600.0 + minute * 60.0 + second;
+			for(int i = 0; i < ORBIT_MAX_SV; i++)
+			{
+				current->rec[i].x = current->rec[i].y = current->rec[i].z = 0.0;
+				current->rec[i].clock = ORBIT_NO_CLOCK;
+			}
+		}
+		else if(current != 0 && line.size() >= 46 && line[0] == 'P' && (line[1] == 'G' || line[1] == ' '))
+		{	// GPS position record: km and microseconds
+			int prn = atoi(line.substr(2, 2).c_str());
+			double x, y, z, clock = 999999.999999;
+			if(prn < 1 || prn > ORBIT_MAX_SV)
+				continue;
+			if(sscanf(line.c_str() + 4, "%lf %lf %lf %lf", &x, &y, &z, &clock) < 3)
+				continue;
+
+			OrbitRecord &r = current->rec[prn - 1];
+			r.x = x * 1000.0;
+			r.y = y * 1000.0;
+			r.z = z * 1000.0;
+			r.clock = fabs(clock) >= 999999.0 ? ORBIT_NO_CLOCK : clock * 1.0e-6;
+		}
+		else if(line.compare(0, 3, "EOF") == 0)
+		{
+			break;
+		}
+	}
+
+	return(0);
+}
+
+// convertSP3: converts SP3 files into one binary store on a fixed time grid
+//   returns 0 on success, -1 if an SP3 file cannot be read, -2 if the files
+//   hold no usable epochs, -3 if the store cannot be written
+int convertSP3(const vector<string> &sp3Files, const string &storeFile)
+{
+	vector<SP3Epoch> epochs;
+	double interval = 0.0;
+
+	for(unsigned int f = 0; f < sp3Files.size(); f++)
+	{
+		if(readSP3(sp3Files[f], epochs, interval) != 0)
+			return(-1);
+	}
+	if(epochs.empty())
+		return(-2);
+
+	sort(epochs.begin(), epochs.end(), epochBefore);
+	if(interval <= 0.0)
+	{	// no header interval, use the smallest epoch spacing
+		for(unsigned int i = 1; i < epochs.size(); i++)
+		{
+			double step = epochs[i].time - epochs[i - 1].time;
+			if(step > 0.0 && (interval <= 0.0 || step < interval))
+				interval = step;
+		}
+		if(interval <= 0.0)
+			return(-2);
+	}
+
+	// lay the epochs on the grid, gaps stay empty
+	double first = epochs.front().time;
+	unsigned int numEpochs = (unsigned int)floor((epochs.back().time - first) / interval + 0.5) + 1;
+	vector<OrbitRecord> table(numEpochs * ORBIT_MAX_SV);
+	for(unsigned int i = 0; i < table.size(); i++)
+	{
+		table[i].x = table[i].y = table[i].z = 0.0;
+		table[i].clock = ORBIT_NO_CLOCK;
+	}
+	for(unsigned int i = 0; i < epochs.size(); i++)
+	{
+		double slot = (epochs[i].time - first) / interval;
+		unsigned int n = (unsigned int)floor(slot + 0.5);
+		if(fabs(slot - n) > 1.0e-6)
+			continue;  // off grid epoch
+		for(int s = 0; s < ORBIT_MAX_SV; s++)
+			table[n * ORBIT_MAX_SV + s] = epochs[i].rec[s];
+	}
+
+	OrbitStoreHeader header;
+	header.magic     = ORBIT_STORE_MAGIC;
+	header.version   = ORBIT_STORE_VERSION;
+	header.numEpochs = numEpochs;
+	header.numSV     = ORBIT_MAX_SV;
+	header.firstWeek = (int)(first / SECONDS_PER_WEEK);
+	header.reserved  = 0;
+	header.firstSow  = first - header.firstWeek * SECONDS_PER_WEEK;
+	header.interval  = interval;
+
+	string tempFile = tempName(storeFile);
+	ofstream out(tempFile.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!out.is_open())
+		return(-3);
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char *>(&table[0]), table.size() * sizeof(OrbitRecord));
+	out.close();
+	if(out.fail())
+	{
+		remove(tempFile.c_str());
+		return(-3);
+	}
+
+	// another process may have published the same store meanwhile
+	if(rename(tempFile.c_str(), storeFile.c_str()) != 0)
+	{
+		remove(storeFile.c_str());
+		if(rename(tempFile.c_str(), storeFile.c_str()) != 0)
+		{
+			remove(tempFile.c_str());
+			return(-3);
+		}
+	}
+
+	return(0);
+}
+
+
+// lagrangeWeights: Lagrange basis w and its derivative dw (per node spacing)
+//   at s, for nodes at 0 .. ORBIT_INTERP_POINTS-1
+void lagrangeWeights(double s, double w[ORBIT_INTERP_POINTS], double dw[ORBIT_INTERP_POINTS])
+{
+	for(int k = 0; k < ORBIT_INTERP_POINTS; k++)
+	{
+		double wk = 1.0, dwk = 0.0;
+		for(int m = 0; m < ORBIT_INTERP_POINTS; m++)
+		{
+			if(m == k)
+				continue;
+			double term = 1.0 / (k - m);
+			dwk = dwk * (s - m) * term + wk * term;
+			wk *= (s - m) * term;
+		}
+		w[k]  = wk;
+		dw[k] = dwk;
+	}
+}
+
+
+// OrbitStore: default constructor
+OrbitStore::OrbitStore()
+{
+	header     = 0;
+	records    = 0;
+	mapping    = 0;
+	mappedSize = 0;
+	fileHandle = 0;
+	mapHandle  = 0;
+}
+
+// ~OrbitStore: destructor
+OrbitStore::~OrbitStore(void)
+{
+	close();
+}
+
+// open: maps a store written by convertSP3() read-only
+//   returns 0 on success, -1 if the file cannot be mapped, -2 if it is
+//   not a valid store
+int OrbitStore::open(const string &fname)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return(-1);
+	DWORD size = GetFileSize(file, NULL);
+	HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(map == NULL)
+	{
+		CloseHandle(file);
+		return(-1);
+	}
+	void *view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	if(view == NULL)
+	{
+		CloseHandle(map);
+		CloseHandle(file);
+		return(-1);
+	}
+	fileHandle = file;
+	mapHandle  = map;
+#else
+	int fd = ::open(fname.c_str(), O_RDONLY);
+	if(fd < 0)
+		return(-1);
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return(-1);
+	}
+	unsigned long size = st.st_size;
+	void *view = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);  // the mapping keeps the file referenced
+	if(view == MAP_FAILED)
+		return(-1);
+#endif
+
+	mapping    = view;
+	mappedSize = size;
+
+	// validate header and table size
+	const OrbitStoreHeader *h = static_cast<const OrbitStoreHeader *>(view);
+	if(mappedSize < sizeof(OrbitStoreHeader) || h->magic != ORBIT_STORE_MAGIC ||
+	   h->version != ORBIT_STORE_VERSION || h->numSV == 0 || h->numSV > ORBIT_MAX_SV ||
+	   h->interval <= 0.0 ||
+	   mappedSize != sizeof(OrbitStoreHeader) + (unsigned long)h->numEpochs * h->numSV * sizeof(OrbitRecord))
+	{
+		close();
+		return(-2);
+	}
+
+	header  = h;
+	records = reinterpret_cast<const OrbitRecord *>(static_cast<const char *>(view) + sizeof(OrbitStoreHeader));
+
+	return(0);
+}
+
+// close: unmaps the store
+void OrbitStore::close(void)
+{
+	if(mapping != 0)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+		CloseHandle(static_cast<HANDLE>(mapHandle));
+		CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+		munmap(mapping, mappedSize);
+#endif
+	}
+	header     = 0;
+	records    = 0;
+	mapping    = 0;
+	mappedSize = 0;
+	fileHandle = 0;
+	mapHandle  = 0;
+}
+
+// secondsFromStart: time from the first epoch of the store
+double OrbitStore::secondsFromStart(int week, double sow) const
+{
+	if(header == 0)
+		return(0.0);
+	return((week - header->firstWeek) * SECONDS_PER_WEEK + sow - header->firstSow);
+}
+
+// record: table entry of SV sv (PRN) at epoch index epoch, NULL if outside the table
+const OrbitRecord * OrbitStore::record(unsigned int epoch, int sv) const
+{
+	if(header == 0 || epoch >= header->numEpochs || sv < 1 || sv > (int)header->numSV)
+		return(0);
+	return(&records[epoch * header->numSV + (sv - 1)]);
+}
+
+// interpolate: SV state at a GPS time
+//   position and velocity by Lagrange interpolation over ORBIT_INTERP_POINTS
+//   epochs around the time, clock linearly between the two nearest epochs
+//   returns 0 on success, -1 no store or SV out of range, -2 time outside
+//   the store, -3 missing records around the time
+int OrbitStore::interpolate(int sv, int week, double sow, SVState &state) const
+{
+	if(header == 0 || sv < 1 || sv > (int)header->numSV)
+		return(-1);
+
+	int n = header->numEpochs;
+	double pos = secondsFromStart(week, sow) / header->interval;
+	if(n < ORBIT_INTERP_POINTS || pos < 0.0 || pos > n - 1)
+		return(-2);
+
+	// window of nodes centred on the time where possible
+	int below = (int)floor(pos);
+	int first = below - (ORBIT_INTERP_POINTS / 2 - 1);
+	if(first < 0)
+		first = 0;
+	if(first > n - ORBIT_INTERP_POINTS)
+		first = n - ORBIT_INTERP_POINTS;
+
+	double w[ORBIT_INTERP_POINTS], dw[ORBIT_INTERP_POINTS];
+	lagrangeWeights(pos - first, w, dw);
+
+	double x = 0.0, y = 0.0, z = 0.0;
+	double vx = 0.0, vy = 0.0, vz = 0.0;
+	for(int k = 0; k < ORBIT_INTERP_POINTS; k++)
+	{
+		const OrbitRecord &r = records[(first + k) * header->numSV + (sv - 1)];
+		if(r.x == 0.0 && r.y == 0.0 && r.z == 0.0)
+			return(-3);
+
+		x += w[k] * r.x;
+		y += w[k] * r.y;
+		z += w[k] * r.z;
+		vx += dw[k] * r.x;
+		vy += dw[k] * r.y;
+		vz += dw[k] * r.z;
+	}
+
+	// clock
+	int next = below + 1 < n ? below + 1 : below;
+	const OrbitRecord &c0 = records[below * header->numSV + (sv - 1)];
+	const OrbitRecord &c1 = records[next * header->numSV + (sv - 1)];
+	if(c0.clock >= ORBIT_NO_CLOCK || c1.clock >= ORBIT_NO_CLOCK)
+		return(-3);
+	double frac = pos - below;
+
+	state.x = x;
+	state.y = y;
+	state.z = z;
+	state.clockDrift = (c1.clock - c0.clock) / header->interval;
+	state.clockBias  = c0.clock + (c1.clock - c0.clock) * frac;
+	state.relativistic = -2.0 * (x * vx + y * vy + z * vz) / header->interval /
+		(GPS_SPEED_OF_LIGHT * GPS_SPEED_OF_LIGHT);
+
+	return(0);
+}
+
+
+// OrbitInterpolator: constructor, store must stay open while in use
+OrbitInterpolator::OrbitInterpolator(const OrbitStore &orbitStore) : store(orbitStore)
+{
+	windowLoads = 0;
+	reset();
+}
+
+// reset: drops the loaded window (after the store was reopened)
+void OrbitInterpolator::reset(void)
+{
+	windowFirst = -1;
+}
+
+// loadWindow: gathers nodes first .. first+P-1 of every SV into columns
+void OrbitInterpolator::loadWindow(int first)
+{
+	int numSV = store.numSV();
+
+	for(int c = 0; c < ORBIT_MAX_SV; c++)
+		hasOrbit[c] = c < numSV;
+
+	for(int k = 0; k < ORBIT_INTERP_POINTS; k++)
+	{
+		const OrbitRecord *r = store.record(first + k, 1);
+		for(int c = 0; c < numSV; c++)
+		{
+			wx[k][c] = r[c].x;
+			wy[k][c] = r[c].y;
+			wz[k][c] = r[c].z;
+			wclock[k][c] = r[c].clock;
+			if(r[c].x == 0.0 && r[c].y == 0.0 && r[c].z == 0.0)
+				hasOrbit[c] = 0;
+		}
+		for(int c = numSV; c < ORBIT_MAX_SV; c++)
+			wx[k][c] = wy[k][c] = wz[k][c] = wclock[k][c] = 0.0;
+	}
+
+	windowFirst = first;
+	windowLoads++;
+}
+
+// evaluate: SV states for all SVs of an epoch, same results as
+//   OrbitStore::interpolate() for each SV up to rounding
+//   returns number of SVs without a state (valid cleared)
+int OrbitInterpolator::evaluate(EpochSVData &data)
+{
+	int n = store.numEpochs();
+	double pos = store.secondsFromStart(data.week, data.tow) / store.interval();
+
+	if(!store.isOpen() || n < ORBIT_INTERP_POINTS || pos < 0.0 || pos > n - 1)
+	{
+		for(unsigned int i = 0; i < data.numSV; i++)
+			data.valid[i] = 0;
+		return(data.numSV);
+	}
+
+	// window, reused while the epochs stay in its centre interval
+	int below = (int)floor(pos);
+	int first = below - (ORBIT_INTERP_POINTS / 2 - 1);
+	if(first < 0)
+		first = 0;
+	if(first > n - ORBIT_INTERP_POINTS)
+		first = n - ORBIT_INTERP_POINTS;
+	if(first != windowFirst)
+		loadWindow(first);
+
+	// basis weights once for the epoch
+	double w[ORBIT_INTERP_POINTS], dw[ORBIT_INTERP_POINTS];
+	lagrangeWeights(pos - first, w, dw);
+	int c0 = below - first;
+	int c1 = below + 1 < n ? c0 + 1 : c0;
+	double frac = pos - below;
+
+	// all SV columns together, the inner loops run across SVs
+	double x[ORBIT_MAX_SV], y[ORBIT_MAX_SV], z[ORBIT_MAX_SV];
+	double vx[ORBIT_MAX_SV], vy[ORBIT_MAX_SV], vz[ORBIT_MAX_SV];
+	for(int c = 0; c < ORBIT_MAX_SV; c++)
+		x[c] = y[c] = z[c] = vx[c] = vy[c] = vz[c] = 0.0;
+	for(int k = 0; k < ORBIT_INTERP_POINTS; k++)
+	{
+		const double wk = w[k], dwk = dw[k];
+		for(int c = 0; c < ORBIT_MAX_SV; c++)
+		{
+			x[c]  += wk * wx[k][c];
+			y[c]  += wk * wy[k][c];
+			z[c]  += wk * wz[k][c];
+			vx[c] += dwk * wx[k][c];
+			vy[c] += dwk * wy[k][c];
+			vz[c] += dwk * wz[k][c];
+		}
+	}
+
+	// scatter to the epoch rows
+	double relScale = -2.0 / store.interval() / (GPS_SPEED_OF_LIGHT * GPS_SPEED_OF_LIGHT);
+	int unavailable = 0;
+	for(unsigned int i = 0; i < data.numSV; i++)
+	{
+		int c = data.sv[i] - 1;
+		if(c < 0 || c >= ORBIT_MAX_SV || !hasOrbit[c] ||
+		   wclock[c0][c] >= ORBIT_NO_CLOCK || wclock[c1][c] >= ORBIT_NO_CLOCK)
+		{
+			data.valid[i] = 0;
+			unavailable++;
+			continue;
+		}
+
+		data.x[i] = x[c];
+		data.y[i] = y[c];
+		data.z[i] = z[c];
+		data.clockDrift[i] = (wclock[c1][c] - wclock[c0][c]) / store.interval();
+		data.clockBias[i]  = wclock[c0][c] + (wclock[c1][c] - wclock[c0][c]) * frac;
+		data.relativistic[i] = relScale * (x[c] * vx[c] + y[c] * vy[c] + z[c] * vz[c]);
+		data.valid[i] = 1;
+	}
+
+	return(unavailable);
+}
@@ -0,0 +1,129 @@
+//**********************************************************************
+// File:			OrbitStore.h
+// Programmer:		Guoyu Fu
+// Description:		Binary SP3 orbit/clock store with memory-mapped access
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// convertSP3() parses text SP3 files once into a compact binary store:
+// a small header followed by a dense [epoch][SV] table of positions and
+// clocks on a fixed time grid.  OrbitStore maps that file read-only, so
+// opening it costs no parsing and concurrent processes share the same
+// physical pages.  A record is found by index arithmetic on (SV, epoch).
+//
+// OrbitInterpolator evaluates every SV of an epoch at once: the Lagrange
+// weights depend only on the epoch time, so they are computed once and
+// applied to all SV columns of a window gathered from the store.  The
+// window is kept while consecutive epochs fall inside it.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef ORBIT_STORE_H
+#define ORBIT_STORE_H
+
+// defined constants
+#define ORBIT_STORE_MAGIC     0x42335053   // "SP3B"
+#define ORBIT_STORE_VERSION   1
+#define ORBIT_STORE_EXTENSION ".sp3b"
+#define ORBIT_MAX_SV          32           // GPS PRNs held by the store
+#define ORBIT_NO_CLOCK        1.0          // clock of records without a clock estimate (s)
+#define ORBIT_INTERP_POINTS   10           // Lagrange interpolation points
+
+// included libraries
+#include <string>
+#include <vector>
+
+#include "SVState.h"
+#include "EpochData.h"
+
+// custom data types
+struct OrbitStoreHeader {
+	unsigned int magic;       // ORBIT_STORE_MAGIC
+	unsigned int version;     // ORBIT_STORE_VERSION
+	unsigned int numEpochs;   // epochs in the table
+	unsigned int numSV;       // SV columns in the table (PRN 1 .. numSV)
+	int    firstWeek;         // GPS week of first epoch
+	unsigned int reserved;
+	double firstSow;          // GPS seconds of week of first epoch
+	double interval;          // seconds between epochs
+};
+
+struct OrbitRecord {
+	double x, y, z;   // SV position (meters), all zero => no position
+	double clock;     // SV clock bias (seconds), >= ORBIT_NO_CLOCK => no clock
+};
+
+// definition of OrbitStore class
+class OrbitStore
+{
+	public:
+		// constructors
+		OrbitStore();
+
+		// destructor
+		~OrbitStore(void);
+
+		// methods
+		int  open(const std::string &fname);
+		void close(void);
+		bool isOpen(void) const { return(header != 0); }
+
+		unsigned int numEpochs(void) const { return(header ? header->numEpochs : 0); }
+		unsigned int numSV(void) const { return(header ? header->numSV : 0); }
+		double interval(void) const { return(header ? header->interval : 0.0); }
+		double secondsFromStart(int week, double sow) const;
+		const OrbitRecord * record(unsigned int epoch, int sv) const;
+
+		int  interpolate(int sv, int week, double sow, SVState &state) const;
+
+	private:
+		OrbitStore(const OrbitStore &);                // not copyable
+		OrbitStore & operator=(const OrbitStore &);
+
+		const OrbitStoreHeader * header;
+		const OrbitRecord *      records;
+		void *        mapping;       // start of mapped view
+		unsigned long mappedSize;    // bytes mapped
+		void *        fileHandle;    // platform file/mapping handles
+		void *        mapHandle;
+};
+
+// definition of OrbitInterpolator class
+class OrbitInterpolator
+{
+	public:
+		// constructors
+		OrbitInterpolator(const OrbitStore &orbitStore);
+
+		// methods
+		int  evaluate(EpochSVData &data);
+		void reset(void);
+
+		// statistics
+		unsigned long windowLoads;
+
+	private:
+		OrbitInterpolator & operator=(const OrbitInterpolator &);
+
+		const OrbitStore & store;
+
+		// window of ORBIT_INTERP_POINTS epochs, one row per node, one column per SV
+		int    windowFirst;   // store epoch of node 0, -1 => no window loaded
+		double wx[ORBIT_INTERP_POINTS][ORBIT_MAX_SV];
+		double wy[ORBIT_INTERP_POINTS][ORBIT_MAX_SV];
+		double wz[ORBIT_INTERP_POINTS][ORBIT_MAX_SV];
+		double wclock[ORBIT_INTERP_POINTS][ORBIT_MAX_SV];
+		int    hasOrbit[ORBIT_MAX_SV];   // 1 => all nodes have a position
+
+		// methods
+		void loadWindow(int first);
+};
+
+// function prototypes
+void lagrangeWeights(double s, double w[ORBIT_INTERP_POINTS], double dw[ORBIT_INTERP_POINTS]);
+int convertSP3(const std::vector<std::string> &sp3Files, const std::string &storeFile);
+
+#endif // ORBIT_STORE_H
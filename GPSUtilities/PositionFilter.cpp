@@ -0,0 +1,258 @@
+//**********************************************************************
+// File:			PositionFilter.cpp
+// Programmer:		Guoyu Fu
+// Description:		Extended Kalman filter for position, velocity and clock
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Measurements are the corrected pseudoranges of an EpochSVData (after
+// CorrectionStage) plus the SV clock bias, as for solutionNLLS.  Each
+// scalar update relinearises about the current state, so later SVs of
+// an epoch see the improvement from earlier ones.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+
+#include "PositionFilter.h"
+#include "LeastSquares.h"
+#include "DirectSolution.h"
+#include "SVState.h"
+
+using namespace std;
+
+// defined constants
+#define CLOCK_BIAS   6   // state index of receiver clock bias
+#define CLOCK_DRIFT  7   // state index of receiver clock drift
+
+
+// PositionFilter: default constructor
+PositionFilter::PositionFilter()
+{
+	restarts = 0;
+	reset();
+}
+
+// reset: forgets the state, the next update() restarts the filter
+void PositionFilter::reset(void)
+{
+	for(int i = 0; i < FILTER_STATES; i++)
+	{
+		state[i] = 0.0;
+		for(int j = 0; j < FILTER_STATES; j++)
+			covariance[i][j] = 0.0;
+	}
+	time = 0.0;
+	used = 0;
+	rejected = 0;
+	initialized = false;
+}
+
+// initialize: starts the filter from a closed form solution of epoch
+//   returns 0 on success, <0 if the epoch cannot be solved
+int PositionFilter::initialize(const EpochSVData &epoch, double epochTime)
+{
+	double x[LSQ_MAX_ROWS], y[LSQ_MAX_ROWS], z[LSQ_MAX_ROWS], pr[LSQ_MAX_ROWS];
+	double solution[4];
+	unsigned int rows = 0;
+
+	for(unsigned int i = 0; i < epoch.numSV && rows < LSQ_MAX_ROWS; i++)
+	{
+		if(!epoch.valid[i])
+			continue;
+		x[rows]  = epoch.x[i];
+		y[rows]  = epoch.y[i];
+		z[rows]  = epoch.z[i];
+		pr[rows] = epoch.pr[i] + epoch.clockBias[i] * GPS_SPEED_OF_LIGHT;
+		rows++;
+	}
+
+	int errorcode = bancroftSolution(x, y, z, pr, rows, solution);
+	if(errorcode != 0)
+		return(errorcode);
+
+	reset();
+	state[0] = solution[0];
+	state[1] = solution[1];
+	state[2] = solution[2];
+	state[CLOCK_BIAS] = solution[3];
+	for(int i = 0; i < 3; i++)
+	{
+		covariance[i][i]         = FILTER_INIT_POS_VAR;
+		covariance[i + 3][i + 3] = FILTER_INIT_VEL_VAR;
+	}
+	covariance[CLOCK_BIAS][CLOCK_BIAS]   = FILTER_INIT_CLK_VAR;
+	covariance[CLOCK_DRIFT][CLOCK_DRIFT] = FILTER_INIT_DRIFT_VAR;
+	time = epochTime;
+	initialized = true;
+	restarts++;
+
+	return(0);
+}
+
+// predict: propagates state and covariance by dt seconds, in place
+//   P = F P F' + Q with F = I plus dt in the (position, velocity) and
+//   (bias, drift) pairs
+void PositionFilter::predict(double dt)
+{
+	static const int rate[4][2] = { {0, 3}, {1, 4}, {2, 5}, {CLOCK_BIAS, CLOCK_DRIFT} };
+
+	if(dt == 0.0)
+		return;
+
+	for(int p = 0; p < 4; p++)
+		state[rate[p][0]] += dt * state[rate[p][1]];
+
+	// F P: rows of the integrated states take dt times their rate rows
+	for(int p = 0; p < 4; p++)
+	{
+		int i = rate[p][0], j = rate[p][1];
+		for(int k = 0; k < FILTER_STATES; k++)
+			covariance[i][k] += dt * covariance[j][k];
+	}
+	// (F P) F': same on the columns
+	for(int p = 0; p < 4; p++)
+	{
+		int i = rate[p][0], j = rate[p][1];
+		for(int k = 0; k < FILTER_STATES; k++)
+			covariance[k][i] += dt * covariance[k][j];
+	}
+
+	// process noise of the integrated white noise pairs
+	double dt2 = dt * dt, dt3 = dt2 * dt;
+	for(int p = 0; p < 3; p++)
+	{
+		int i = rate[p][0], j = rate[p][1];
+		covariance[i][i] += FILTER_ACCEL_NOISE * dt3 / 3.0;
+		covariance[i][j] += FILTER_ACCEL_NOISE * dt2 / 2.0;
+		covariance[j][i] += FILTER_ACCEL_NOISE * dt2 / 2.0;
+		covariance[j][j] += FILTER_ACCEL_NOISE * dt;
+	}
+	covariance[CLOCK_BIAS][CLOCK_BIAS]   += FILTER_CLOCK_NOISE_F * dt + FILTER_CLOCK_NOISE_G * dt3 / 3.0;
+	covariance[CLOCK_BIAS][CLOCK_DRIFT]  += FILTER_CLOCK_NOISE_G * dt2 / 2.0;
+	covariance[CLOCK_DRIFT][CLOCK_BIAS]  += FILTER_CLOCK_NOISE_G * dt2 / 2.0;
+	covariance[CLOCK_DRIFT][CLOCK_DRIFT] += FILTER_CLOCK_NOISE_G * dt;
+}
+
+// measurement: scalar update with one pseudorange, h = [-u' 0 0 0 1 0]
+//   returns false if the innovation fails the gate (state unchanged)
+bool PositionFilter::measurement(double svx, double svy, double svz, double pr)
+{
+	double dx = svx - state[0];
+	double dy = svy - state[1];
+	double dz = svz - state[2];
+	double range = sqrt(dx * dx + dy * dy + dz * dz);
+	if(range == 0.0)
+		return(false);
+	double ux = dx / range, uy = dy / range, uz = dz / range;
+
+	// P h' using the four non-zero entries of h
+	double ph[FILTER_STATES];
+	for(int k = 0; k < FILTER_STATES; k++)
+		ph[k] = -ux * covariance[k][0] - uy * covariance[k][1] - uz * covariance[k][2] +
+		        covariance[k][CLOCK_BIAS];
+
+	double s = -ux * ph[0] - uy * ph[1] - uz * ph[2] + ph[CLOCK_BIAS] +
+	           FILTER_PR_SIGMA * FILTER_PR_SIGMA;
+	double innovation = pr - (range + state[CLOCK_BIAS]);
+	if(innovation * innovation > FILTER_GATE * FILTER_GATE * s)
+		return(false);
+
+	// x += K v, P -= K (P h')' with K = P h' / s
+	for(int i = 0; i < FILTER_STATES; i++)
+	{
+		double k = ph[i] / s;
+		state[i] += k * innovation;
+		for(int j = 0; j < FILTER_STATES; j++)
+			covariance[i][j] -= k * ph[j];
+	}
+
+	return(true);
+}
+
+// applyEpoch: sequential updates with the valid rows of epoch
+void PositionFilter::applyEpoch(const EpochSVData &epoch)
+{
+	used = 0;
+	rejected = 0;
+	for(unsigned int i = 0; i < epoch.numSV; i++)
+	{
+		if(!epoch.valid[i])
+			continue;
+		if(measurement(epoch.x[i], epoch.y[i], epoch.z[i],
+		               epoch.pr[i] + epoch.clockBias[i] * GPS_SPEED_OF_LIGHT))
+			used++;
+		else
+			rejected++;
+	}
+}
+
+// update: advances the filter to the epoch and applies its valid rows
+//   (re)starts from a closed form solution when not running, after a gap
+//   longer than FILTER_MAX_GAP or when the epoch rejects the prediction
+//   returns number of measurements used, <0 if the filter could not start
+int PositionFilter::update(const EpochSVData &epoch)
+{
+	double epochTime = epoch.week * SECONDS_PER_WEEK + epoch.tow;
+	unsigned int available = 0;
+	for(unsigned int i = 0; i < epoch.numSV; i++)
+		available += epoch.valid[i] ? 1 : 0;
+
+	if(!initialized || fabs(epochTime - time) > FILTER_MAX_GAP)
+	{
+		int errorcode = initialize(epoch, epochTime);
+		if(errorcode != 0)
+		{
+			initialized = false;
+			return(errorcode);
+		}
+	}
+
+	predict(epochTime - time);
+	time = epochTime;
+
+	applyEpoch(epoch);
+
+	// most of a full epoch disagrees: clock jump or lost track, restart
+	if(available >= 4 && rejected > used)
+	{
+		if(initialize(epoch, epochTime) != 0)
+		{
+			initialized = false;
+			return(-1);
+		}
+		applyEpoch(epoch);
+	}
+
+	return(used);
+}
+
+// gdop: geometric dilution of precision of the valid rows of epoch at
+//   the filter position, <0 if fewer than four rows or singular
+double PositionFilter::gdop(const EpochSVData &epoch) const
+{
+	double x[LSQ_MAX_ROWS], y[LSQ_MAX_ROWS], z[LSQ_MAX_ROWS];
+	double solution[4] = { state[0], state[1], state[2], state[CLOCK_BIAS] };
+	double dop[4][4];
+	unsigned int rows = 0;
+
+	for(unsigned int i = 0; i < epoch.numSV && rows < LSQ_MAX_ROWS; i++)
+	{
+		if(!epoch.valid[i])
+			continue;
+		x[rows] = epoch.x[i];
+		y[rows] = epoch.y[i];
+		z[rows] = epoch.z[i];
+		rows++;
+	}
+
+	if(dopFixed<4>(x, y, z, (const unsigned char *)NULL, rows, solution, dop) != 0)
+		return(-1.0);
+
+	return(sqrt(dop[0][0] + dop[1][1] + dop[2][2] + dop[3][3]));
+}
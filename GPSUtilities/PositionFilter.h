@@ -0,0 +1,75 @@
+//**********************************************************************
+// File:			PositionFilter.h
+// Programmer:		Guoyu Fu
+// Description:		Extended Kalman filter for position, velocity and clock
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// A recursive alternative to solutionNLLS for live streams.  The state
+// is fixed: ECEF position and velocity with a constant velocity model,
+// receiver clock bias and drift (all in meters, meters/second).
+// Pseudoranges are applied one at a time as scalar updates, so each
+// epoch costs a prediction plus O(states^2) per SV, with no matrix
+// inversion.  Epochs with fewer than four usable SVs still update the
+// filter (or just predict it), where the least squares solution has to
+// give up.  The filter starts from a closed form (Bancroft) solution
+// and restarts from one after a long gap or a receiver clock jump.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef POSITION_FILTER_H
+#define POSITION_FILTER_H
+
+// defined constants
+#define FILTER_STATES         8        // x y z vx vy vz clockBias clockDrift
+#define FILTER_ACCEL_NOISE    1.0      // white acceleration spectral density (m^2/s^3)
+#define FILTER_CLOCK_NOISE_F  9.0e-3   // clock bias (white frequency) spectral density (m^2/s)
+#define FILTER_CLOCK_NOISE_G  3.6e-2   // clock drift (random walk frequency) spectral density (m^2/s^3)
+#define FILTER_PR_SIGMA       5.0      // pseudorange measurement sigma (meters)
+#define FILTER_GATE           5.0      // innovation gate (sigmas)
+#define FILTER_MAX_GAP        30.0     // longest prediction before a restart (seconds)
+#define FILTER_INIT_POS_VAR   1.0e4    // initial position variance (m^2)
+#define FILTER_INIT_VEL_VAR   1.0e2    // initial velocity variance (m^2/s^2)
+#define FILTER_INIT_CLK_VAR   1.0e4    // initial clock bias variance (m^2)
+#define FILTER_INIT_DRIFT_VAR 1.0e4    // initial clock drift variance (m^2/s^2)
+
+// included libraries
+#include "EpochData.h"
+
+// definition of PositionFilter class
+class PositionFilter
+{
+	public:
+		// constructors
+		PositionFilter();
+
+		// methods
+		void reset(void);
+		bool isInitialized(void) const { return(initialized); }
+		int  update(const EpochSVData &epoch);
+		double gdop(const EpochSVData &epoch) const;
+
+		// state (meters, meters/second) and covariance, valid after update()
+		double state[FILTER_STATES];
+		double covariance[FILTER_STATES][FILTER_STATES];
+		double time;               // GPS seconds since the GPS epoch of state
+
+		// results of the last update
+		unsigned int used;         // measurements applied
+		unsigned int rejected;     // measurements failing the innovation gate
+		unsigned int restarts;     // total restarts from a closed form solution
+
+	private:
+		bool initialized;
+
+		// methods
+		int  initialize(const EpochSVData &epoch, double epochTime);
+		void predict(double dt);
+		bool measurement(double svx, double svy, double svz, double pr);
+		void applyEpoch(const EpochSVData &epoch);
+};
+
+#endif // POSITION_FILTER_H
@@ -0,0 +1,321 @@
+//**********************************************************************
+// File:			SVState.cpp
+// Programmer:		Guoyu Fu
+// Description:		Broadcast ephemeris SV position/clock evaluation
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Orbit and clock equations follow IS-GPS-200 table 20-IV.  The batch
+// evaluator gathers the ephemeris parameters of every cache miss into
+// local columns and runs each step of the propagation across all SVs
+// before moving to the next step.  Kepler's equation is iterated a
+// fixed number of times so the loop has no data dependent exit and the
+// compiler can vectorize it.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cmath>
+#include <cstring>
+
+#include "SVState.h"
+
+using namespace std;
+
+// defined constants
+#define MS_PER_WEEK  604800000LL  // milliseconds in a GPS week
+
+
+// extract bits first..last (1 = MSB) of a 24 bit navigation data word
+static unsigned int navBits(unsigned int word, int first, int last)
+{
+	return((word >> (24 - last)) & ((1u << (last - first + 1)) - 1));
+}
+
+// join the 8 MSBs ending one word with the 24 LSBs of the next word
+static unsigned long long navJoin(unsigned int msbWord, unsigned int lsbWord)
+{
+	return((static_cast<unsigned long long>(navBits(msbWord, 17, 24)) << 24) | navBits(lsbWord, 1, 24));
+}
+
+// sign extend a two's complement value of the given bit width
+static long long signExtend(unsigned long long value, int bits)
+{
+	if(value & (1ull << (bits - 1)))
+		return(static_cast<long long>(value) - static_cast<long long>(1ull << bits));
+	return(static_cast<long long>(value));
+}
+
+// correct a time difference for beginning or end of week crossover
+static double weekCrossover(double dt)
+{
+	if(dt > HALF_WEEK)
+		dt -= 2 * HALF_WEEK;
+	else if(dt < -HALF_WEEK)
+		dt += 2 * HALF_WEEK;
+	return(dt);
+}
+
+
+// decodeEphemeris: decodes subframes 1-3 of a GPS LNAV message
+//   Note: words 3..10 of each subframe, parity removed, data in bits 0-23
+//         (the layout of the u-blox RXM-EPH and AID-EPH optional block)
+int decodeEphemeris(BroadcastEphemeris &eph, int sv,
+                    const unsigned int sf1[8], const unsigned int sf2[8], const unsigned int sf3[8])
+{
+	if(sv < 1 || sv > MAX_GPS_PRN)
+		return(-1);
+
+	// the IODE in subframes 2 and 3 must match the IODC LSBs, otherwise
+	// the subframes were collected across an ephemeris cutover
+	unsigned int iodc = (navBits(sf1[0], 23, 24) << 8) | navBits(sf1[5], 1, 8);
+	unsigned int iode2 = navBits(sf2[0], 1, 8);
+	unsigned int iode3 = navBits(sf3[7], 1, 8);
+	if(iode2 != iode3 || iode2 != (iodc & 0xFF))
+		return(-2);
+
+	eph.sv     = sv;
+	eph.week   = navBits(sf1[0], 1, 10);
+	eph.health = navBits(sf1[0], 17, 22);
+	eph.iodc   = iodc;
+	eph.iode   = iode2;
+
+	// subframe 1: clock parameters
+	eph.tgd = signExtend(navBits(sf1[4], 17, 24), 8) * pow(2.0, -31);
+	eph.toc = navBits(sf1[5], 9, 24) * 16.0;
+	eph.af2 = signExtend(navBits(sf1[6], 1, 8), 8) * pow(2.0, -55);
+	eph.af1 = signExtend(navBits(sf1[6], 9, 24), 16) * pow(2.0, -43);
+	eph.af0 = signExtend(navBits(sf1[7], 1, 22), 22) * pow(2.0, -31);
+
+	// subframe 2: ephemeris part 1
+	eph.crs    = signExtend(navBits(sf2[0], 9, 24), 16) * pow(2.0, -5);
+	eph.deltaN = signExtend(navBits(sf2[1], 1, 16), 16) * pow(2.0, -43) * GPS_PI;
+	eph.m0     = signExtend(navJoin(sf2[1], sf2[2]), 32) * pow(2.0, -31) * GPS_PI;
+	eph.cuc    = signExtend(navBits(sf2[3], 1, 16), 16) * pow(2.0, -29);
+	eph.e      = navJoin(sf2[3], sf2[4]) * pow(2.0, -33);
+	eph.cus    = signExtend(navBits(sf2[5], 1, 16), 16) * pow(2.0, -29);
+	eph.sqrtA  = navJoin(sf2[5], sf2[6]) * pow(2.0, -19);
+	eph.toe    = navBits(sf2[7], 1, 16) * 16.0;
+
+	// subframe 3: ephemeris part 2
+	eph.cic      = signExtend(navBits(sf3[0], 1, 16), 16) * pow(2.0, -29);
+	eph.omega0   = signExtend(navJoin(sf3[0], sf3[1]), 32) * pow(2.0, -31) * GPS_PI;
+	eph.cis      = signExtend(navBits(sf3[2], 1, 16), 16) * pow(2.0, -29);
+	eph.i0       = signExtend(navJoin(sf3[2], sf3[3]), 32) * pow(2.0, -31) * GPS_PI;
+	eph.crc      = signExtend(navBits(sf3[4], 1, 16), 16) * pow(2.0, -5);
+	eph.w        = signExtend(navJoin(sf3[4], sf3[5]), 32) * pow(2.0, -31) * GPS_PI;
+	eph.omegaDot = signExtend(navBits(sf3[6], 1, 24), 24) * pow(2.0, -43) * GPS_PI;
+	eph.idot     = signExtend(navBits(sf3[7], 9, 22), 14) * pow(2.0, -43) * GPS_PI;
+
+	return(0);
+}
+
+
+// constructors
+SVStateEngine::SVStateEngine()
+{
+	memset(ephemeris, 0, sizeof(ephemeris));
+	memset(generation, 0, sizeof(generation));
+	clearCache();
+}
+
+// methods
+int SVStateEngine::setEphemeris(const BroadcastEphemeris &eph)
+{
+	if(eph.sv < 1 || eph.sv > MAX_GPS_PRN)
+		return(-1);
+
+	// repeated broadcasts of the same issue leave the cache untouched
+	if(generation[eph.sv] != 0 && ephemeris[eph.sv].iode == eph.iode &&
+	   ephemeris[eph.sv].toe == eph.toe)
+		return(0);
+
+	// new issue of data invalidates every state cached for this SV
+	ephemeris[eph.sv] = eph;
+	generation[eph.sv]++;
+	if(generation[eph.sv] == 0)
+		generation[eph.sv] = 1;
+
+	return(0);
+}
+
+bool SVStateEngine::hasEphemeris(int sv) const
+{
+	if(sv < 1 || sv > MAX_GPS_PRN)
+		return(false);
+	return(generation[sv] != 0);
+}
+
+void SVStateEngine::clearCache(void)
+{
+	for(unsigned int i = 0; i < SV_CACHE_SIZE; i++)
+	{
+		cache[i].key = -1;
+		cache[i].generation = 0;
+	}
+	cacheHits   = 0;
+	cacheMisses = 0;
+}
+
+SVStateEngine::CacheEntry * SVStateEngine::slot(long long key)
+{
+	// multiplicative hash of the packed key, direct mapped
+	unsigned long long h = static_cast<unsigned long long>(key) * 0x9E3779B97F4A7C15ULL;
+	return(&cache[(h >> 40) & (SV_CACHE_SIZE - 1)]);
+}
+
+SVStateEngine::CacheEntry * SVStateEngine::lookup(long long key, int sv)
+{
+	CacheEntry * entry = slot(key);
+	if(entry->key == key && entry->generation == generation[sv])
+		return(entry);
+	return(0);
+}
+
+int SVStateEngine::evaluate(int sv, int week, double tow, SVState &state)
+{
+	EpochSVData data;
+
+	data.week  = week;
+	data.tow   = tow;
+	data.numSV = 1;
+	data.sv[0] = sv;
+
+	evaluate(data);
+	if(!data.valid[0])
+		return(-1);
+
+	state.x            = data.x[0];
+	state.y            = data.y[0];
+	state.z            = data.z[0];
+	state.clockBias    = data.clockBias[0];
+	state.clockDrift   = data.clockDrift[0];
+	state.relativistic = data.relativistic[0];
+
+	return(0);
+}
+
+// evaluate: fills SV state columns of data for every row
+//   returns the number of rows for which no ephemeris was available
+int SVStateEngine::evaluate(EpochSVData &data)
+{
+	// ephemeris parameters of the cache misses, one column per parameter
+	int    row[MAX_EPOCH_SV];
+	double tk[MAX_EPOCH_SV], tc[MAX_EPOCH_SV];
+	double A[MAX_EPOCH_SV], e[MAX_EPOCH_SV], M[MAX_EPOCH_SV], E[MAX_EPOCH_SV];
+	double af0[MAX_EPOCH_SV], af1[MAX_EPOCH_SV], af2[MAX_EPOCH_SV], tgd[MAX_EPOCH_SV];
+	const BroadcastEphemeris * eph[MAX_EPOCH_SV];
+	long long key[MAX_EPOCH_SV];
+	unsigned int misses = 0;
+	int unavailable = 0;
+
+	long long epochMs = data.week * MS_PER_WEEK + static_cast<long long>(floor(data.tow * 1000.0 + 0.5));
+
+	// pass 1: serve cache hits, gather misses
+	for(unsigned int i = 0; i < data.numSV && i < MAX_EPOCH_SV; i++)
+	{
+		int sv = data.sv[i];
+		if(!hasEphemeris(sv))
+		{
+			data.valid[i] = 0;
+			unavailable++;
+			continue;
+		}
+
+		long long k = epochMs * 64 + sv;
+		CacheEntry * entry = lookup(k, sv);
+		if(entry != 0)
+		{
+			data.x[i]            = entry->state.x;
+			data.y[i]            = entry->state.y;
+			data.z[i]            = entry->state.z;
+			data.clockBias[i]    = entry->state.clockBias;
+			data.clockDrift[i]   = entry->state.clockDrift;
+			data.relativistic[i] = entry->state.relativistic;
+			data.valid[i]        = 1;
+			cacheHits++;
+			continue;
+		}
+
+		const BroadcastEphemeris &p = ephemeris[sv];
+		row[misses] = i;
+		key[misses] = k;
+		eph[misses] = &p;
+		tk[misses]  = weekCrossover(data.tow - p.toe);
+		tc[misses]  = weekCrossover(data.tow - p.toc);
+		A[misses]   = p.sqrtA * p.sqrtA;
+		e[misses]   = p.e;
+		M[misses]   = p.m0 + (sqrt(GPS_GM / (A[misses] * A[misses] * A[misses])) + p.deltaN) * tk[misses];
+		af0[misses] = p.af0;
+		af1[misses] = p.af1;
+		af2[misses] = p.af2;
+		tgd[misses] = p.tgd;
+		misses++;
+	}
+	cacheMisses += misses;
+
+	// pass 2: solve Kepler's equation for all misses together
+	for(unsigned int j = 0; j < misses; j++)
+		E[j] = M[j];
+	for(int itr = 0; itr < KEPLER_ITERATIONS; itr++)
+	{
+		for(unsigned int j = 0; j < misses; j++)
+			E[j] = M[j] + e[j] * sin(E[j]);
+	}
+
+	// pass 3: orbit position, clock and cache fill
+	for(unsigned int j = 0; j < misses; j++)
+	{
+		const BroadcastEphemeris &p = *eph[j];
+		double sinE = sin(E[j]);
+		double cosE = cos(E[j]);
+
+		// true anomaly and argument of latitude
+		double v   = atan2(sqrt(1.0 - e[j] * e[j]) * sinE, cosE - e[j]);
+		double phi = v + p.w;
+		double s2  = sin(2.0 * phi);
+		double c2  = cos(2.0 * phi);
+
+		// second harmonic perturbations
+		double u = phi + p.cus * s2 + p.cuc * c2;
+		double r = A[j] * (1.0 - e[j] * cosE) + p.crs * s2 + p.crc * c2;
+		double i = p.i0 + p.cis * s2 + p.cic * c2 + p.idot * tk[j];
+
+		// position in orbital plane and corrected longitude of ascending node
+		double xp = r * cos(u);
+		double yp = r * sin(u);
+		double omega = p.omega0 + (p.omegaDot - GPS_OMEGA_E) * tk[j] - GPS_OMEGA_E * p.toe;
+
+		SVState state;
+		state.x = xp * cos(omega) - yp * cos(i) * sin(omega);
+		state.y = xp * sin(omega) + yp * cos(i) * cos(omega);
+		state.z = yp * sin(i);
+
+		// SV clock polynomial (L1 single frequency users apply TGD)
+		state.clockBias    = af0[j] + af1[j] * tc[j] + af2[j] * tc[j] * tc[j] - tgd[j];
+		state.clockDrift   = af1[j] + 2.0 * af2[j] * tc[j];
+		state.relativistic = GPS_REL_F * e[j] * p.sqrtA * sinE;
+
+		// scatter into epoch columns
+		int k = row[j];
+		data.x[k]            = state.x;
+		data.y[k]            = state.y;
+		data.z[k]            = state.z;
+		data.clockBias[k]    = state.clockBias;
+		data.clockDrift[k]   = state.clockDrift;
+		data.relativistic[k] = state.relativistic;
+		data.valid[k]        = 1;
+
+		// memoize
+		CacheEntry * entry = slot(key[j]);
+		entry->key        = key[j];
+		entry->generation = generation[p.sv];
+		entry->state      = state;
+	}
+
+	return(unavailable);
+}
@@ -0,0 +1,109 @@
+//**********************************************************************
+// File:			SVState.h
+// Programmer:		Guoyu Fu
+// Description:		Broadcast ephemeris SV position/clock evaluation
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// SVStateEngine keeps the latest broadcast ephemeris of every GPS SV
+// and evaluates SV ECEF position and clock bias for all SVs of an
+// epoch in one pass.  Results are memoized by (SV, time) so that every
+// consumer asking for the same epoch (solver, ModelChecker, sky plots)
+// pays for the Kepler propagation only once.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef SV_STATE_H
+#define SV_STATE_H
+
+// defined constants
+#define GPS_GM              3.986005e14       // WGS-84 earth gravitational constant (m^3/s^2)
+#define GPS_OMEGA_E         7.2921151467e-5   // WGS-84 earth rotation rate (rad/s)
+#define GPS_REL_F           -4.442807633e-10  // relativistic constant F (s/m^0.5)
+#define GPS_PI              3.1415926535898   // value of pi used by IS-GPS-200
+#define GPS_SPEED_OF_LIGHT  299792458.0       // speed of light (m/s)
+#define HALF_WEEK           302400.0          // half of a GPS week (seconds)
+#define SECONDS_PER_WEEK    604800.0          // length of a GPS week (seconds)
+#define MAX_GPS_PRN         32                // highest GPS PRN held by the engine
+#define KEPLER_ITERATIONS   10                // fixed Kepler iterations (e < 0.03 => < 1e-15 rad)
+#define SV_CACHE_SIZE       4096              // memoized SV states (must be a power of two)
+
+// included libraries
+#include "EpochData.h"
+
+// custom data types
+struct BroadcastEphemeris {
+	int    sv;        // space vehicle number (PRN)
+	int    week;      // GPS week number (10 bits as broadcast)
+	int    health;    // SV health bits
+	int    iodc;      // issue of data, clock
+	int    iode;      // issue of data, ephemeris
+	double tgd;       // group delay differential (seconds)
+	double toc;       // clock data reference time (seconds)
+	double af0;       // SV clock bias (seconds)
+	double af1;       // SV clock drift (seconds/second)
+	double af2;       // SV clock drift rate (seconds/second^2)
+	double toe;       // ephemeris reference time (seconds)
+	double sqrtA;     // square root of semi-major axis (meters^0.5)
+	double e;         // eccentricity
+	double m0;        // mean anomaly at reference time (radians)
+	double deltaN;    // mean motion difference (radians/second)
+	double omega0;    // longitude of ascending node at weekly epoch (radians)
+	double omegaDot;  // rate of right ascension (radians/second)
+	double i0;        // inclination at reference time (radians)
+	double idot;      // rate of inclination (radians/second)
+	double w;         // argument of perigee (radians)
+	double cuc, cus;  // argument of latitude harmonic corrections (radians)
+	double crc, crs;  // orbit radius harmonic corrections (meters)
+	double cic, cis;  // inclination harmonic corrections (radians)
+};
+
+struct SVState {
+	double x, y, z;       // SV ECEF position (meters)
+	double clockBias;     // SV clock bias incl. group delay (seconds)
+	double clockDrift;    // SV clock drift (seconds/second)
+	double relativistic;  // relativistic clock term (seconds)
+};
+
+// definition of SVStateEngine class
+class SVStateEngine
+{
+	public:
+		// constructors
+		SVStateEngine();
+
+		// methods
+		int  setEphemeris(const BroadcastEphemeris &eph);
+		bool hasEphemeris(int sv) const;
+		int  evaluate(EpochSVData &data);
+		int  evaluate(int sv, int week, double tow, SVState &state);
+		void clearCache(void);
+
+		// cache statistics
+		unsigned long cacheHits;
+		unsigned long cacheMisses;
+
+	private:
+		struct CacheEntry {
+			long long    key;         // packed (time, SV) key, -1 => empty
+			unsigned int generation;  // ephemeris generation the entry was computed from
+			SVState      state;
+		};
+
+		BroadcastEphemeris ephemeris[MAX_GPS_PRN + 1];
+		unsigned int generation[MAX_GPS_PRN + 1];  // 0 => no ephemeris loaded
+		CacheEntry cache[SV_CACHE_SIZE];
+
+		// methods
+		CacheEntry * lookup(long long key, int sv);
+		CacheEntry * slot(long long key);
+};
+
+// function prototypes
+int decodeEphemeris(BroadcastEphemeris &eph, int sv,
+                    const unsigned int sf1[8], const unsigned int sf2[8], const unsigned int sf3[8]);
+
+#endif // SV_STATE_H
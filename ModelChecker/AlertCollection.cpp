@@ -0,0 +1,237 @@
+#include <iostream>
+#include <chrono>
+#include "AlertCollection.h"
+using namespace std;
+
+static long long now_ms()
+{
+	return chrono::duration_cast<chrono::milliseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char * alertText(int code)
+{
+	switch(code)
+	{
+	case ALERT_LOW_MEAS_QUALITY:
+		return "low measurement quality";
+	case ALERT_UNHEALTHY_SV:
+		return "unhealthy SV tracked";
+	case ALERT_RANGE_RESIDUAL:
+		return "pseudorange residual";
+	}
+	return "unknown";
+}
+
+AlertCollection::AlertCollection()
+	: tail(0), head(0), n_accepted(0), n_dropped(0), draining(false),
+	  callback(NULL), callback_context(NULL)
+{
+	ring = new AlertSlot[ALERT_QUEUE_SIZE];
+	for(unsigned long long i = 0; i < ALERT_QUEUE_SIZE; i++)
+	{
+		ring[i].seq.store(i);
+	}
+	for(int c = 0; c < ALERT_MAX_CODES; c++)
+	{
+		window_start[c].store(0);
+		window_count[c].store(0);
+		rate_limit[c].store(ALERT_RATE_LIMIT);
+		n_suppressed[c].store(0);
+	}
+}
+
+AlertCollection::~AlertCollection()
+{
+	stop_drain();
+	delete [] ring;
+}
+
+void AlertCollection::set_rate_limit(int code, unsigned int per_second)
+{
+	if(code >= 0 && code < ALERT_MAX_CODES)
+	{
+		rate_limit[code].store(per_second);
+	}
+}
+
+unsigned long AlertCollection::suppressed(int code) const
+{
+	if(code < 0 || code >= ALERT_MAX_CODES)
+	{
+		return 0;
+	}
+	return n_suppressed[code].load();
+}
+
+// Fixed one second window per code.  Producers racing on a window
+// rollover may let a few extra alerts through, which is harmless.
+bool AlertCollection::admit(int code)
+{
+	long long now = now_ms();
+	long long start = window_start[code].load(memory_order_relaxed);
+	if(now - start >= 1000 &&
+	   window_start[code].compare_exchange_strong(start, now, memory_order_relaxed))
+	{
+		window_count[code].store(0, memory_order_relaxed);
+	}
+	return window_count[code].fetch_add(1, memory_order_relaxed) <
+	       rate_limit[code].load(memory_order_relaxed);
+}
+
+// returns 0 => queued, 1 => rate limited, 2 => queue full
+int AlertCollection::push(const GPSAlert &alert)
+{
+	int code = alert.code < ALERT_MAX_CODES ? alert.code : 0;
+	if(!admit(code))
+	{
+		n_suppressed[code].fetch_add(1, memory_order_relaxed);
+		return 1;
+	}
+
+	// bounded MPMC ring: each slot's sequence tells producers whether
+	// it is free for the position they are about to claim
+	unsigned long long pos = tail.load(memory_order_relaxed);
+	AlertSlot * slot;
+	while(true)
+	{
+		slot = &ring[pos & (ALERT_QUEUE_SIZE - 1)];
+		unsigned long long seq = slot->seq.load(memory_order_acquire);
+		long long diff = (long long)seq - (long long)pos;
+		if(diff == 0)
+		{
+			if(tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if(diff < 0)
+		{
+			n_dropped.fetch_add(1, memory_order_relaxed);
+			return 2;
+		}
+		else
+		{
+			pos = tail.load(memory_order_relaxed);
+		}
+	}
+
+	slot->alert = alert;
+	slot->seq.store(pos + 1, memory_order_release);
+	n_accepted.fetch_add(1, memory_order_relaxed);
+	return 0;
+}
+
+// single consumer only: either the drain thread or the owner when no
+// drain is running
+bool AlertCollection::pop(GPSAlert &alert)
+{
+	AlertSlot * slot = &ring[head & (ALERT_QUEUE_SIZE - 1)];
+	if(slot->seq.load(memory_order_acquire) != head + 1)
+	{
+		return false;
+	}
+	alert = slot->alert;
+	slot->seq.store(head + ALERT_QUEUE_SIZE, memory_order_release);
+	head++;
+	return true;
+}
+
+int AlertCollection::start_drain(string fname)
+{
+	if(draining.load())
+	{
+		return 1;
+	}
+	out_file.open(fname.c_str(), ios::out);
+	if(!out_file.is_open())
+	{
+		cout << "Unable to open alert file!" << endl;
+		return 1;
+	}
+	out_file << "code,alert,sv,week,iTOW,value" << endl;
+	callback = NULL;
+	draining.store(true);
+	drain_thread = thread(&AlertCollection::drain_loop, this);
+	return 0;
+}
+
+int AlertCollection::start_drain(AlertCallback cb, void * context)
+{
+	if(draining.load() || cb == NULL)
+	{
+		return 1;
+	}
+	callback = cb;
+	callback_context = context;
+	draining.store(true);
+	drain_thread = thread(&AlertCollection::drain_loop, this);
+	return 0;
+}
+
+void AlertCollection::stop_drain()
+{
+	if(!draining.load())
+	{
+		return;
+	}
+	draining.store(false);
+	drain_thread.join();
+
+	if(out_file.is_open())
+	{
+		// record what the rate limiter and the full ring threw away
+		for(int c = 0; c < ALERT_MAX_CODES; c++)
+		{
+			if(n_suppressed[c].load() > 0)
+			{
+				out_file << "SUPPRESSED," << c << "," << alertText(c) << ","
+				         << n_suppressed[c].load() << endl;
+			}
+		}
+		if(n_dropped.load() > 0)
+		{
+			out_file << "DROPPED," << n_dropped.load() << endl;
+		}
+		out_file.close();
+	}
+}
+
+void AlertCollection::deliver(const GPSAlert &alert)
+{
+	if(callback != NULL)
+	{
+		callback(alert, callback_context);
+		return;
+	}
+	out_file << alert.code << "," << alertText(alert.code) << ","
+	         << static_cast<unsigned>(alert.sv) << "," << alert.week << ","
+	         << alert.iTOW << "," << alert.value << "\n";
+}
+
+void AlertCollection::drain_loop()
+{
+	GPSAlert alert;
+	while(true)
+	{
+		bool running = draining.load();
+		int n = 0;
+		while(pop(alert))
+		{
+			deliver(alert);
+			n++;
+		}
+		if(!running)
+		{
+			break;	// queue emptied after stop was requested
+		}
+		if(n == 0)
+		{
+			this_thread::sleep_for(chrono::milliseconds(ALERT_DRAIN_IDLE_MS));
+		}
+	}
+	if(out_file.is_open())
+	{
+		out_file.flush();
+	}
+}
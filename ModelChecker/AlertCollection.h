@@ -0,0 +1,95 @@
+#ifndef ALERT_COLLECTION_H
+#define ALERT_COLLECTION_H
+
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <string>
+#include "../ParseUBX/LibUBX.h"
+
+// alert codes
+#define ALERT_LOW_MEAS_QUALITY  1   // RXM-RAW mesQI below PR+DO OK
+#define ALERT_UNHEALTHY_SV      2   // SV flagged unhealthy but tracked
+#define ALERT_RANGE_RESIDUAL    3   // pseudorange residual beyond threshold
+#define ALERT_MAX_CODES         64
+
+#define ALERT_QUEUE_SIZE        4096   // queued records (must be a power of two)
+#define ALERT_RATE_LIMIT        100    // default alerts per code per second
+#define ALERT_DRAIN_IDLE_MS     2      // drain thread sleep when queue is empty
+
+// compact structured alert record
+class GPSAlert
+{
+public:
+	GPSAlert():code(0),sv(0),week(0),iTOW(0),value(0.0){};
+	GPSAlert(U2 c, U1 s, I2 w, U4 t, R8 v):code(c),sv(s),week(w),iTOW(t),value(v){};
+
+	U2 code;	// ALERT_* code
+	U1 sv;		// space vehicle (0 => not SV specific)
+	I2 week;	// GPS week of epoch
+	U4 iTOW;	// GPS millisecond time of week of epoch
+	R8 value;	// offending value (quality, residual, ...)
+};
+
+const char * alertText(int code);
+
+typedef void (*AlertCallback)(const GPSAlert &alert, void * context);
+
+// Multi-producer alert queue.  push() is lock free and never waits: when
+// a code exceeds its rate limit or the ring is full the alert is counted
+// and dropped.  A single drain thread empties the ring into a file or a
+// callback.
+class AlertCollection
+{
+public:
+	AlertCollection();
+	~AlertCollection();
+
+	int  push(const GPSAlert &alert);
+	bool pop(GPSAlert &alert);
+	void set_rate_limit(int code, unsigned int per_second);
+
+	int  start_drain(string fname);
+	int  start_drain(AlertCallback cb, void * context);
+	void stop_drain();
+
+	unsigned long accepted() const { return n_accepted.load(); }
+	unsigned long dropped() const { return n_dropped.load(); }
+	unsigned long suppressed(int code) const;
+
+private:
+	AlertCollection(const AlertCollection &);				// not copyable
+	AlertCollection & operator=(const AlertCollection &);
+
+	struct AlertSlot {
+		std::atomic<unsigned long long> seq;
+		GPSAlert alert;
+	};
+
+	bool admit(int code);
+	void drain_loop();
+	void deliver(const GPSAlert &alert);
+
+	// ring buffer
+	AlertSlot * ring;
+	std::atomic<unsigned long long> tail;	// next slot producers claim
+	unsigned long long head;				// next slot the drain reads
+
+	// per-code fixed window rate limiting
+	std::atomic<long long>    window_start[ALERT_MAX_CODES];
+	std::atomic<unsigned int> window_count[ALERT_MAX_CODES];
+	std::atomic<unsigned int> rate_limit[ALERT_MAX_CODES];
+	std::atomic<unsigned long> n_suppressed[ALERT_MAX_CODES];
+
+	std::atomic<unsigned long> n_accepted;
+	std::atomic<unsigned long> n_dropped;
+
+	// drain
+	std::thread drain_thread;
+	std::atomic<bool> draining;
+	ofstream out_file;
+	AlertCallback callback;
+	void * callback_context;
+};
+
+#endif
@@ -1,18 +1,19 @@
 #include <iostream>
 #include <fstream>
 #include "../ParseUBX/LibUBX.h"
+#include "../SolutionUBX/UBXMeasurements.h"
 #include "ModelChecker.h"
 using namespace std;
 
-ModelChecker::ModelChecker(string name, AlertCollection * pac)
+ModelChecker::ModelChecker(string name, AlertCollection * pac, SVStateEngine * psve)
 {
 	int res;
 	fname = name;
-	up = UBXParser();
 	res = up.open(fname);
 	// TODO, how to check whether the file exist?
 	input_source = UBX_FILE;
 	ac = pac;
+	sve = psve;
 }
 
 
@@ -29,11 +30,13 @@ int ModelChecker::read_next()
 	int res;
 	UBXMessage um;
 	res = up.read_next_ubx(um);
-	if(res != 0)
+	if(res == 2)
 	{
 		cout << "error read next ubx message" << endl;
-		return 1;
+		return 2;
 	}
+	if(res != 0)
+		return 1;
 	// TODO, it might be that the ubxparser package provider 
 	// do not have any packages
 	
@@ -60,6 +63,9 @@ int ModelChecker::read_next()
 			// check whether the raw and Est is good
 			check_message();
 			break;
+		case EPH:
+			update_ephemeris(um);
+			break;
 		}
 		break;
 	case NAV:
@@ -78,6 +84,7 @@ int ModelChecker::read_next()
 			break;
 		case EPH:
 			aideph_list.push_back(um);
+			update_ephemeris(um);
 			break;
 		}
 		break;
@@ -85,9 +92,33 @@ int ModelChecker::read_next()
 	return 0;
 }
 
+int ModelChecker::update_ephemeris(UBXMessage &um)
+{
+	// RXM-EPH and AID-EPH, read byte-wise by the decoder SolutionUBX
+	// uses (the payload overlays depend on the size of U4)
+	BroadcastEphemeris be;
+	if(sve == NULL || decodeEphemerisMessage(um, be) != 1)
+		return 1;
+	return sve->setEphemeris(be);
+}
+
 int ModelChecker::check_message()
 {
 
+	if(rxmraw_list.empty())
+	{
+		return 1;
+	}
+	UBXMessage &um = rxmraw_list.back();
+	if(um.header.length < RXM_RAW_HEADER_SIZE)
+	{
+		return 1;
+	}
+	// read byte-wise, the I4 overlay of iTOW depends on the size of long
+	U4 iTOW = readU4(um.payload);
+	I2 week = (I2)readU2(um.payload + 4);
+	U1 numSV = um.payload[6];
+
 	// Step 1, get all satellite
 	// remove unhealhy satellite
 	// Healthy information from satellite
@@ -95,6 +126,15 @@ int ModelChecker::check_message()
 
 	// Step 2, get the prMes raw pseudorange
 	// from RXM RAW package
+	for(int i = 0; i < numSV && RXM_RAW_HEADER_SIZE + RXM_RAW_BLOCK_SIZE*(i+1) <= um.header.length; i++)
+	{
+		UBXPayload_RXM_RAW_rb rb(um.payload + RXM_RAW_BLOCK_SIZE*i);
+		if(rb.mesQI < 4 && ac != NULL)
+		{
+			// pseudorange/doppler not usable
+			ac->push(GPSAlert(ALERT_LOW_MEAS_QUALITY, rb.sv, week, iTOW, rb.mesQI));
+		}
+	}
 
 	
 	// Step 3, 
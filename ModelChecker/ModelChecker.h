@@ -3,23 +3,8 @@
 
 #include <vector>
 #include "../ParseUBX/ParseUBX.h"
-
-class GPSAlert
-{
-public:
-	GPSAlert(){};
-	GPSAlert(string alert){};
-private:
-	string message;
-};
-
-class AlertCollection
-{
-public:
-	AlertCollection(){};
-private:
-	vector<GPSAlert> alert_list;
-};
+#include "../GPSUtilities/SVState.h"
+#include "AlertCollection.h"
 
 #define UBX_FILE 0
 
@@ -27,19 +12,24 @@ class ModelChecker
 {
 public:
 	ModelChecker(){};
-	ModelChecker(string fname, AlertCollection *ac);
+	ModelChecker(string fname, AlertCollection *ac, SVStateEngine *sve = NULL);
 
 	~ModelChecker();
-	int read_next();
+	int read_next();	// 0 => message read, 1 => end of log, 2 => checksum error
 	int check_message();
+	int update_ephemeris(UBXMessage &um);
 
 
 private:
+	ModelChecker(const ModelChecker &);	// not copyable, owns the parser
+	ModelChecker & operator=(const ModelChecker &);
+
 	int input_source;
 	string fname;
 	UBXParser up;
 
 	AlertCollection * ac;	
+	SVStateEngine * sve;	// shared SV state engine (may be NULL)
 
 	// Message List
 	vector<UBXMessage> rxmsvsi_list;
@@ -11,14 +11,17 @@ using namespace std;
 // main program module
 int main(int argc, char* argv[])
 {
-	AlertCollection	ac = AlertCollection();
+	AlertCollection	ac;
+	SVStateEngine * sve = new SVStateEngine();
 	string fname = "../ParseUBX/t.ubx";
-	ModelChecker mc = ModelChecker(fname,&ac);
-	while(true)
+	ModelChecker mc(fname,&ac,sve);
+	ac.start_drain("alerts.csv");
+	// 0 => message checked, 2 => checksum error (skipped), 1 => end of log
+	while(mc.read_next() != 1)
 	{
-		mc.read_next();
-		break;
 	}
+	ac.stop_drain();
 
+	delete sve;
 	return(0);
 }
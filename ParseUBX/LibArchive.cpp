@@ -0,0 +1,726 @@
+//**************************************************************
+// UBX archive codec
+//   - this file implements the field models and the block
+//     format of the .ubz archive.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <cstring>
+#include <unordered_map>
+#include "LibArchive.h"
+
+#ifdef UBX_ZLIB
+#include <zlib.h>
+#endif
+#ifdef UBX_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+// streams of a block
+#define STREAM_RECORDS   0   // record kinds, class and ID of frames
+#define STREAM_LENGTHS   1   // literal run lengths, payload length changes
+#define STREAM_LITERALS  2   // literal bytes
+#define STREAM_FIELDS    3   // field residuals
+#define STREAM_TRACKS    4   // satellite measurement residuals
+#define STREAM_BYTES     5   // payload bytes of frames without a layout
+
+// records
+#define RECORD_LITERAL   0   // run of literal bytes
+#define RECORD_FRAME     1   // UBX frame
+
+// block format
+#define BLOCK_HEADER     4   // log bytes, after the length field
+#define STREAM_HEADER    9   // method, coded and stored lengths
+
+// UBX frame
+#define UBX_SYNC1        0xB5
+#define UBX_SYNC2        0x62
+#define UBX_OVERHEAD     8   // sync, class, ID, length, checksum
+
+#define TRACK_FIELDS     3   // satellite fields in a group at most
+
+const unsigned char ARCHIVE_MAGIC[ARCHIVE_MAGIC_SIZE] = { 'U', 'B', 'Z', 1 };
+
+// field codes of a layout
+//   '1' '2' '4' '8'  integer of that many bytes, predicted by its last value
+//   'L'              4 byte integer, predicted linearly from its last two values
+//   'R'              8 byte double, predicted linearly on its bit pattern
+//   'P' 'C'          8 byte double of a satellite, predicted linearly on its
+//                    bit pattern from the satellite's last two epochs
+//   'D'              4 byte float or integer of a satellite, predicted by its
+//                    last epoch
+// integer arithmetic on the bit patterns keeps the predictions identical
+// on every machine, whatever its floating point unit does
+struct Layout
+{
+	unsigned char msgClass;
+	unsigned char msgId;
+	const char * header;      // fields once per message
+	const char * group;       // fields repeated to the end of the payload, or 0
+	size_t keyOffset;         // satellite key in a group
+	size_t keyLength;         // 0 => no satellite fields
+};
+
+static const Layout LAYOUTS[] =
+{
+	{ 0x01, 0x01, "L4444",                0,                0,  0 },   // NAV-POSECEF
+	{ 0x01, 0x02, "L444444",              0,                0,  0 },   // NAV-POSLLH
+	{ 0x01, 0x03, "L111144",              0,                0,  0 },   // NAV-STATUS
+	{ 0x01, 0x04, "L2222222",             0,                0,  0 },   // NAV-DOP
+	{ 0x01, 0x06, "L4211444444442114",    0,                0,  0 },   // NAV-SOL
+	{ 0x01, 0x07, "L2111111" "44" "1111" "4444444444444" "2" "111111" "422",
+	                                      0,                0,  0 },   // NAV-PVT
+	{ 0x01, 0x12, "L44444444",            0,                0,  0 },   // NAV-VELNED
+	{ 0x01, 0x20, "L42114",               0,                0,  0 },   // NAV-TIMEGPS
+	{ 0x01, 0x21, "L4421111111",          0,                0,  0 },   // NAV-TIMEUTC
+	{ 0x01, 0x22, "LL444",                0,                0,  0 },   // NAV-CLOCK
+	{ 0x01, 0x30, "L112",                 "11111124",       0,  0 },   // NAV-SVINFO
+	{ 0x01, 0x31, "L42211" "11",          "11244",          0,  0 },   // NAV-DGPS
+	{ 0x02, 0x10, "L211",                 "CPD1111",        20, 1 },   // RXM-RAW, key sv
+	{ 0x02, 0x14, "1111" "LLL" "1111" "L" "222" "11" "2" "11" "11111111",
+	                                      "1111DD224" "1111", 0, 2 },  // RXM-MEASX, key gnssId svId
+	{ 0x02, 0x15, "R2111111",             "PCD11112111111", 20, 3 },   // RXM-RAWX, key gnssId svId sigId
+};
+
+#define NUM_LAYOUTS  (sizeof(LAYOUTS) / sizeof(LAYOUTS[0]))
+
+// field kinds
+#define FIELD_LAST          0   // predicted by its last value
+#define FIELD_LINEAR        1   // predicted linearly from its last two values
+#define FIELD_TRACK_LAST    2   // satellite field, by its last epoch
+#define FIELD_TRACK_LINEAR  3   // satellite field, linearly from its last two epochs
+
+// a field of a compiled layout
+struct Field
+{
+	size_t offset;            // in the header or group
+	size_t width;
+	int kind;
+};
+
+// last values of a satellite
+struct Track
+{
+	unsigned long long value[TRACK_FIELDS][2];   // [1] is the last epoch
+	int epochs;                                  // up to 2
+};
+
+// coding state of a message type
+struct TypeState
+{
+	const Layout * layout;
+	vector<Field> header;              // fields of the layout, satellite fields apart
+	vector<Field> group;
+	vector<Field> satellite;
+	size_t headerBytes;
+	size_t groupBytes;
+	unsigned long length;              // payload length of the last message
+	const unsigned char * last;        // payloads of the last two messages, 0 if none
+	size_t lastLength;
+	const unsigned char * before;
+	size_t beforeLength;
+	unordered_map<unsigned long, Track> tracks;
+	vector<unsigned long> groupKeys;   // satellite of each group in the last message,
+	vector<Track *> groupTracks;       // most satellites keep their place
+};
+
+// little endian helpers
+static inline unsigned long get2(const unsigned char * p)
+{
+	return(p[0] | (static_cast<unsigned long>(p[1]) << 8));
+}
+
+static inline unsigned long get4(const unsigned char * p)
+{
+	return(get2(p) | (get2(p + 2) << 16));
+}
+
+static inline void put4(vector<unsigned char> &to, unsigned long v)
+{
+	to.push_back(static_cast<unsigned char>(v));
+	to.push_back(static_cast<unsigned char>(v >> 8));
+	to.push_back(static_cast<unsigned char>(v >> 16));
+	to.push_back(static_cast<unsigned char>(v >> 24));
+}
+
+static inline unsigned long long load(const unsigned char * p, size_t width)
+{
+	switch(width)
+	{
+		case 1:  return(p[0]);
+		case 2:  return(get2(p));
+		case 4:  return(get4(p));
+		case 8:  return(get4(p) | (static_cast<unsigned long long>(get4(p + 4)) << 32));
+	}
+
+	unsigned long long v = 0;   // satellite keys
+	for(size_t b = width; b > 0; b--)
+		v = (v << 8) | p[b - 1];
+	return(v);
+}
+
+static inline void store(unsigned char * p, size_t width, unsigned long long v)
+{
+	switch(width)
+	{
+		case 8: p[7] = static_cast<unsigned char>(v >> 56);
+		        p[6] = static_cast<unsigned char>(v >> 48);
+		        p[5] = static_cast<unsigned char>(v >> 40);
+		        p[4] = static_cast<unsigned char>(v >> 32);
+		        // fall through
+		case 4: p[3] = static_cast<unsigned char>(v >> 24);
+		        p[2] = static_cast<unsigned char>(v >> 16);
+		        // fall through
+		case 2: p[1] = static_cast<unsigned char>(v >> 8);
+		        // fall through
+		case 1: p[0] = static_cast<unsigned char>(v);
+	}
+}
+
+// compile: turns the field codes of a layout into fields, returns their bytes
+static size_t compile(const char * codes, vector<Field> &fields, vector<Field> &satellite)
+{
+	size_t offset = 0;
+	for(; codes != 0 && *codes != 0; codes++)
+	{
+		Field field;
+		field.offset = offset;
+		switch(*codes)
+		{
+			case '1': field.width = 1; field.kind = FIELD_LAST;         break;
+			case '2': field.width = 2; field.kind = FIELD_LAST;         break;
+			case '4': field.width = 4; field.kind = FIELD_LAST;         break;
+			case 'L': field.width = 4; field.kind = FIELD_LINEAR;       break;
+			case 'R': field.width = 8; field.kind = FIELD_LINEAR;       break;
+			case 'D': field.width = 4; field.kind = FIELD_TRACK_LAST;   break;
+			case 'P':
+			case 'C': field.width = 8; field.kind = FIELD_TRACK_LINEAR; break;
+			default:  field.width = 8; field.kind = FIELD_LAST;         break;   // '8'
+		}
+		if(field.kind == FIELD_TRACK_LAST || field.kind == FIELD_TRACK_LINEAR)
+			satellite.push_back(field);
+		else
+			fields.push_back(field);
+		offset += field.width;
+	}
+	return(offset);
+}
+
+// checksum of a frame: 8-bit Fletcher over class, ID, length and payload
+static inline void checksum(const unsigned char * frame, size_t payloadLength, unsigned char &a, unsigned char &b)
+{
+	unsigned int ckA = 0;
+	unsigned int ckB = 0;
+	const unsigned char * end = frame + 6 + payloadLength;
+	for(const unsigned char * p = frame + 2; p < end; p++)
+	{
+		ckA += *p;
+		ckB += ckA;
+	}
+	a = static_cast<unsigned char>(ckA);
+	b = static_cast<unsigned char>(ckB);
+}
+
+// definition of BlockCoder class, codes one block in either direction
+class BlockCoder
+{
+	public:
+		BlockCoder(bool unpack) : unpacking(unpack), bad(false) {}
+
+		void pack(const unsigned char * data, size_t length);
+		bool unpack(unsigned char * out, size_t length);
+
+		vector<unsigned char> streams[ARCHIVE_STREAMS];   // packing: coded streams
+		const unsigned char * at[ARCHIVE_STREAMS];        // unpacking: next coded byte
+		const unsigned char * end[ARCHIVE_STREAMS];
+
+	private:
+		bool unpacking;
+		bool bad;                      // a stream ended early
+		unordered_map<unsigned int, TypeState> types;
+
+		TypeState & typeState(unsigned char msgClass, unsigned char msgId);
+		void codePayload(TypeState &type, unsigned char * payload, size_t length);
+		void codeBytes(TypeState &type, unsigned char * payload, size_t length);
+		void codeFields(TypeState &type, const vector<Field> &fields, unsigned char * payload, size_t offset);
+		void codeTrack(const vector<Field> &fields, unsigned char * group, Track &track);
+		Track & track(TypeState &type, size_t g, unsigned long key);
+		unsigned long long codeValue(unsigned char * p, size_t width, unsigned long long predicted, int stream);
+
+		void putVarint(int stream, unsigned long long v);
+		unsigned long long getVarint(int stream);
+		unsigned char getByte(int stream);
+};
+
+// typeState: the state of a message type, made on its first message
+TypeState & BlockCoder::typeState(unsigned char msgClass, unsigned char msgId)
+{
+	unsigned int id = (msgClass << 8) | msgId;
+	unordered_map<unsigned int, TypeState>::iterator found = types.find(id);
+	if(found != types.end())
+		return(found->second);
+
+	TypeState &type = types[id];
+	type.layout = 0;
+	for(size_t l = 0; l < NUM_LAYOUTS; l++)
+	{
+		if(LAYOUTS[l].msgClass == msgClass && LAYOUTS[l].msgId == msgId)
+			type.layout = &LAYOUTS[l];
+	}
+	vector<Field> none;   // a header has no satellite fields
+	type.headerBytes  = type.layout != 0 ? compile(type.layout->header, type.header, none) : 0;
+	type.groupBytes   = type.layout != 0 ? compile(type.layout->group, type.group, type.satellite) : 0;
+	type.length       = 0;
+	type.last         = 0;
+	type.lastLength   = 0;
+	type.before       = 0;
+	type.beforeLength = 0;
+	return(type);
+}
+
+// codePayload: codes the fields of a payload, or its bytes if the type has
+//   no layout or the length does not fit it
+void BlockCoder::codePayload(TypeState &type, unsigned char * payload, size_t length)
+{
+	const Layout * layout = type.layout;
+	bool fits = layout != 0 && length >= type.headerBytes &&
+		(type.groupBytes == 0 ? length == type.headerBytes : (length - type.headerBytes) % type.groupBytes == 0);
+
+	if(fits)
+	{
+		codeFields(type, type.header, payload, 0);
+		size_t g = 0;
+		for(size_t at = type.headerBytes; at < length; at += type.groupBytes, g++)
+		{
+			// the key is coded with the other fields, before the satellite fields
+			codeFields(type, type.group, payload, at);
+			if(layout->keyLength != 0)
+			{
+				unsigned long key = static_cast<unsigned long>(load(payload + at + layout->keyOffset, layout->keyLength));
+				codeTrack(type.satellite, payload + at, track(type, g, key));
+			}
+		}
+	}
+	else
+		codeBytes(type, payload, length);
+
+	type.before       = type.last;
+	type.beforeLength = type.lastLength;
+	type.last         = payload;
+	type.lastLength   = length;
+}
+
+// codeBytes: codes each byte as its difference to the byte of the last message
+void BlockCoder::codeBytes(TypeState &type, unsigned char * payload, size_t length)
+{
+	size_t common = length < type.lastLength ? length : type.lastLength;
+	if(length == 0)
+		return;   // empty payload, nothing to code
+
+	if(unpacking)
+	{
+		if(static_cast<size_t>(end[STREAM_BYTES] - at[STREAM_BYTES]) < length)
+		{
+			bad = true;
+			return;
+		}
+		const unsigned char * in = at[STREAM_BYTES];
+		for(size_t b = 0; b < common; b++)
+			payload[b] = static_cast<unsigned char>(in[b] + type.last[b]);
+		if(length > common)
+			memcpy(payload + common, in + common, length - common);
+		at[STREAM_BYTES] += length;
+		return;
+	}
+
+	vector<unsigned char> &out = streams[STREAM_BYTES];
+	size_t used = out.size();
+	out.resize(used + length);
+	for(size_t b = 0; b < common; b++)
+		out[used + b] = static_cast<unsigned char>(payload[b] - type.last[b]);
+	if(length > common)
+		memcpy(&out[used] + common, payload + common, length - common);
+}
+
+// codeFields: codes the fields of a header or group at offset in the payload
+void BlockCoder::codeFields(TypeState &type, const vector<Field> &fields, unsigned char * payload, size_t offset)
+{
+	for(size_t f = 0; f < fields.size(); f++)
+	{
+		const Field &field = fields[f];
+		size_t at   = offset + field.offset;
+		size_t next = at + field.width;
+
+		unsigned long long predicted = 0;
+		if(next <= type.lastLength)
+		{
+			predicted = load(type.last + at, field.width);
+			if(field.kind == FIELD_LINEAR && next <= type.beforeLength)
+				predicted = 2 * predicted - load(type.before + at, field.width);
+		}
+		codeValue(payload + at, field.width, predicted, STREAM_FIELDS);
+	}
+}
+
+// codeTrack: codes the satellite fields of a group from the satellite's last epochs
+void BlockCoder::codeTrack(const vector<Field> &fields, unsigned char * group, Track &track)
+{
+	for(size_t f = 0; f < fields.size(); f++)
+	{
+		const Field &field = fields[f];
+		unsigned long long * values = track.value[f];
+
+		unsigned long long predicted = 0;
+		if(track.epochs == 2 && field.kind == FIELD_TRACK_LINEAR)
+			predicted = 2 * values[1] - values[0];
+		else if(track.epochs > 0)
+			predicted = values[1];
+
+		values[0] = values[1];
+		values[1] = codeValue(group + field.offset, field.width, predicted, STREAM_TRACKS);
+	}
+	if(track.epochs < 2)
+		track.epochs++;
+}
+
+// track: the track of a satellite in group g, found where it was in the
+//   last message before it is looked up
+Track & BlockCoder::track(TypeState &type, size_t g, unsigned long key)
+{
+	if(g < type.groupKeys.size() && type.groupKeys[g] == key)
+		return(*type.groupTracks[g]);
+
+	Track * track = &type.tracks[key];   // a new one is zero
+	if(g >= type.groupKeys.size())
+	{
+		type.groupKeys.resize(g + 1);
+		type.groupTracks.resize(g + 1);
+	}
+	type.groupKeys[g]   = key;
+	type.groupTracks[g] = track;
+	return(*track);
+}
+
+// codeValue: codes a field as the zigzag varint of its difference to the
+//   prediction, wrapped to the field width; returns the field value
+inline unsigned long long BlockCoder::codeValue(unsigned char * p, size_t width, unsigned long long predicted, int stream)
+{
+	int shift = static_cast<int>(64 - 8 * width);
+
+	if(unpacking)
+	{
+		unsigned long long zigzag = getVarint(stream);
+		unsigned long long value = predicted + ((zigzag >> 1) ^ (0 - (zigzag & 1)));
+		store(p, width, value);
+		return((value << shift) >> shift);
+	}
+
+	unsigned long long value = load(p, width);
+	long long residual = static_cast<long long>((value - predicted) << shift) >> shift;
+	putVarint(stream, (static_cast<unsigned long long>(residual) << 1) ^ static_cast<unsigned long long>(residual >> 63));
+	return(value);
+}
+
+inline void BlockCoder::putVarint(int stream, unsigned long long v)
+{
+	vector<unsigned char> &out = streams[stream];
+	while(v >= 0x80)
+	{
+		out.push_back(static_cast<unsigned char>(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back(static_cast<unsigned char>(v));
+}
+
+inline unsigned long long BlockCoder::getVarint(int stream)
+{
+	const unsigned char * p = at[stream];
+	if(p != end[stream] && *p < 0x80)
+	{	// most residuals are small
+		at[stream] = p + 1;
+		return(*p);
+	}
+
+	unsigned long long v = 0;
+	for(int shift = 0; shift < 64 && p != end[stream]; shift += 7)
+	{
+		unsigned char b = *p++;
+		v |= static_cast<unsigned long long>(b & 0x7F) << shift;
+		if((b & 0x80) == 0)
+		{
+			at[stream] = p;
+			return(v);
+		}
+	}
+	bad = true;
+	return(0);
+}
+
+inline unsigned char BlockCoder::getByte(int stream)
+{
+	if(at[stream] == end[stream])
+	{
+		bad = true;
+		return(0);
+	}
+	return(*at[stream]++);
+}
+
+// pack: splits the log bytes into literal runs and valid UBX frames, a
+//   frame cut by the end of the block is kept as literal bytes
+void BlockCoder::pack(const unsigned char * data, size_t length)
+{
+	size_t literal = 0;   // start of the current literal run
+	size_t i = 0;
+
+	while(i + UBX_OVERHEAD <= length)
+	{
+		size_t payloadLength = get2(data + i + 4);
+		unsigned char a, b;
+		if(data[i] != UBX_SYNC1 || data[i + 1] != UBX_SYNC2 || i + UBX_OVERHEAD + payloadLength > length)
+		{
+			i++;
+			continue;
+		}
+		checksum(data + i, payloadLength, a, b);
+		if(data[i + 6 + payloadLength] != a || data[i + 7 + payloadLength] != b)
+		{
+			i++;
+			continue;
+		}
+
+		if(literal < i)
+		{
+			streams[STREAM_RECORDS].push_back(RECORD_LITERAL);
+			putVarint(STREAM_LENGTHS, i - literal);
+			streams[STREAM_LITERALS].insert(streams[STREAM_LITERALS].end(), data + literal, data + i);
+		}
+
+		TypeState &type = typeState(data[i + 2], data[i + 3]);
+		streams[STREAM_RECORDS].push_back(RECORD_FRAME);
+		streams[STREAM_RECORDS].push_back(data[i + 2]);
+		streams[STREAM_RECORDS].push_back(data[i + 3]);
+		long long change = static_cast<long long>(payloadLength) - static_cast<long long>(type.length);
+		putVarint(STREAM_LENGTHS, (static_cast<unsigned long long>(change) << 1) ^ static_cast<unsigned long long>(change >> 63));
+		type.length = static_cast<unsigned long>(payloadLength);
+
+		// packing only reads the payload
+		codePayload(type, const_cast<unsigned char *>(data + i + 6), payloadLength);
+
+		i += UBX_OVERHEAD + payloadLength;
+		literal = i;
+	}
+
+	if(literal < length)
+	{
+		streams[STREAM_RECORDS].push_back(RECORD_LITERAL);
+		putVarint(STREAM_LENGTHS, length - literal);
+		streams[STREAM_LITERALS].insert(streams[STREAM_LITERALS].end(), data + literal, data + length);
+	}
+}
+
+// unpack: rebuilds length log bytes from the streams
+//   returns false if the streams do not make exactly that many bytes
+bool BlockCoder::unpack(unsigned char * out, size_t length)
+{
+	size_t n = 0;
+
+	while(n < length && !bad)
+	{
+		if(getByte(STREAM_RECORDS) == RECORD_LITERAL)
+		{
+			unsigned long long run = getVarint(STREAM_LENGTHS);
+			if(bad || run > length - n || run > static_cast<size_t>(end[STREAM_LITERALS] - at[STREAM_LITERALS]))
+				return(false);
+			memcpy(out + n, at[STREAM_LITERALS], static_cast<size_t>(run));
+			at[STREAM_LITERALS] += run;
+			n += static_cast<size_t>(run);
+			continue;
+		}
+
+		unsigned char msgClass = getByte(STREAM_RECORDS);
+		unsigned char msgId = getByte(STREAM_RECORDS);
+		TypeState &type = typeState(msgClass, msgId);
+		unsigned long long zigzag = getVarint(STREAM_LENGTHS);
+		unsigned long long payloadLength = type.length + ((zigzag >> 1) ^ (0 - (zigzag & 1)));
+		if(bad || payloadLength > 0xFFFF || payloadLength + UBX_OVERHEAD > length - n)
+			return(false);
+		type.length = static_cast<unsigned long>(payloadLength);
+
+		unsigned char * frame = out + n;
+		frame[0] = UBX_SYNC1;
+		frame[1] = UBX_SYNC2;
+		frame[2] = msgClass;
+		frame[3] = msgId;
+		frame[4] = static_cast<unsigned char>(payloadLength);
+		frame[5] = static_cast<unsigned char>(payloadLength >> 8);
+		codePayload(type, frame + 6, static_cast<size_t>(payloadLength));
+		checksum(frame, static_cast<size_t>(payloadLength), frame[6 + payloadLength], frame[7 + payloadLength]);
+		n += static_cast<size_t>(payloadLength) + UBX_OVERHEAD;
+	}
+
+	for(int s = 0; s < ARCHIVE_STREAMS; s++)
+	{
+		if(at[s] != end[s])
+			bad = true;
+	}
+	return(!bad && n == length);
+}
+
+// isArchive: checks the magic number
+bool isArchive(const unsigned char * magic)
+{
+	return(memcmp(magic, ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE) == 0);
+}
+
+// putStream: appends a stream, compressed if that makes it smaller
+static void putStream(const vector<unsigned char> &raw, vector<unsigned char> &block, int level)
+{
+	int method = ARCHIVE_STORED;
+	vector<unsigned char> coded;
+
+#if defined(UBX_ZSTD)
+	if(!raw.empty())
+	{
+		coded.resize(ZSTD_compressBound(raw.size()));
+		size_t size = ZSTD_compress(&coded[0], coded.size(), &raw[0], raw.size(), level);
+		if(!ZSTD_isError(size) && size < raw.size())
+		{
+			coded.resize(size);
+			method = ARCHIVE_ZSTD;
+		}
+	}
+#elif defined(UBX_ZLIB)
+	if(!raw.empty())
+	{
+		uLongf size = compressBound(static_cast<uLong>(raw.size()));
+		coded.resize(size);
+		if(compress2(&coded[0], &size, &raw[0], static_cast<uLong>(raw.size()), level < ARCHIVE_ZLIB_MAX ? level : ARCHIVE_ZLIB_MAX) == Z_OK &&
+		   size < raw.size())
+		{
+			coded.resize(size);
+			method = ARCHIVE_ZLIB;
+		}
+	}
+#else
+	(void)level;   // no compression compiled in, streams are stored
+#endif
+
+	const vector<unsigned char> &stored = method == ARCHIVE_STORED ? raw : coded;
+	block.push_back(static_cast<unsigned char>(method));
+	put4(block, static_cast<unsigned long>(raw.size()));
+	put4(block, static_cast<unsigned long>(stored.size()));
+	block.insert(block.end(), stored.begin(), stored.end());
+}
+
+// getStream: expands a stored stream into to
+//   returns false if it is damaged or its method is not compiled in
+static bool getStream(int method, const unsigned char * stored, size_t storedLength, vector<unsigned char> &to)
+{
+	if(to.empty())
+		return(false);   // empty streams are always stored
+#if !defined(UBX_ZLIB) && !defined(UBX_ZSTD)
+	(void)stored;        // no compression compiled in
+	(void)storedLength;
+#endif
+
+	switch(method)
+	{
+#ifdef UBX_ZLIB
+		case ARCHIVE_ZLIB:
+		{
+			uLongf size = static_cast<uLongf>(to.size());
+			return(uncompress(&to[0], &size, stored, static_cast<uLong>(storedLength)) == Z_OK && size == to.size());
+		}
+#endif
+#ifdef UBX_ZSTD
+		case ARCHIVE_ZSTD:
+		{
+			size_t size = ZSTD_decompress(&to[0], to.size(), stored, storedLength);
+			return(!ZSTD_isError(size) && size == to.size());
+		}
+#endif
+		default:
+			return(false);
+	}
+}
+
+// packBlock: codes the log bytes into streams and appends the block
+void packBlock(const unsigned char * data, size_t length, vector<unsigned char> &block, int level)
+{
+	BlockCoder coder(false);
+	coder.pack(data, length);
+
+	size_t start = block.size();
+	put4(block, 0);   // block length, set below
+	put4(block, static_cast<unsigned long>(length));
+	for(int s = 0; s < ARCHIVE_STREAMS; s++)
+		putStream(coder.streams[s], block, level);
+
+	unsigned long blockLength = static_cast<unsigned long>(block.size() - start - 4);
+	for(int b = 0; b < 4; b++)
+		block[start + b] = static_cast<unsigned char>(blockLength >> (8 * b));
+}
+
+// unpackBlock: expands the streams of a block and rebuilds its log bytes
+bool unpackBlock(const unsigned char * block, size_t length, vector<unsigned char> &out)
+{
+	if(length < BLOCK_HEADER)
+		return(false);
+	size_t logBytes = get4(block);
+	if(logBytes > ARCHIVE_MAX_BLOCK)
+		return(false);
+
+	BlockCoder coder(true);
+	// kept by each thread from block to block, so that their memory is not
+	// given back and faulted in again for every block
+	static thread_local vector<unsigned char> expanded[ARCHIVE_STREAMS];
+	size_t at = BLOCK_HEADER;
+	for(int s = 0; s < ARCHIVE_STREAMS; s++)
+	{
+		if(length - at < STREAM_HEADER)
+			return(false);
+		int method = block[at];
+		size_t codedLength  = get4(block + at + 1);
+		size_t storedLength = get4(block + at + 5);
+		at += STREAM_HEADER;
+		if(storedLength > length - at || codedLength > ARCHIVE_MAX_BLOCK)
+			return(false);
+
+		if(method == ARCHIVE_STORED)
+		{	// used in place
+			if(codedLength != storedLength)
+				return(false);
+			coder.at[s] = block + at;
+		}
+		else
+		{
+			expanded[s].resize(codedLength);
+			if(!getStream(method, block + at, storedLength, expanded[s]))
+				return(false);
+			coder.at[s] = expanded[s].empty() ? 0 : &expanded[s][0];
+		}
+		coder.end[s] = coder.at[s] + codedLength;
+		at += storedLength;
+	}
+	if(at != length)
+		return(false);
+
+	size_t used = out.size();
+	out.resize(used + logBytes);
+	if(logBytes > 0 && !coder.unpack(&out[used], logBytes))
+	{
+		out.resize(used);
+		return(false);
+	}
+	return(true);
+}
@@ -0,0 +1,73 @@
+//**************************************************************
+// UBX archive codec
+//   - this library packs receiver logs into a lossless archive
+//     format (.ubz) that is smaller than general compressors
+//     make of them, and unpacks it bit-exact.
+//   - the log is cut into blocks of ARCHIVE_BLOCK_SIZE bytes and
+//     each block is coded on its own, so blocks are packed and
+//     unpacked in parallel.
+//   - in a block, every UBX frame with a valid checksum is split
+//     into its fields.  A field is coded as the zigzag varint of
+//     its difference to a prediction from the previous messages
+//     of the same type (time tags: linear, other fields: last
+//     value).  RXM-RAWX and RXM-RAW pseudoranges and carrier
+//     phases are predicted per satellite from their last two
+//     epochs, Dopplers from their last epoch.  Sync bytes,
+//     length and checksum are rebuilt on unpacking.  All other
+//     bytes (NMEA, damaged frames) are kept as literals.
+//   - the coded fields are gathered in streams by kind, which
+//     are compressed with zstd (UBX_ZSTD) or else zlib (UBX_ZLIB)
+//     when available, or stored.
+//
+//   file:   ARCHIVE_MAGIC, blocks
+//   block:  U4 bytes of the block after this field
+//           U4 log bytes in the block
+//           ARCHIVE_STREAMS times:
+//             U1 method, U4 coded length, U4 stored length,
+//             stored bytes
+//   all numbers little endian.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBARCHIVE_H
+#define LIBARCHIVE_H
+
+// defined constants
+#define ARCHIVE_BLOCK_SIZE   (4 << 20)    // log bytes per block
+#define ARCHIVE_MAX_BLOCK    (64 << 20)   // larger blocks are taken as damage
+#define ARCHIVE_MAGIC_SIZE   4
+#define ARCHIVE_STREAMS      6
+#define ARCHIVE_LEVEL        12           // zstd 1 - 22, zlib takes at most 9
+#define ARCHIVE_ZLIB_MAX     9
+
+// stream methods
+#define ARCHIVE_STORED       0
+#define ARCHIVE_ZLIB         1
+#define ARCHIVE_ZSTD         2
+
+// included libraries
+#include <vector>
+
+using namespace std;
+
+// first bytes of an archive
+extern const unsigned char ARCHIVE_MAGIC[ARCHIVE_MAGIC_SIZE];
+
+// isArchive: true if the first ARCHIVE_MAGIC_SIZE bytes of a file are those of an archive
+bool isArchive(const unsigned char * magic);
+
+// packBlock: appends the block coding length (<= ARCHIVE_BLOCK_SIZE) log bytes
+//   level: compression level of the streams
+void packBlock(const unsigned char * data, size_t length, vector<unsigned char> &block, int level = ARCHIVE_LEVEL);
+
+// unpackBlock: appends the log bytes of a block, given without its first
+//   length field; returns false if the block is damaged or uses a method
+//   not compiled in
+bool unpackBlock(const unsigned char * block, size_t length, vector<unsigned char> &out);
+
+#endif  // LIBARCHIVE_H
@@ -0,0 +1,856 @@
+//**************************************************************
+// Log input
+//   - this file implements the read-ahead stream buffer and
+//     the gzip/zstd decompression of receiver logs.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <cstring>
+#include "LibInput.h"
+#include "LibArchive.h"
+#include "LibLatency.h"
+#include "LibTrace.h"
+
+#ifdef UBX_ZLIB
+#include <zlib.h>
+#endif
+#ifdef UBX_ZSTD
+#include <zstd.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+#include <chrono>
+
+using namespace std;
+
+// piece states
+#define PIECE_PENDING   0   // waiting for or being decompressed by a worker
+#define PIECE_DONE      1   // output ready
+#define PIECE_FAILED    2   // damaged input, output ends before this piece
+
+// format magic numbers
+#define GZIP_ID1        0x1f
+#define GZIP_ID2        0x8b
+#define GZIP_DEFLATE    8
+#define GZIP_FEXTRA     0x04
+#define GZIP_HEADER     12          // bytes up to and including XLEN
+#define ZSTD_MAGIC      0xFD2FB528UL
+#define ZSTD_SKIPPABLE  0x184D2A50UL   // low four bits are free
+
+// little endian readers
+static inline unsigned long get2(const unsigned char * p)
+{
+	return(p[0] | (static_cast<unsigned long>(p[1]) << 8));
+}
+
+static inline unsigned long get3(const unsigned char * p)
+{
+	return(get2(p) | (static_cast<unsigned long>(p[2]) << 16));
+}
+
+static inline unsigned long get4(const unsigned char * p)
+{
+	return(get3(p) | (static_cast<unsigned long>(p[3]) << 24));
+}
+
+// LogInputBuf: default constructor
+LogInputBuf::LogInputBuf()
+{
+	logFormat = INPUT_PLAIN;
+	damaged = false;
+	maxPieces = 1;
+	delivered = 0;
+	following = false;
+	followIdleMs = 0;
+	watch = -1;
+	ended = false;
+	stopping = false;
+	current = 0;
+}
+
+// ~LogInputBuf: destructor
+LogInputBuf::~LogInputBuf(void)
+{
+	close();
+}
+
+// open: opens a log and starts reading ahead
+//   returns INPUT_OK, INPUT_NO_FILE or INPUT_UNSUPPORTED
+int LogInputBuf::open(const string &fname, unsigned int threads, long long start)
+{
+	close();
+
+	file.open(fname.c_str(), ios::in | ios::binary);
+	if(!file.is_open())
+		return(INPUT_NO_FILE);
+	fileName = fname;
+
+	// the first bytes of a file tell the format, a UBX or NMEA log never
+	// starts with them; a device (no position) is a live plain stream
+	unsigned char magic[4] = { 0, 0, 0, 0 };
+	if(file.tellg() != streampos(-1))
+	{
+		file.read(reinterpret_cast<char *>(magic), sizeof(magic));
+		file.clear();
+		file.seekg(0);
+	}
+
+	logFormat = INPUT_PLAIN;
+	if(magic[0] == GZIP_ID1 && magic[1] == GZIP_ID2)
+		logFormat = INPUT_GZIP;
+	else if(get4(magic) == ZSTD_MAGIC)
+		logFormat = INPUT_ZSTD;
+	else if(isArchive(magic))
+		logFormat = INPUT_ARCHIVE;
+
+#ifndef UBX_ZLIB
+	if(logFormat == INPUT_GZIP)
+	{
+		file.close();
+		return(INPUT_UNSUPPORTED);
+	}
+#endif
+#ifndef UBX_ZSTD
+	if(logFormat == INPUT_ZSTD)
+	{
+		file.close();
+		return(INPUT_UNSUPPORTED);
+	}
+#endif
+
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+	maxPieces = threads * INPUT_PIECES_PER_THREAD;
+
+	delivered = 0;
+	if(logFormat == INPUT_PLAIN && start > 0)
+	{
+		file.seekg(start);
+		delivered = start;
+	}
+
+#ifdef __linux__
+	// watching from before the first read, so no append can be missed
+	if(following && logFormat == INPUT_PLAIN)
+	{
+		watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if(watch >= 0 && inotify_add_watch(watch, fname.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF) < 0)
+		{
+			::close(watch);
+			watch = -1;
+		}
+	}
+#endif
+
+	damaged = false;
+	ended = false;
+	stopping = false;
+	setg(0, 0, 0);
+
+	reader = thread(&LogInputBuf::read, this);
+	if(logFormat != INPUT_PLAIN)
+	{
+		for(unsigned int t = 0; t < threads; t++)
+			workers.push_back(thread(&LogInputBuf::decompress, this));
+	}
+
+	return(INPUT_OK);
+}
+
+// open: reads a plain log from memory, without an I/O thread
+//   returns INPUT_OK
+int LogInputBuf::open(const unsigned char * data, size_t length)
+{
+	close();
+
+	fileName.clear();
+	logFormat = INPUT_PLAIN;
+	delivered = 0;
+	damaged = false;
+	ended = true;           // nothing is queued, underflow ends the stream
+	stopping = false;
+
+	unsigned char * begin = const_cast<unsigned char *>(data);   // never written
+	setg(begin, begin, begin + length);
+	arrivals.push_back(make_pair(0LL, latencyClock()));
+
+	return(INPUT_OK);
+}
+
+// close: stops the threads and closes the log
+void LogInputBuf::close(void)
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	changed.notify_all();
+
+	if(reader.joinable())
+		reader.join();
+	for(unsigned int t = 0; t < workers.size(); t++)
+		workers[t].join();
+	workers.clear();
+
+	// every queued piece is in pieces, work only refers to some of them
+	for(unsigned int p = 0; p < pieces.size(); p++)
+		delete pieces[p];
+	pieces.clear();
+	work.clear();
+	delete current;
+	current = 0;
+	setg(0, 0, 0);
+	arrivals.clear();
+
+	if(file.is_open())
+		file.close();
+#ifdef __linux__
+	if(watch >= 0)
+		::close(watch);
+#endif
+	watch = -1;
+}
+
+// offset: bytes of the log before the next byte the parser reads
+long long LogInputBuf::offset(void) const
+{
+	return(delivered + (gptr() - eback()));
+}
+
+// arrival: latencyClock() time the piece holding the byte at offset at
+//   was read from the log, 0 if not known; at may not go back between
+//   calls, the pieces before it are forgotten
+long long LogInputBuf::arrival(long long at)
+{
+	while(arrivals.size() > 1 && arrivals[1].first <= at)
+		arrivals.pop_front();
+
+	return(arrivals.empty() ? 0 : arrivals.front().second);
+}
+
+// underflow: moves the next piece in file order into the get area
+LogInputBuf::int_type LogInputBuf::underflow(void)
+{
+	if(gptr() < egptr())
+		return(traits_type::to_int_type(*gptr()));
+
+	TRACE_SPAN("input", "refill");   // waits for the reader or a worker
+	unique_lock<mutex> guard(lock);
+
+	delivered += egptr() - eback();   // the piece, or the log in memory
+	delete current;
+	current = 0;
+	setg(0, 0, 0);
+
+	while(!damaged)
+	{
+		changed.wait(guard, [this] {
+			return(stopping || (pieces.empty() && ended) ||
+			       (!pieces.empty() && pieces.front()->state != PIECE_PENDING));
+		});
+		if(stopping || pieces.empty())
+			break;
+
+		Piece * piece = pieces.front();
+		pieces.pop_front();
+		changed.notify_all();   // room for the reader
+
+		if(piece->state == PIECE_FAILED)
+			damaged = true;
+		else if(!piece->out.empty())
+		{
+			current = piece;
+			setg(&piece->out[0], &piece->out[0], &piece->out[0] + piece->out.size());
+			arrivals.push_back(make_pair(delivered, piece->arrival));
+			return(traits_type::to_int_type(*gptr()));
+		}
+		delete piece;
+	}
+
+	return(traits_type::eof());
+}
+
+// read: I/O thread, queues the pieces of the log in file order
+void LogInputBuf::read(void)
+{
+	bool ok = true;
+
+	switch(logFormat)
+	{
+		case INPUT_PLAIN: ok = readPlain(); break;
+		case INPUT_GZIP:  ok = readGzip();  break;
+		case INPUT_ZSTD:  ok = readZstd();  break;
+		case INPUT_ARCHIVE: ok = readArchive(); break;
+	}
+
+	if(!ok)
+	{	// the parser stops where the damage starts
+		Piece * piece = new Piece;
+		piece->state = PIECE_FAILED;
+		queue(piece);
+	}
+
+	{
+		lock_guard<mutex> guard(lock);
+		ended = true;
+	}
+	changed.notify_all();
+}
+
+// decompress: worker thread, decompresses (unpacks) the pieces of a block log
+void LogInputBuf::decompress(void)
+{
+	while(true)
+	{
+		Piece * piece;
+		{
+			unique_lock<mutex> guard(lock);
+			changed.wait(guard, [this] { return(stopping || !work.empty()); });
+			if(stopping)
+				return;
+			piece = work.front();
+			work.pop_front();
+		}
+
+		bool ok = false;
+		{
+			TRACE_SPAN("input", "decompress");
+			switch(logFormat)
+			{
+				case INPUT_GZIP:    ok = inflatePiece(*piece); break;
+				case INPUT_ZSTD:    ok = zstdPiece(*piece);    break;
+				case INPUT_ARCHIVE: ok = archivePiece(*piece); break;
+			}
+		}
+		vector<unsigned char>().swap(piece->in);   // compressed bytes no longer needed
+
+		{
+			lock_guard<mutex> guard(lock);
+			piece->state = ok ? PIECE_DONE : PIECE_FAILED;
+		}
+		changed.notify_all();
+	}
+}
+
+// queue: adds a piece behind the others, waiting while too many are in flight
+//   returns false if the buffer is closing (the piece is deleted)
+bool LogInputBuf::queue(Piece * piece)
+{
+	piece->arrival = latencyClock();   // its bytes were just read
+
+	{
+		unique_lock<mutex> guard(lock);
+		changed.wait(guard, [this] { return(stopping || pieces.size() < maxPieces); });
+		if(stopping)
+		{
+			delete piece;
+			return(false);
+		}
+		pieces.push_back(piece);
+		if(piece->state == PIECE_PENDING)
+			work.push_back(piece);
+	}
+	changed.notify_all();
+	return(true);
+}
+
+// finished: a piece holding out as its output, out is left empty
+LogInputBuf::Piece * LogInputBuf::finished(vector<unsigned char> &out)
+{
+	Piece * piece = new Piece;
+	piece->out.swap(out);
+	piece->state = PIECE_DONE;
+	return(piece);
+}
+
+// readBytes: appends length bytes of the log to a buffer
+//   returns false if the log ends first
+bool LogInputBuf::readBytes(vector<unsigned char> &to, size_t length)
+{
+	size_t used = to.size();
+	to.resize(used + length);
+	if(length == 0)
+		return(true);
+	TRACE_SPAN("input", "read");
+	file.read(reinterpret_cast<char *>(&to[used]), length);
+	return(static_cast<size_t>(file.gcount()) == length);
+}
+
+// readPlain: queues the log in chunks
+//   waits for one byte, then takes what is available without waiting, so
+//   that a live stream (serial port, pty) is passed on as it arrives; a
+//   read error (closed device) ends the log like its end.  A followed log
+//   ends only when waitAppend gives up.
+bool LogInputBuf::readPlain(void)
+{
+	vector<unsigned char> chunk;
+
+	while(true)
+	{
+		chunk.resize(INPUT_CHUNK_SIZE);
+		char * data = reinterpret_cast<char *>(&chunk[0]);
+		file.read(data, 1);
+		if(file.gcount() == 0)
+		{
+			if(!following || file.bad() || !waitAppend())
+				return(true);
+			file.clear();
+			continue;
+		}
+
+		size_t used = 1;
+		while(used < chunk.size())
+		{
+			streamsize n = file.readsome(data + used, chunk.size() - used);
+			if(n <= 0)
+				break;
+			used += static_cast<size_t>(n);
+		}
+		chunk.resize(used);
+
+		if(!queue(finished(chunk)))
+			return(true);
+	}
+}
+
+// waitAppend: waits at the end of a followed log until it grows
+//   returns false when the log stopped growing for followIdleMs, was
+//   deleted or moved, or the buffer is closing
+bool LogInputBuf::waitAppend(void)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	while(true)
+	{
+		{
+			lock_guard<mutex> guard(lock);
+			if(stopping)
+				return(false);
+		}
+		if(followIdleMs > 0 && chrono::steady_clock::now() - start >= chrono::milliseconds(followIdleMs))
+			return(false);
+
+#ifdef __linux__
+		if(watch >= 0)
+		{
+			pollfd fd;
+			fd.fd = watch;
+			fd.events = POLLIN;
+			fd.revents = 0;
+			if(poll(&fd, 1, INPUT_FOLLOW_TICK_MS) <= 0)
+				continue;
+
+			// a burst of writes queues several events, one read takes them all
+			alignas(inotify_event) char events[4096];
+			ssize_t n = ::read(watch, events, sizeof(events));
+			for(ssize_t at = 0; at + static_cast<ssize_t>(sizeof(inotify_event)) <= n; )
+			{
+				const inotify_event * event = reinterpret_cast<const inotify_event *>(events + at);
+				if(event->mask & IN_MOVE_SELF)
+					return(false);
+				if((event->mask & IN_ATTRIB) && access(fileName.c_str(), F_OK) != 0)
+					return(false);   // unlinked, it is only deleted when closed
+				at += sizeof(inotify_event) + event->len;
+			}
+			return(true);
+		}
+#endif
+		// no inotify, look again after a tick
+		this_thread::sleep_for(chrono::milliseconds(INPUT_FOLLOW_TICK_MS));
+		file.clear();
+		if(file.peek() != char_traits<char>::eof())
+			return(true);
+	}
+}
+
+// readGzip: queues each BGZF block for a worker; from the first gzip
+//   member without a BGZF block size on, the log is inflated as a stream
+bool LogInputBuf::readGzip(void)
+{
+	while(true)
+	{
+		long long start = file.tellg();
+		if(file.peek() == char_traits<char>::eof())
+			return(true);
+
+		Piece * piece = new Piece;
+		piece->state = PIECE_PENDING;
+		vector<unsigned char> &in = piece->in;
+		if(!readBytes(in, GZIP_HEADER) || in[0] != GZIP_ID1 || in[1] != GZIP_ID2 || in[2] != GZIP_DEFLATE)
+		{
+			delete piece;
+			return(false);
+		}
+
+		// BGZF: an extra subfield 'B','C' holds the block size - 1
+		unsigned long blockSize = 0;
+		if(in[3] & GZIP_FEXTRA)
+		{
+			unsigned long extraLength = get2(&in[10]);
+			if(!readBytes(in, extraLength))
+			{
+				delete piece;
+				return(false);
+			}
+			for(unsigned long s = GZIP_HEADER; s + 4 <= in.size(); s += 4 + get2(&in[s + 2]))
+			{
+				if(in[s] == 'B' && in[s + 1] == 'C' && get2(&in[s + 2]) == 2 && s + 6 <= in.size())
+					blockSize = get2(&in[s + 4]) + 1;
+			}
+		}
+
+		if(blockSize < in.size())
+		{	// not a BGZF block
+			delete piece;
+			return(streamGzip(start));
+		}
+
+		if(!readBytes(in, blockSize - in.size()))
+		{
+			delete piece;
+			return(false);
+		}
+		if(!queue(piece))
+			return(true);
+	}
+}
+
+// readZstd: queues each zstd frame for a worker; from the first frame
+//   larger than INPUT_MAX_FRAME on, the log is decompressed as a stream
+bool LogInputBuf::readZstd(void)
+{
+	static const int dictionaryBytes[4] = { 0, 1, 2, 4 };
+
+	while(true)
+	{
+		long long start = file.tellg();
+		if(file.peek() == char_traits<char>::eof())
+			return(true);
+
+		Piece * piece = new Piece;
+		piece->state = PIECE_PENDING;
+		vector<unsigned char> &in = piece->in;
+		if(!readBytes(in, 4))
+		{
+			delete piece;
+			return(false);
+		}
+
+		unsigned long magic = get4(&in[0]);
+		if((magic & 0xFFFFFFF0UL) == ZSTD_SKIPPABLE)
+		{	// skippable frame, no output
+			bool ok = readBytes(in, 4) && readBytes(in, get4(&in[4]));
+			delete piece;
+			if(!ok)
+				return(false);
+			continue;
+		}
+		if(magic != ZSTD_MAGIC || !readBytes(in, 1))
+		{
+			delete piece;
+			return(false);
+		}
+
+		// frame header: window, dictionary ID and content size fields
+		unsigned char descriptor = in[4];
+		int contentSizeFlag = descriptor >> 6;
+		bool singleSegment  = (descriptor & 0x20) != 0;
+		bool checksum       = (descriptor & 0x04) != 0;
+		size_t headerBytes = (singleSegment ? 0 : 1) + dictionaryBytes[descriptor & 0x03] +
+			(contentSizeFlag == 0 ? (singleSegment ? 1 : 0) : (1 << contentSizeFlag));
+		bool ok = readBytes(in, headerBytes);
+
+		// blocks, each with a 3 byte header: last flag, type, size
+		bool last = false;
+		while(ok && !last)
+		{
+			size_t at = in.size();
+			ok = readBytes(in, 3);
+			if(!ok)
+				break;
+			unsigned long block = get3(&in[at]);
+			int type = (block >> 1) & 0x03;
+			last = (block & 0x01) != 0;
+			ok = type != 3 && readBytes(in, type == 1 ? 1 : (block >> 3));   // RLE blocks hold one byte
+
+			if(in.size() > INPUT_MAX_FRAME)
+			{	// one long frame, decompress it and the rest while reading
+				delete piece;
+				return(streamZstd(start));
+			}
+		}
+		if(ok && checksum)
+			ok = readBytes(in, 4);
+
+		if(!ok)
+		{
+			delete piece;
+			return(false);
+		}
+		if(!queue(piece))
+			return(true);
+	}
+}
+
+// readArchive: queues each archive block for a worker
+bool LogInputBuf::readArchive(void)
+{
+	vector<unsigned char> magic;
+	if(!readBytes(magic, ARCHIVE_MAGIC_SIZE))
+		return(false);
+
+	while(true)
+	{
+		if(file.peek() == char_traits<char>::eof())
+			return(true);
+
+		Piece * piece = new Piece;
+		piece->state = PIECE_PENDING;
+		vector<unsigned char> &in = piece->in;
+		bool ok = readBytes(in, 4);
+		if(ok)
+		{	// the length field is not part of the block
+			unsigned long blockLength = get4(&in[0]);
+			in.clear();
+			ok = blockLength <= ARCHIVE_MAX_BLOCK && readBytes(in, blockLength);
+		}
+
+		if(!ok)
+		{
+			delete piece;
+			return(false);
+		}
+		if(!queue(piece))
+			return(true);
+	}
+}
+
+// archivePiece: unpacks one archive block
+bool LogInputBuf::archivePiece(Piece &piece)
+{
+	return(!piece.in.empty() && unpackBlock(&piece.in[0], piece.in.size(), piece.out));
+}
+
+#ifdef UBX_ZLIB
+
+// inflatePiece: inflates one BGZF block, its trailer gives the output size
+bool LogInputBuf::inflatePiece(Piece &piece)
+{
+	if(piece.in.size() < 8)
+		return(false);
+	piece.out.resize(get4(&piece.in[piece.in.size() - 4]));
+
+	z_stream z;
+	memset(&z, 0, sizeof(z));
+	if(inflateInit2(&z, 16 + MAX_WBITS) != Z_OK)   // gzip wrapper
+		return(false);
+
+	unsigned char empty;
+	z.next_in   = &piece.in[0];
+	z.avail_in  = static_cast<uInt>(piece.in.size());
+	z.next_out  = piece.out.empty() ? &empty : &piece.out[0];
+	z.avail_out = static_cast<uInt>(piece.out.size());
+	int res = inflate(&z, Z_FINISH);
+	inflateEnd(&z);
+
+	return(res == Z_STREAM_END && z.avail_out == 0);
+}
+
+// streamGzip: inflates the log from offset on as one stream of gzip members
+bool LogInputBuf::streamGzip(long long offset)
+{
+	vector<unsigned char> in(INPUT_CHUNK_SIZE);
+	vector<unsigned char> out;
+	bool inMember = false;   // a member is started but not finished
+
+	file.clear();
+	file.seekg(offset);
+
+	z_stream z;
+	memset(&z, 0, sizeof(z));
+	if(inflateInit2(&z, 16 + MAX_WBITS) != Z_OK)
+		return(false);
+
+	bool ok = true;
+	bool more = true;
+	while(ok && more)
+	{
+		out.resize(INPUT_CHUNK_SIZE);
+		z.next_out  = &out[0];
+		z.avail_out = static_cast<uInt>(out.size());
+
+		while(z.avail_out > 0)
+		{
+			if(z.avail_in == 0)
+			{
+				file.read(reinterpret_cast<char *>(&in[0]), in.size());
+				z.next_in  = &in[0];
+				z.avail_in = static_cast<uInt>(file.gcount());
+				if(z.avail_in == 0)
+				{	// end of log, which must also end a member
+					ok = !inMember && !file.bad();
+					more = false;
+					break;
+				}
+			}
+
+			inMember = true;
+			int res;
+			{
+				TRACE_SPAN("input", "inflate");
+				res = inflate(&z, Z_NO_FLUSH);
+			}
+			if(res == Z_STREAM_END)
+			{	// another member may follow
+				inMember = false;
+				inflateReset(&z);
+			}
+			else if(res != Z_OK && res != Z_BUF_ERROR)
+			{
+				ok = false;
+				break;
+			}
+		}
+
+		out.resize(out.size() - z.avail_out);
+		if(!out.empty() && !queue(finished(out)))
+			break;
+	}
+
+	inflateEnd(&z);
+	return(ok);
+}
+
+#else  // UBX_ZLIB
+
+bool LogInputBuf::inflatePiece(Piece & /*piece*/)
+{
+	return(false);
+}
+
+bool LogInputBuf::streamGzip(long long /*offset*/)
+{
+	return(false);
+}
+
+#endif // UBX_ZLIB
+
+#ifdef UBX_ZSTD
+
+// zstdPiece: decompresses one zstd frame
+bool LogInputBuf::zstdPiece(Piece &piece)
+{
+	unsigned long long size = ZSTD_getFrameContentSize(&piece.in[0], piece.in.size());
+	if(size == ZSTD_CONTENTSIZE_ERROR)
+		return(false);
+
+	if(size != ZSTD_CONTENTSIZE_UNKNOWN)
+	{	// size in the header, decompress in one call
+		piece.out.resize(static_cast<size_t>(size));
+		unsigned char empty;
+		size_t res = ZSTD_decompress(piece.out.empty() ? &empty : &piece.out[0], piece.out.size(),
+			&piece.in[0], piece.in.size());
+		return(!ZSTD_isError(res) && res == size);
+	}
+
+	// size not recorded, grow the output as the frame is decompressed
+	ZSTD_DCtx * context = ZSTD_createDCtx();
+	if(context == 0)
+		return(false);
+
+	ZSTD_inBuffer input = { &piece.in[0], piece.in.size(), 0 };
+	size_t res = 1;
+	while(res != 0)
+	{
+		size_t used = piece.out.size();
+		piece.out.resize(used + INPUT_CHUNK_SIZE);
+		ZSTD_outBuffer output = { &piece.out[used], INPUT_CHUNK_SIZE, 0 };
+		res = ZSTD_decompressStream(context, &output, &input);
+		piece.out.resize(used + output.pos);
+		if(ZSTD_isError(res) || (res != 0 && input.pos == input.size && output.pos < output.size))
+			break;   // damaged or truncated
+	}
+	ZSTD_freeDCtx(context);
+
+	return(res == 0);
+}
+
+// streamZstd: decompresses the log from offset on as one stream of frames
+bool LogInputBuf::streamZstd(long long offset)
+{
+	vector<unsigned char> in(INPUT_CHUNK_SIZE);
+	vector<unsigned char> out;
+
+	file.clear();
+	file.seekg(offset);
+
+	ZSTD_DCtx * context = ZSTD_createDCtx();
+	if(context == 0)
+		return(false);
+
+	ZSTD_inBuffer input = { &in[0], 0, 0 };
+	size_t res = 0;   // 0 => between frames
+	bool ok = true;
+	bool more = true;
+	while(ok && more)
+	{
+		out.resize(INPUT_CHUNK_SIZE);
+		ZSTD_outBuffer output = { &out[0], out.size(), 0 };
+
+		while(output.pos < output.size)
+		{
+			if(input.pos == input.size)
+			{
+				file.read(reinterpret_cast<char *>(&in[0]), in.size());
+				input.size = static_cast<size_t>(file.gcount());
+				input.pos  = 0;
+				if(input.size == 0)
+				{	// end of log, which must also end a frame
+					ok = res == 0 && !file.bad();
+					more = false;
+					break;
+				}
+			}
+
+			res = ZSTD_decompressStream(context, &output, &input);
+			if(ZSTD_isError(res))
+			{
+				ok = false;
+				break;
+			}
+		}
+
+		out.resize(output.pos);
+		if(!out.empty() && !queue(finished(out)))
+			break;
+	}
+
+	ZSTD_freeDCtx(context);
+	return(ok);
+}
+
+#else  // UBX_ZSTD
+
+bool LogInputBuf::zstdPiece(Piece & /*piece*/)
+{
+	return(false);
+}
+
+bool LogInputBuf::streamZstd(long long /*offset*/)
+{
+	return(false);
+}
+
+#endif // UBX_ZSTD
@@ -0,0 +1,147 @@
+//**************************************************************
+// Log input
+//   - this library reads a receiver log, plain or compressed,
+//     for UBXParser through a stream buffer.  An I/O thread
+//     reads ahead of the parser; compressed logs are
+//     decompressed as they are read, never to disk.
+//   - gzip logs made of BGZF blocks and zstd logs made of
+//     several frames are split at the block/frame boundaries
+//     and the pieces decompressed on worker threads; the
+//     parser receives the output in file order.  Any other
+//     gzip or zstd log (one long stream) is decompressed by
+//     the I/O thread.
+//   - .ubz archives (LibArchive.h) are unpacked the same way,
+//     a block per piece.
+//   - a plain log that is still being written can be followed:
+//     at its end the I/O thread waits for appends (inotify on
+//     Linux, polling elsewhere) instead of ending the stream.
+//   - the time each piece was read is kept, so that the parser
+//     dates a frame (LibLatency.h) before the read-ahead queue.
+//   - the format is taken from the first bytes of the file.
+//     gzip needs UBX_ZLIB (zlib) and zstd needs UBX_ZSTD
+//     (libzstd) defined; plain logs need neither.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBINPUT_H
+#define LIBINPUT_H
+
+// defined constants
+#define INPUT_CHUNK_SIZE     (1 << 20)    // bytes read or decompressed per piece in stream mode
+#define INPUT_MAX_FRAME      (64 << 20)   // larger zstd frames are decompressed as a stream
+#define INPUT_PIECES_PER_THREAD  4        // pieces in flight per worker thread
+#define INPUT_FOLLOW_TICK_MS 200          // longest wait between checks for appends
+
+// log formats
+#define INPUT_PLAIN          0
+#define INPUT_GZIP           1
+#define INPUT_ZSTD           2
+#define INPUT_ARCHIVE        3
+
+// open results
+#define INPUT_OK             0
+#define INPUT_NO_FILE        1            // cannot open the file
+#define INPUT_UNSUPPORTED    2            // compressed, support not compiled in
+
+// included libraries
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+using namespace std;
+
+// definition of LogInputBuf class
+class LogInputBuf : public basic_streambuf<unsigned char>
+{
+	public:
+		// constructors
+		LogInputBuf();
+
+		// destructor
+		~LogInputBuf(void);
+
+		// methods
+		// threads: 0 => one per hardware thread
+		// start: offset to start reading a plain log at
+		int  open(const string &fname, unsigned int threads = 0, long long start = 0);
+		// a plain log already in memory, read in place (no I/O thread);
+		// data must stay valid until close
+		int  open(const unsigned char * data, size_t length);
+		void close(void);
+		bool is_open(void) const { return(file.is_open()); }
+		int  format(void) const { return(logFormat); }
+		bool failed(void) const { return(damaged); }   // compressed data damaged, output ended early
+		long long offset(void) const;                  // offset of the next byte in the (uncompressed) log
+		long long arrival(long long at);               // latencyClock() time the byte at offset at was read
+
+		// follow a growing plain log, set before open
+		//   idleMs: end the stream after the log stopped growing that long, 0 => never
+		void follow(bool on, unsigned int idleMs = 0) { following = on; followIdleMs = idleMs; }
+
+	protected:
+		int_type underflow(void);
+
+	private:
+		struct Piece {
+			vector<unsigned char> in;    // compressed block or frame, archive block
+			vector<unsigned char> out;   // bytes for the parser
+			int state;                   // PIECE_* in LibInput.cpp
+			long long arrival;           // latencyClock() when read from the log
+		};
+
+		LogInputBuf(const LogInputBuf &);   // not copyable
+		LogInputBuf & operator=(const LogInputBuf &);
+
+		ifstream file;
+		string fileName;
+		int logFormat;
+		bool damaged;
+		unsigned int maxPieces;
+		long long delivered;            // log bytes before the get area
+
+		bool following;
+		unsigned int followIdleMs;
+		int watch;                      // inotify descriptor, -1 if none
+
+		thread reader;
+		vector<thread> workers;
+		mutex lock;
+		condition_variable changed;     // a piece was queued, finished or taken
+		deque<Piece *> pieces;          // in file order, front is consumed next
+		deque<Piece *> work;            // pieces waiting for a worker
+		bool ended;                     // reader queued its last piece
+		bool stopping;
+		Piece * current;                // piece in the get area
+		deque< pair<long long, long long> > arrivals;   // start offset and arrival of the pieces delivered
+
+		// methods
+		void read(void);                // I/O thread
+		void decompress(void);          // worker thread
+		bool queue(Piece * piece);      // false => stopping
+		Piece * finished(vector<unsigned char> &out);
+
+		bool readPlain(void);
+		bool readGzip(void);
+		bool readZstd(void);
+		bool readArchive(void);
+		bool streamGzip(long long offset);
+		bool streamZstd(long long offset);
+		bool readBytes(vector<unsigned char> &to, size_t length);
+		bool waitAppend(void);
+		static bool inflatePiece(Piece &piece);
+		static bool zstdPiece(Piece &piece);
+		static bool archivePiece(Piece &piece);
+};
+
+#endif  // LIBINPUT_H
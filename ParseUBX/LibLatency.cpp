@@ -0,0 +1,231 @@
+//**************************************************************
+// Latency histograms
+//   - this file implements the log-linear latency histograms
+//     and the interval exporter thread.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <iomanip>
+#include <sstream>
+#include "LibLatency.h"
+
+using namespace std;
+
+#define LATENCY_HALF  (1 << (LATENCY_SUB_BITS - 1))   // buckets per power of two
+
+// latencyStats: histograms shared by all parsers of the program
+LatencyStats & latencyStats(void)
+{
+	static LatencyStats stats;
+	return(stats);
+}
+
+// percentile: highest ns of the bucket holding the p-th percentile
+long long LatencyCounts::percentile(double p) const
+{
+	if(total == 0)
+		return(0);
+
+	unsigned long long rank = static_cast<unsigned long long>(p / 100.0 * total + 0.999999);
+	if(rank < 1)
+		rank = 1;
+	if(rank > total)
+		rank = total;
+
+	unsigned long long seen = 0;
+	for(int b = 0; b < LATENCY_BUCKETS; b++)
+	{
+		seen += buckets[b];
+		if(seen >= rank)
+			return(LatencyHistogram::bucketValue(b));
+	}
+	return(LatencyHistogram::bucketValue(LATENCY_BUCKETS - 1));
+}
+
+// maximum: highest ns of the highest non-empty bucket
+long long LatencyCounts::maximum(void) const
+{
+	for(int b = LATENCY_BUCKETS - 1; b >= 0; b--)
+		if(buckets[b] != 0)
+			return(LatencyHistogram::bucketValue(b));
+	return(0);
+}
+
+// subtract: leaves the counts recorded after earlier
+void LatencyCounts::subtract(const LatencyCounts &earlier)
+{
+	total -= earlier.total;
+	for(int b = 0; b < LATENCY_BUCKETS; b++)
+		buckets[b] -= earlier.buckets[b];
+}
+
+
+// LatencyHistogram: default constructor
+LatencyHistogram::LatencyHistogram()
+{
+	for(int b = 0; b < LATENCY_BUCKETS; b++)
+		counts[b].store(0);
+}
+
+// snapshot: copies the bucket counts
+void LatencyHistogram::snapshot(LatencyCounts &out) const
+{
+	out.total = 0;
+	for(int b = 0; b < LATENCY_BUCKETS; b++)
+	{
+		out.buckets[b] = counts[b].load(memory_order_relaxed);
+		out.total += out.buckets[b];
+	}
+}
+
+// bucketOf: bucket of a latency, values beyond the range go to the last one
+//   below 2^LATENCY_SUB_BITS ns every ns has its own bucket, above it the
+//   top LATENCY_SUB_BITS bits of the value select the bucket
+int LatencyHistogram::bucketOf(long long ns)
+{
+	if(ns < (1 << LATENCY_SUB_BITS))
+		return(ns < 0 ? 0 : static_cast<int>(ns));
+
+	int shift = 1;   // ns >> shift lies in [LATENCY_HALF, 2*LATENCY_HALF)
+	while((ns >> shift) >= (1 << LATENCY_SUB_BITS))
+		shift++;
+	if(shift >= LATENCY_MAGNITUDES)
+		return(LATENCY_BUCKETS - 1);
+
+	return((1 << LATENCY_SUB_BITS) + (shift - 1) * LATENCY_HALF + static_cast<int>(ns >> shift) - LATENCY_HALF);
+}
+
+// bucketValue: highest latency (ns) counted in a bucket
+long long LatencyHistogram::bucketValue(int bucket)
+{
+	if(bucket < (1 << LATENCY_SUB_BITS))
+		return(bucket);
+
+	int shift = (bucket - (1 << LATENCY_SUB_BITS)) / LATENCY_HALF + 1;
+	long long sub = (bucket - (1 << LATENCY_SUB_BITS)) % LATENCY_HALF + LATENCY_HALF;
+	return(((sub + 1) << shift) - 1);
+}
+
+
+// stageName: name of a pipeline stage
+string LatencyStats::stageName(int stage)
+{
+	switch(stage)
+	{
+		case LATENCY_FRAMED:  return("framed");
+		case LATENCY_DECODED: return("decoded");
+		case LATENCY_OUTPUT:  return("output");
+		case LATENCY_FIX:     return("fix");
+	}
+	return("unknown");
+}
+
+
+// LatencyExporter: default constructor
+LatencyExporter::LatencyExporter()
+{
+	running = false;
+	intervalMs = LATENCY_EXPORT_MS;
+}
+
+// ~LatencyExporter: destructor
+LatencyExporter::~LatencyExporter(void)
+{
+	stop();
+}
+
+// start: writes the latencies of each interval to fname every intervalMs
+//   until stop(), then the totals since start
+//   returns 0 on success, 1 if the file cannot be opened
+int LatencyExporter::start(const string &fname, unsigned int interval)
+{
+	stop();
+
+	out.open(fname.c_str(), ios::out | ios::trunc);
+	if(!out.is_open())
+		return(1);
+	out << "interval(s),type,stage,count,p50(us),p99(us),p99.9(us),max(us)" << endl;
+
+	// counts so far are not part of this export
+	first.resize(STATS_NUM_TYPES * LATENCY_NUM_STAGES);
+	for(int t = 0; t < STATS_NUM_TYPES; t++)
+		for(int s = 0; s < LATENCY_NUM_STAGES; s++)
+			latencyStats().snapshot(t, s, first[t * LATENCY_NUM_STAGES + s]);
+	previous = first;
+
+	intervalMs = interval > 0 ? interval : 1;
+	running = true;
+	exporter = thread(&LatencyExporter::run, this);
+	return(0);
+}
+
+// stop: exports the last interval and the totals, closes the file
+void LatencyExporter::stop(void)
+{
+	if(!exporter.joinable())
+		return;
+
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_one();
+	exporter.join();
+
+	exportCounts("total", first);
+	out.close();
+}
+
+// run: exporter thread
+void LatencyExporter::run(void)
+{
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	chrono::steady_clock::time_point next = begin;
+	unique_lock<mutex> guard(lock);
+
+	while(running)
+	{
+		next += chrono::milliseconds(intervalMs);
+		wake.wait_until(guard, next, [this] { return(!running); });
+
+		stringstream label;
+		label << fixed << setprecision(1) << chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		exportCounts(label.str(), previous);
+	}
+}
+
+// exportCounts: one line per type and stage recorded since the counts in
+//   since, which are then advanced to the current counts
+void LatencyExporter::exportCounts(const string &label, vector<LatencyCounts> &since)
+{
+	LatencyCounts current;
+
+	for(int t = 0; t < STATS_NUM_TYPES; t++)
+	{
+		for(int s = 0; s < LATENCY_NUM_STAGES; s++)
+		{
+			LatencyCounts &earlier = since[t * LATENCY_NUM_STAGES + s];
+			latencyStats().snapshot(t, s, current);
+			if(current.total == earlier.total)
+				continue;
+
+			LatencyCounts interval = current;
+			interval.subtract(earlier);
+			earlier = current;
+
+			out << label << "," << ParseStats::typeName(t) << "," << LatencyStats::stageName(s);
+			out << "," << interval.total << fixed << setprecision(3);
+			out << "," << interval.percentile(50.0) / 1000.0;
+			out << "," << interval.percentile(99.0) / 1000.0;
+			out << "," << interval.percentile(99.9) / 1000.0;
+			out << "," << interval.maximum() / 1000.0 << endl;
+		}
+	}
+}
@@ -0,0 +1,150 @@
+//**************************************************************
+// Latency histograms
+//   - this library records the delay from the arrival of a
+//     frame's first byte to each stage of its processing, per
+//     message type and stage, in HDR-style log-linear
+//     histograms (about 1.6% resolution from 1 ns to 68 s),
+//     and exports the p50/p99/p99.9 of each interval to a CSV
+//     file from its own thread.
+//   - the arrival time is when the read-ahead thread (LibInput.h)
+//     read the piece of the log holding the sync byte, so the
+//     time a frame waits in its queue is counted; on a live
+//     stream (serial port, pty) that thread blocks on the
+//     device, so this is when the byte arrived.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBLATENCY_H
+#define LIBLATENCY_H
+
+// defined constants
+#define LATENCY_SUB_BITS     7     // 128 linear buckets below 128 ns, then 64 per power of two
+#define LATENCY_MAGNITUDES   30    // bucket ranges: the linear one, then one per power of two up to 2^36 ns
+#define LATENCY_BUCKETS      ((1 << LATENCY_SUB_BITS) + (LATENCY_MAGNITUDES - 1) * (1 << (LATENCY_SUB_BITS - 1)))
+#define LATENCY_EXPORT_MS    1000  // default time between exported intervals
+
+// pipeline stages, each measured from the arrival of the first byte
+#define LATENCY_FRAMED       0     // frame read completely
+#define LATENCY_DECODED      1     // decoded and checksum verified
+#define LATENCY_OUTPUT       2     // CSV record written
+#define LATENCY_FIX          3     // position fix from this measurement written
+#define LATENCY_NUM_STAGES   4
+
+// included libraries
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "LibStats.h"
+
+using namespace std;
+
+// custom data types
+// bucket counts of one histogram at one moment
+struct LatencyCounts {
+	unsigned long long total;
+	vector<unsigned long long> buckets;
+
+	LatencyCounts() : total(0), buckets(LATENCY_BUCKETS, 0) {}
+	long long percentile(double p) const;       // ns, 0 if empty
+	long long maximum(void) const;              // ns, 0 if empty
+	void subtract(const LatencyCounts &earlier);
+};
+
+// definition of LatencyHistogram class
+//   recording is a relaxed atomic add, so another thread may take
+//   snapshots while frames are recorded
+class LatencyHistogram
+{
+	public:
+		// constructors
+		LatencyHistogram();
+
+		// methods
+		void record(long long ns)
+		{
+			counts[bucketOf(ns)].fetch_add(1, memory_order_relaxed);
+		}
+		void snapshot(LatencyCounts &out) const;
+
+		// bucket mapping
+		static int bucketOf(long long ns);
+		static long long bucketValue(int bucket);   // highest ns in the bucket
+
+	private:
+		LatencyHistogram(const LatencyHistogram &);   // not copyable
+		LatencyHistogram & operator=(const LatencyHistogram &);
+
+		atomic<unsigned long long> counts[LATENCY_BUCKETS];
+};
+
+// definition of LatencyStats class
+//   one histogram per message type slot (see LibStats.h) and stage
+class LatencyStats
+{
+	public:
+		// methods
+		void record(int slot, int stage, long long arrival, long long now)
+		{
+			histogram[slot][stage].record(now - arrival);
+		}
+		void snapshot(int slot, int stage, LatencyCounts &out) const
+		{
+			histogram[slot][stage].snapshot(out);
+		}
+
+		static string stageName(int stage);
+
+	private:
+		LatencyHistogram histogram[STATS_NUM_TYPES][LATENCY_NUM_STAGES];
+};
+
+// definition of LatencyExporter class
+class LatencyExporter
+{
+	public:
+		// constructors
+		LatencyExporter();
+
+		// destructor
+		~LatencyExporter(void);
+
+		// methods
+		int  start(const string &fname, unsigned int intervalMs = LATENCY_EXPORT_MS);
+		void stop(void);
+
+	private:
+		LatencyExporter(const LatencyExporter &);   // not copyable
+		LatencyExporter & operator=(const LatencyExporter &);
+
+		thread exporter;
+		mutex lock;
+		condition_variable wake;
+		bool running;
+		unsigned int intervalMs;
+		ofstream out;
+		vector<LatencyCounts> first;       // counts when start() was called
+		vector<LatencyCounts> previous;    // counts at the last export
+
+		// methods
+		void run(void);
+		void exportCounts(const string &label, vector<LatencyCounts> &since);
+};
+
+// function prototypes
+LatencyStats & latencyStats(void);     // histograms shared by all parsers
+inline long long latencyClock(void)    // ns, steady clock
+{
+	return(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif  // LIBLATENCY_H
@@ -0,0 +1,286 @@
+//**************************************************************
+// Multiple receiver log merge tools
+//   - this file implements the threaded k-way merge of UBX
+//     logs into time aligned epochs.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "LibMerge.h"
+
+using namespace std;
+
+// defined constants
+#define MERGE_HALF_WEEK_MS  302400000L
+
+
+// read little endian fields from a payload
+static long readI4(const U1 * p)
+{
+	return(static_cast<long>(static_cast<int>(p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<unsigned int>(p[3]) << 24))));
+}
+
+static int readI2(const U1 * p)
+{
+	return(static_cast<short>(p[0] | (p[1] << 8)));
+}
+
+static double readR8(const U1 * p)
+{
+	double value;
+	memcpy(&value, p, sizeof(value));
+	return(value);
+}
+
+// swapMessage: exchanges two messages without copying payloads
+void swapMessage(UBXMessage &a, UBXMessage &b)
+{
+	UBXHeader   header   = a.header;
+	U1 *        payload  = a.payload;
+	UBXChecksum checksum = a.checksum;
+
+	a.header   = b.header;
+	a.payload  = b.payload;
+	a.checksum = b.checksum;
+	b.header   = header;
+	b.payload  = payload;
+	b.checksum = checksum;
+}
+
+
+// LogMerger: default constructor
+LogMerger::LogMerger()
+{
+	toleranceMs    = 0;
+	messagesMerged = 0;
+	epochsMerged   = 0;
+	started        = false;
+}
+
+// ~LogMerger: destructor
+LogMerger::~LogMerger(void)
+{
+	stop();
+}
+
+// add: opens an input log; its messages appear at index numInputs()-1
+//   of MergedEpoch::messages
+//   returns 0 => success, 1 => cannot open or already started
+int LogMerger::add(const string &fname)
+{
+	if(started)
+		return 1;
+
+	Input * in = new Input;
+	if(in->parser.open(fname) != 0)
+	{
+		delete in;
+		return 1;
+	}
+
+	in->ended          = false;
+	in->stopping       = false;
+	in->checksumErrors = 0;
+	in->week           = -1;
+	in->lastTOW        = 0;
+	in->lastKey        = MERGE_NO_TIME;
+	inputs.push_back(in);
+
+	return 0;
+}
+
+// start: starts one reader thread per input and primes the heap with
+//   the first message of every log
+//   returns 0 => success, 1 => no inputs
+int LogMerger::start(void)
+{
+	if(started)
+		return 0;
+	if(inputs.empty())
+		return 1;
+
+	for(unsigned int i = 0; i < inputs.size(); i++)
+		inputs[i]->reader = thread(&LogMerger::readLog, this, inputs[i]);
+
+	heap.clear();
+	for(unsigned int i = 0; i < inputs.size(); i++)
+	{
+		if(pop(inputs[i], inputs[i]->head))
+		{
+			HeapEntry entry = { inputs[i]->head.key, static_cast<int>(i) };
+			heap.push_back(entry);
+		}
+	}
+	make_heap(heap.begin(), heap.end());
+	started = true;
+
+	return 0;
+}
+
+// next: merges the next epoch, the messages of all logs whose time is
+//   within toleranceMs of the earliest pending message
+//   returns 0 => epoch merged, 1 => all logs ended
+int LogMerger::next(MergedEpoch &epoch)
+{
+	if(!started && start() != 0)
+		return 1;
+	if(heap.empty())
+		return 1;
+
+	epoch.messages.resize(inputs.size());
+	for(unsigned int i = 0; i < epoch.messages.size(); i++)
+		epoch.messages[i].clear();
+
+	long long first = heap.front().key;
+	epoch.key  = first;
+	epoch.week = first == MERGE_NO_TIME ? -1 : static_cast<int>(first / MERGE_MS_PER_WEEK);
+	epoch.iTOW = first == MERGE_NO_TIME ? -1 : static_cast<long>(first % MERGE_MS_PER_WEEK);
+
+	while(!heap.empty() && heap.front().key <= first + toleranceMs)
+	{
+		pop_heap(heap.begin(), heap.end());
+		HeapEntry entry = heap.back();
+		heap.pop_back();
+
+		// move the head message into the epoch and refill from its log
+		Input * in = inputs[entry.input];
+		epoch.messages[entry.input].push_back(UBXMessage());
+		swapMessage(epoch.messages[entry.input].back(), in->head.message);
+		messagesMerged++;
+
+		if(pop(in, in->head))
+		{
+			entry.key = in->head.key;
+			heap.push_back(entry);
+			push_heap(heap.begin(), heap.end());
+		}
+	}
+
+	epochsMerged++;
+	return 0;
+}
+
+// stop: stops the readers and closes all inputs
+void LogMerger::stop(void)
+{
+	for(unsigned int i = 0; i < inputs.size(); i++)
+	{
+		Input * in = inputs[i];
+		{
+			unique_lock<mutex> guard(in->lock);
+			in->stopping = true;
+		}
+		in->notFull.notify_all();
+		if(in->reader.joinable())
+			in->reader.join();
+		delete in;
+	}
+	inputs.clear();
+	heap.clear();
+	started = false;
+}
+
+// readLog: reader thread, fills the queue of one input until end of log
+void LogMerger::readLog(Input *in)
+{
+	UBXMessage message;
+
+	while(true)
+	{
+		int res = in->parser.read_next_ubx(message);
+		if(res == 1)
+			break;  // end of file
+		if(res == 2)
+		{
+			in->checksumErrors++;
+			continue;
+		}
+
+		long long key = timeKey(in, message);
+
+		unique_lock<mutex> guard(in->lock);
+		while(in->queue.size() >= MERGE_QUEUE_SIZE && !in->stopping)
+			in->notFull.wait(guard);
+		if(in->stopping)
+			break;
+
+		in->queue.push_back(TimedMessage());
+		in->queue.back().key = key;
+		swapMessage(in->queue.back().message, message);
+		in->notEmpty.notify_one();
+	}
+
+	unique_lock<mutex> guard(in->lock);
+	in->ended = true;
+	in->notEmpty.notify_all();
+}
+
+// pop: takes the next message of an input, waiting for its reader
+//   returns false at the end of the log
+bool LogMerger::pop(Input *in, TimedMessage &m)
+{
+	unique_lock<mutex> guard(in->lock);
+	while(in->queue.empty() && !in->ended)
+		in->notEmpty.wait(guard);
+	if(in->queue.empty())
+		return(false);
+
+	m.key = in->queue.front().key;
+	swapMessage(m.message, in->queue.front().message);
+	in->queue.pop_front();
+	in->notFull.notify_one();
+
+	return(true);
+}
+
+// timeKey: merge key of a message from its iTOW and the week last seen
+//   on the same log; messages without a time tag (ephemeris, subframes)
+//   keep the key of the message before them so they stay with their epoch
+long long LogMerger::timeKey(Input *in, const UBXMessage &message)
+{
+	const U1 * p = message.payload;
+	int  length = message.header.length;
+	long tow = -1;
+	int  week = -1;
+
+	if(p != 0 && message.header.MessageClass == NAV && length >= 4)
+	{
+		tow = readI4(p);
+		if((message.header.MessageID == SOL || message.header.MessageID == TIMEGPS) && length >= 10)
+			week = readI2(&p[8]);
+	}
+	else if(p != 0 && message.header.MessageClass == RXM && message.header.MessageID == RAW && length >= 6)
+	{
+		tow  = readI4(p);
+		week = readI2(&p[4]);
+	}
+	else if(p != 0 && message.header.MessageClass == RXM && message.header.MessageID == RAWX && length >= 10)
+	{
+		tow  = static_cast<long>(floor(readR8(p) * 1000.0 + 0.5));
+		week = p[8] | (p[9] << 8);
+	}
+
+	if(tow < 0)
+		return(in->lastKey);  // untimed message
+
+	if(week > 0)
+		in->week = week;
+	else if(in->week >= 0 && tow < in->lastTOW - MERGE_HALF_WEEK_MS)
+		in->week++;  // time of week rolled over before a week number was seen
+	in->lastTOW = tow;
+
+	if(in->week < 0)
+		return(in->lastKey);  // no week yet, cannot be aligned with other logs
+
+	in->lastKey = in->week * MERGE_MS_PER_WEEK + tow;
+	return(in->lastKey);
+}
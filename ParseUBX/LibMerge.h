@@ -0,0 +1,117 @@
+//**************************************************************
+// Multiple receiver log merge tools
+//   - this library merges the UBX logs of several receivers
+//     recorded at the same time into one stream of epochs.
+//     Each log is read by its own I/O thread into a bounded
+//     queue; a k-way heap merge on (GPS week, iTOW) then
+//     groups the messages of all receivers that belong to the
+//     same epoch.  Only a few messages per log are held in
+//     memory, whatever the log sizes.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBMERGE_H
+#define LIBMERGE_H
+
+// defined constants
+#define MERGE_QUEUE_SIZE    256     // messages buffered per input log
+#define MERGE_MS_PER_WEEK   604800000LL
+#define MERGE_NO_TIME       -1LL    // key of messages before the first time tag
+
+// included libraries
+#include <vector>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ParseUBX.h"
+
+// custom data types
+struct MergedEpoch {
+	int  week;                 // GPS week of epoch
+	long iTOW;                 // GPS time of week of epoch (milliseconds)
+	long long key;             // week * MERGE_MS_PER_WEEK + iTOW
+	// messages of the epoch per input log (index as passed to add()), in log order
+	vector< vector<UBXMessage> > messages;
+};
+
+// definition of LogMerger class
+class LogMerger
+{
+	public:
+		// constructors
+		LogMerger();
+
+		// destructor
+		~LogMerger(void);
+
+		// methods
+		int  add(const string &fname);   // add an input log, before start()
+		int  start(void);                // start the I/O threads
+		int  next(MergedEpoch &epoch);   // 0 => epoch merged, 1 => all logs ended
+		void stop(void);                 // stop the I/O threads, close the logs
+		int  numInputs(void) const { return(static_cast<int>(inputs.size())); }
+
+		// settings
+		long toleranceMs;   // messages up to this much later than the earliest join its epoch
+
+		// counters
+		unsigned long messagesMerged;
+		unsigned long epochsMerged;
+
+	private:
+		struct TimedMessage {
+			long long  key;
+			UBXMessage message;
+		};
+
+		struct Input {
+			UBXParser parser;
+			thread reader;
+			mutex lock;
+			condition_variable notEmpty;
+			condition_variable notFull;
+			deque<TimedMessage> queue;   // at most MERGE_QUEUE_SIZE messages
+			bool ended;                  // reader reached end of log
+			bool stopping;               // merger asks reader to quit
+			unsigned long checksumErrors;
+
+			// time tracking of the reader
+			int  week;                   // last week seen, -1 => none yet
+			long lastTOW;                // last iTOW seen (milliseconds)
+			long long lastKey;           // key given to untimed messages
+
+			// merge side
+			TimedMessage head;           // next message of this log in the heap
+		};
+
+		struct HeapEntry {
+			long long key;
+			int input;
+			bool operator<(const HeapEntry &e) const   // min-heap on (key, input)
+			{ return(key != e.key ? key > e.key : input > e.input); }
+		};
+
+		LogMerger(const LogMerger &);               // not copyable
+		LogMerger & operator=(const LogMerger &);
+
+		vector<Input *> inputs;
+		vector<HeapEntry> heap;
+		bool started;
+
+		// methods
+		void readLog(Input *in);
+		bool pop(Input *in, TimedMessage &m);
+		long long timeKey(Input *in, const UBXMessage &message);
+};
+
+// function prototypes
+void swapMessage(UBXMessage &a, UBXMessage &b);
+
+#endif  // LIBMERGE_H
@@ -30,10 +30,15 @@ bool verifyChecksum(string &message)
 
 	size_t first, last, index;  // indices into a string
 	unsigned char  chksum;       // calculated check sum
-	unsigned short msgChksum;    // message check sum
+	unsigned short msgChksum = 0x100;  // message check sum, no match until read
 
 	first = message.find_first_of('$') + 1;         // start at char after '$'
-	last  = message.find_first_of('*', first) - 1;  // stop at char before '*'
+	last  = message.find_first_of('*', first);      // stop at char before '*'
+
+	// a damaged sentence may lack the '*' or the two check sum digits
+	if(first == 0 || last == string::npos || last == first || last + 3 > message.size())
+		return(false);
+	last--;
 
 	// preform xor of all characters from first to last
 	chksum = message.at(first);
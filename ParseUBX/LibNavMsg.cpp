@@ -0,0 +1,381 @@
+//**************************************************************
+// Navigation message assembly tools
+//   - this file implements the RXM-SFRBX navigation message
+//     assembler.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <bitset>
+#include "LibNavMsg.h"
+
+using namespace std;
+
+// defined constants
+#define FNV_OFFSET  2166136261u   // FNV-1a 32 bit offset basis
+#define FNV_PRIME   16777619u     // FNV-1a 32 bit prime
+
+
+// read a little endian 32 bit word from a payload
+static U4 readWord(const U1 * p)
+{
+	return(static_cast<U4>(p[0])       | (static_cast<U4>(p[1]) << 8) |
+	       (static_cast<U4>(p[2]) << 16) | (static_cast<U4>(p[3]) << 24));
+}
+
+// FNV-1a signature over a range of words, used where a data set has no IOD
+static U4 signature(U4 hash, const U4 * words, int count, U4 lastMask)
+{
+	for(int i = 0; i < count; i++)
+	{
+		U4 w = words[i] & 0xFFFFFFFF;
+		if(i == count - 1)
+			w &= lastMask;
+		for(int b = 0; b < 4; b++)
+		{
+			hash ^= (w >> (8 * b)) & 0xFF;
+			hash *= FNV_PRIME;
+		}
+	}
+	return(hash & 0xFFFFFFFF);
+}
+
+
+// constructors
+NavAssembler::NavAssembler()
+{
+	reset();
+}
+
+// methods
+void NavAssembler::reset(void)
+{
+	memset(gps, 0, sizeof(gps));
+	memset(galileo, 0, sizeof(galileo));
+	memset(beidou, 0, sizeof(beidou));
+	memset(glonass, 0, sizeof(glonass));
+	wordsRejected = 0;
+	setsCompleted = 0;
+}
+
+// add: feeds one RXM-SFRBX payload to the assembler
+//   returns  1 => record holds a newly completed data set
+//            0 => words stored (or message type not assembled)
+//           <0 => payload rejected
+int NavAssembler::add(const U1 * payload, int length, NavRecord &record)
+{
+	U4 dwrd[NAV_MAX_WORDS];
+	int res;
+
+	if(length < 8)
+	{
+		wordsRejected++;
+		return(-1);
+	}
+
+	U1 gnssId   = payload[0];
+	U1 svId     = payload[1];
+	U1 numWords = payload[4];
+
+	if(svId == 0 || svId >= NAV_MAX_SV || numWords > NAV_MAX_WORDS || length < 8 + 4 * numWords)
+	{
+		wordsRejected++;
+		return(-2);
+	}
+
+	for(int i = 0; i < numWords; i++)
+		dwrd[i] = readWord(&payload[8 + 4 * i]);
+
+	switch(gnssId)
+	{
+		case GNSS_GPS:
+			res = addGPS(gps[svId], dwrd, numWords, record);
+			break;
+		case GNSS_GALILEO:
+			res = addGalileo(galileo[svId], dwrd, numWords, record);
+			break;
+		case GNSS_BEIDOU:
+			res = addBeiDou(beidou[svId], svId, dwrd, numWords, record);
+			break;
+		case GNSS_GLONASS:
+			res = addGLONASS(glonass[svId], dwrd, numWords, record);
+			break;
+		default:
+			return(0);  // SBAS/QZSS/IMES not assembled
+	}
+
+	if(res < 0)
+		wordsRejected++;
+	else if(res == 1)
+	{
+		record.gnssId = gnssId;
+		record.svId   = svId;
+	}
+	return(res);
+}
+
+// copy slots into record unless the same data set was already emitted
+int NavAssembler::emit(NavChannel &ch, U4 iod, int first, int count, int numWords, NavRecord &record)
+{
+	if(ch.emitted && ch.lastIod == iod)
+		return(0);  // repeat broadcast of a known data set
+
+	for(int s = 0; s < count; s++)
+		memcpy(record.words[s], ch.words[first + s], numWords * sizeof(U4));
+	record.numSlots = count;
+	record.numWords = numWords;
+	record.iod      = iod;
+
+	ch.emitted = 1;
+	ch.lastIod = iod;
+	setsCompleted++;
+	return(1);
+}
+
+// GPS LNAV: ten 30 bit words, subframe ID in HOW, IODC/IODE tie subframes 1-3
+int NavAssembler::addGPS(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record)
+{
+	U4 data[NAV_MAX_WORDS];
+
+	if(numWords != 10)
+		return(-3);
+
+	// strip parity, keep data bits 1-24 of each word
+	for(int i = 0; i < 10; i++)
+		data[i] = (dwrd[i] >> 6) & 0xFFFFFF;
+
+	int sfid = (data[1] >> 2) & 0x7;  // HOW bits 20-22
+	if(sfid < 1 || sfid > 3)
+		return(0);  // almanac/health subframes are not assembled
+
+	int slot = sfid - 1;
+	memcpy(ch.words[slot], data, 10 * sizeof(U4));
+	ch.have[slot] = 1;
+	if(sfid == 1)
+		ch.tag[0] = ((data[2] & 0x3) << 8) | ((data[7] >> 16) & 0xFF);  // IODC
+	else if(sfid == 2)
+		ch.tag[1] = (data[2] >> 16) & 0xFF;   // IODE
+	else
+		ch.tag[2] = (data[9] >> 16) & 0xFF;   // IODE
+
+	if(!ch.have[0] || !ch.have[1] || !ch.have[2])
+		return(0);
+	if(ch.tag[1] != ch.tag[2] || ch.tag[1] != (ch.tag[0] & 0xFF))
+		return(0);  // ephemeris cutover in progress, wait for matching subframes
+
+	record.type = NAVREC_GPS_LNAV;
+	return(emit(ch, ch.tag[0], 0, 3, 10, record));
+}
+
+// Galileo I/NAV: even and odd page part, word types 1-4 carry IODnav
+int NavAssembler::addGalileo(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record)
+{
+	if(numWords < 8)
+		return(-3);
+
+	if(((dwrd[0] >> 31) & 1) != 0 || ((dwrd[4] >> 31) & 1) != 1)
+		return(-4);  // even/odd page parts out of order
+	if(((dwrd[0] >> 30) & 1) || ((dwrd[4] >> 30) & 1))
+		return(0);   // alert page
+
+	int type = (dwrd[0] >> 24) & 0x3F;
+	if(type < 1 || type > 5)
+		return(0);   // almanac/spare word types are not assembled
+
+	int slot = type - 1;
+	memcpy(ch.words[slot], dwrd, 8 * sizeof(U4));
+	ch.have[slot] = 1;
+	ch.tag[slot]  = (type <= 4) ? ((dwrd[0] >> 14) & 0x3FF) : 0;  // IODnav
+
+	for(int s = 0; s < 5; s++)
+	{
+		if(!ch.have[s])
+			return(0);
+	}
+	if(ch.tag[1] != ch.tag[0] || ch.tag[2] != ch.tag[0] || ch.tag[3] != ch.tag[0])
+		return(0);  // batch of word types spans two issues of data
+
+	record.type = NAVREC_GAL_INAV;
+	return(emit(ch, ch.tag[0], 0, 5, 8, record));
+}
+
+// BeiDou D1 (MEO/IGSO) and D2 (GEO): subframes tied together by SOW
+int NavAssembler::addBeiDou(NavChannel &ch, int svId, const U4 * dwrd, int numWords, NavRecord &record)
+{
+	U4 words[NAV_MAX_WORDS];
+
+	if(numWords != 10)
+		return(-3);
+
+	for(int i = 0; i < 10; i++)
+		words[i] = dwrd[i] & 0x3FFFFFFF;
+
+	int fraId = (words[0] >> 12) & 0x7;
+	U4  sow   = (((words[0] >> 4) & 0xFF) << 12) | ((words[1] >> 18) & 0xFFF);
+	bool d2   = (svId <= 5 || svId >= 59);  // GEO satellites broadcast D2
+
+	if(!d2)
+	{
+		if(fraId < 1 || fraId > 3)
+			return(0);
+
+		int slot = fraId - 1;
+		memcpy(ch.words[slot], words, 10 * sizeof(U4));
+		ch.have[slot] = 1;
+		ch.tag[slot]  = sow;
+
+		if(!ch.have[0] || !ch.have[1] || !ch.have[2])
+			return(0);
+		if(ch.tag[1] != ch.tag[0] + 6 || ch.tag[2] != ch.tag[0] + 12)
+			return(0);  // subframes from different frames
+
+		U4 iod = FNV_OFFSET;
+		for(int s = 0; s < 3; s++)
+			iod = signature(iod, &ch.words[s][2], 8, 0xFFFFFFFF);
+
+		record.type = NAVREC_BDS_D1;
+		return(emit(ch, iod, 0, 3, 10, record));
+	}
+
+	if(fraId != 1)
+		return(0);  // only D2 subframe 1 carries the ephemeris
+
+	int page = (words[1] >> 14) & 0xF;
+	if(page < 1 || page > 10)
+		return(-4);
+
+	int slot = page - 1;
+	memcpy(ch.words[slot], words, 10 * sizeof(U4));
+	ch.have[slot] = 1;
+	ch.tag[slot]  = sow;
+
+	for(int s = 0; s < 10; s++)
+	{
+		if(!ch.have[s] || ch.tag[s] != ch.tag[0] + 3 * s)
+			return(0);  // page missing or left over from an earlier cycle
+	}
+
+	U4 iod = FNV_OFFSET;
+	for(int s = 0; s < 10; s++)
+		iod = signature(iod, &ch.words[s][2], 8, 0xFFFFFFFF);
+
+	record.type = NAVREC_BDS_D2;
+	return(emit(ch, iod, 0, 10, 10, record));
+}
+
+// GLONASS: strings 1-4 must arrive in sequence within one frame
+int NavAssembler::addGLONASS(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record)
+{
+	if(numWords < 4)
+		return(-3);
+
+	int m = (dwrd[0] >> 27) & 0xF;  // string number
+
+	if(m == 1)
+	{
+		memset(ch.have, 0, sizeof(ch.have));
+	}
+	else if(m < 1 || m > 4 || ch.lastSlot != m - 1 || !ch.have[m - 2])
+	{
+		bool sequenced = (m > 4 || ch.lastSlot == m - 1);
+		memset(ch.have, 0, sizeof(ch.have));
+		ch.lastSlot = m;
+		return(sequenced ? 0 : -4);  // almanac string, or a string was missed
+	}
+
+	int slot = m - 1;
+	memcpy(ch.words[slot], dwrd, 4 * sizeof(U4));
+	ch.have[slot] = 1;
+	ch.lastSlot   = m;
+
+	if(m != 4)
+		return(0);
+
+	// strings 2-4 only change with a new ephemeris; the last word holds
+	// frame/superframe numbers and only its top 21 bits are string data
+	U4 iod = FNV_OFFSET;
+	for(int s = 1; s < 4; s++)
+		iod = signature(iod, ch.words[s], 3, 0xFFFFF800);
+
+	record.type = NAVREC_GLONASS;
+	return(emit(ch, iod, 0, 4, 4, record));
+}
+
+
+// writeNavRecord: writes a completed navigation data set as one CSV line
+//   GPS sets use the "RXM,EPH" layout so SolutionUBX can read them as
+//   broadcast ephemeris; other systems are written as raw hex words
+int writeNavRecord(ostream &outFile, const NavRecord &record)
+{
+	int bytesWritten = 0;     // number of bytes written to output file
+	stringstream outputLine;  // string stream in which to build output line for file
+
+	if(!outFile)
+		return(0);
+
+	if(record.type == NAVREC_GPS_LNAV)
+	{
+		outputLine << "RXM,";
+		outputLine << "EPH,";
+		outputLine << static_cast<unsigned>(record.svId) << ",";  // SV ID for this ephemeris data
+
+		outputLine << "0x" << hex << setfill('0');
+		outputLine << setw(6) << record.words[0][1];  // Hand-over Word of first subframe
+		outputLine << dec;
+
+		// subframe words 3 -> 10
+		for(int s = 0; s < 3; s++)
+		{
+			outputLine << ",SF" << (s + 1) << ",";
+			for(int i = 2; i < 10; i++)
+				outputLine << bitset<30>(record.words[s][i]);
+		}
+	}
+	else
+	{
+		const char * name = "";
+		switch(record.type)
+		{
+			case NAVREC_GAL_INAV: name = "GAL,INAV"; break;
+			case NAVREC_BDS_D1:   name = "BDS,D1";   break;
+			case NAVREC_BDS_D2:   name = "BDS,D2";   break;
+			case NAVREC_GLONASS:  name = "GLO,STR";  break;
+		}
+
+		outputLine << "RXM,";
+		outputLine << "NAVSET,";
+		outputLine << name << ",";
+		outputLine << static_cast<unsigned>(record.svId) << ",";      // satellite identifier
+		outputLine << "0x" << hex << setfill('0') << setw(8) << record.iod << dec << ",";  // issue of data / signature
+		outputLine << static_cast<unsigned>(record.numSlots);         // number of subframes/pages/strings
+
+		// output raw words of each slot
+		for(int s = 0; s < record.numSlots; s++)
+		{
+			outputLine << ",";
+			for(int i = 0; i < record.numWords; i++)
+				outputLine << " " << setw(8) << setfill('0') << hex << record.words[s][i];
+			outputLine << dec;
+		}
+	}
+
+	outputLine << endl;
+
+	// get number of bytes to be written
+	bytesWritten = outputLine.str().length();
+
+	// write line to output file
+	outFile << outputLine.str();
+
+	return(bytesWritten);
+}
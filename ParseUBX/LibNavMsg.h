@@ -0,0 +1,95 @@
+//**************************************************************
+// Navigation message assembly tools
+//   - this library provides a per-SV state machine that
+//     assembles RXM-SFRBX words into complete navigation
+//     data sets (GPS LNAV subframes 1-3, Galileo I/NAV word
+//     types 1-5, BeiDou D1 subframes 1-3 / D2 subframe 1
+//     pages 1-10 and GLONASS strings 1-4).
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBNAVMSG_H
+#define LIBNAVMSG_H
+
+// defined constants
+// *** GNSS identifiers used by RXM-SFRBX ***
+#define GNSS_GPS      0
+#define GNSS_SBAS     1
+#define GNSS_GALILEO  2
+#define GNSS_BEIDOU   3
+#define GNSS_QZSS     5
+#define GNSS_GLONASS  6
+
+// *** Navigation record types ***
+#define NAVREC_GPS_LNAV  1   // GPS/QZSS LNAV subframes 1-3, 10 data words (24 bits) each
+#define NAVREC_GAL_INAV  2   // Galileo I/NAV word types 1-5, even+odd page (8 words) each
+#define NAVREC_BDS_D1    3   // BeiDou D1 subframes 1-3, 10 raw words (30 bits) each
+#define NAVREC_BDS_D2    4   // BeiDou D2 subframe 1 pages 1-10, 10 raw words (30 bits) each
+#define NAVREC_GLONASS   5   // GLONASS strings 1-4, 4 words each
+
+#define NAV_MAX_SV     64   // SV slots per GNSS
+#define NAV_MAX_SLOTS  10   // subframes/pages/strings per data set
+#define NAV_MAX_WORDS  10   // words per subframe/page/string
+
+// included libraries
+#include "LibUBX.h"
+
+// custom data types
+struct NavRecord {
+	U1 gnssId;        // GNSS identifier
+	U1 svId;          // satellite identifier
+	U1 type;          // navigation record type (NAVREC_*)
+	U1 numSlots;      // subframes/pages/strings in record
+	U1 numWords;      // words per slot
+	U4 iod;           // issue of data (GPS IODC, Galileo IODnav) or data set signature
+	U4 words[NAV_MAX_SLOTS][NAV_MAX_WORDS];
+};
+
+// definition of NavAssembler class
+class NavAssembler
+{
+	public:
+		// constructors
+		NavAssembler();
+
+		// methods
+		int  add(const U1 * payload, int length, NavRecord &record);
+		void reset(void);
+
+		// counters
+		unsigned long wordsRejected;    // messages with bad layout or out of sequence
+		unsigned long setsCompleted;    // records emitted
+
+	private:
+		struct NavChannel {
+			U1 have[NAV_MAX_SLOTS];      // 1 => slot holds current data
+			U4 tag[NAV_MAX_SLOTS];       // IOD or time tag of slot
+			U4 words[NAV_MAX_SLOTS][NAV_MAX_WORDS];
+			U1 lastSlot;                 // last slot received (sequenced systems)
+			U1 emitted;                  // 1 => lastIod is valid
+			U4 lastIod;                  // IOD/signature of last emitted record
+		};
+
+		// fixed tables, one channel per (GNSS, SV)
+		NavChannel gps[NAV_MAX_SV];
+		NavChannel galileo[NAV_MAX_SV];
+		NavChannel beidou[NAV_MAX_SV];
+		NavChannel glonass[NAV_MAX_SV];
+
+		// methods
+		int addGPS(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record);
+		int addGalileo(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record);
+		int addBeiDou(NavChannel &ch, int svId, const U4 * dwrd, int numWords, NavRecord &record);
+		int addGLONASS(NavChannel &ch, const U4 * dwrd, int numWords, NavRecord &record);
+		int emit(NavChannel &ch, U4 iod, int first, int count, int numWords, NavRecord &record);
+};
+
+// function prototypes
+int writeNavRecord(ostream &outFile, const NavRecord &record);
+
+#endif  // LIBNAVMSG_H
@@ -0,0 +1,458 @@
+//**************************************************************
+// Per message type output
+//   - this file implements the routing of CSV lines to per
+//     type sinks and their writer threads.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <cstring>
+#include "LibSplit.h"
+#include "LibTrace.h"
+
+using namespace std;
+
+// defined constants
+#define SPLIT_MAX_THREADS   4       // writers by default, output is disk bound
+#define SPLIT_OTHER         "other" // sink of the lines of no known type
+
+// columns of the CSV lines of a type, as written by LibUBX and LibNavMsg
+// after the class and ID fields
+struct SplitLayout {
+	const char * type;
+	const char * fixed;     // columns before the repeated blocks
+	const char * block;     // columns of a repeated block, 0 => none
+	bool columns;           // every line has this layout, may be split in columns
+};
+
+static const SplitLayout LAYOUTS[] = {
+	{ "NAV_CLOCK",   "iTOW,clkB,clkD,tAcc,fAcc", 0, true },
+	{ "NAV_DGPS",    "iTOW,age,baseId,baseHealth,numCh,status", "svid,flags,ageC,prc,prrc", true },
+	{ "NAV_DOP",     "iTOW,gDOP,pDOP,tDOP,vDOP,hDOP,nDOP,eDOP", 0, true },
+	{ "NAV_POSECEF", "iTOW,ecefX,ecefY,ecefZ,pAcc", 0, true },
+	{ "NAV_POSLLH",  "iTOW,lon,lat,height,hMSL,hAcc,vAcc", 0, true },
+	{ "NAV_SBAS",    "iTOW,geo,mode,sys,service,cnt", "svid,flags,udre,svSys,svService,prc,ic", true },
+	{ "NAV_SOL",     "iTOW,fTOW,week,gpsFix,flags,ecefX,ecefY,ecefZ,pAcc,ecefVX,ecefVY,ecefVZ,sAcc,pDOP,numSV", 0, true },
+	{ "NAV_STATUS",  "iTOW,gpsFix,flags,fixStat,flags2,ttff,msss", 0, true },
+	{ "NAV_SVINFO",  "iTOW,numCh,globalFlags", "chn,svid,flags,quality,cno,elev,azim,prRes", true },
+	{ "NAV_TIMEGPS", "iTOW,fTOW,week,leapS,valid,tAcc", 0, true },
+	{ "NAV_TIMEUTC", "iTOW,tAcc,nano,year,month,day,hour,min,sec,valid", 0, true },
+	{ "RXM_RAW",     "iTOW,week,numSV", "prMes,sv,cno", true },
+	{ "RXM_RAWX",    "rcvTOW,week,numMeas", "prMes,svId,cno", true },
+	{ "RXM_MEASX",   "gpsTOW,numSV", "mpathIndic,dopplerHz,svId,cNo", true },
+	{ "RXM_SFRB",    "chn,svid,dwrd", 0, true },
+	{ "RXM_SFRBX",   "gnssId,svId,numWords,chn,dwrd", 0, true },
+	{ "RXM_NAVSET",  "gnss,signal,svId,iod,numSlots", "words", true },
+	{ "RXM_EPH",     "svid,how,SF1,sf1d,SF2,sf2d,SF3,sf3d", 0, false },   // poll lines have the svid only
+	{ "AID_EPH",     "svid,how,SF1,sf1d,SF2,sf2d,SF3,sf3d", 0, false },
+	{ "AID_HUI",     "utcTOW,utcWNT,klobA0,klobA1,klobA2,klobA3,klobB0,klobB1,klobB2,klobB3,flags", 0, true },
+};
+
+#define SPLIT_LAYOUTS   (sizeof(LAYOUTS) / sizeof(LAYOUTS[0]))
+
+// findLayout: layout of a type, 0 if unknown
+static const SplitLayout * findLayout(const string &type)
+{
+	for(size_t i = 0; i < SPLIT_LAYOUTS; i++)
+		if(type == LAYOUTS[i].type)
+			return(&LAYOUTS[i]);
+	return(0);
+}
+
+// splitNames: appends the comma separated names of a layout field
+static void splitNames(const char * names, vector<string> &to)
+{
+	if(names == 0)
+		return;
+	string name;
+	for(const char * p = names; ; p++)
+	{
+		if(*p == ',' || *p == '\0')
+		{
+			to.push_back(name);
+			name.clear();
+			if(*p == '\0')
+				break;
+		}
+		else
+			name += *p;
+	}
+}
+
+
+// SplitOutputBuf: default constructor
+SplitOutputBuf::SplitOutputBuf()
+{
+	lines = 0;
+	types = 0;
+	format = SPLIT_CSV;
+	append = false;
+	opened = false;
+	last = 0;
+	queuedBytes = 0;
+	stopping = false;
+	failed = false;
+}
+
+// ~SplitOutputBuf: destructor
+SplitOutputBuf::~SplitOutputBuf(void)
+{
+	close();
+}
+
+// open: starts the writer threads; the file of a type is created with
+//   its first line
+void SplitOutputBuf::open(const string &name, int fmt, unsigned int threads, bool app)
+{
+	close();
+
+	prefix = name;
+	format = fmt;
+	append = app;
+	lines = 0;
+	types = 0;
+	last = 0;
+	lastKey.clear();
+	queuedBytes = 0;
+	stopping = false;
+	failed = false;
+
+	buffer.resize(SPLIT_LINE_SIZE);
+	setp(&buffer[0], &buffer[0] + buffer.size());
+
+	unsigned int count = threads;
+	if(count == 0)
+	{
+		count = thread::hardware_concurrency();
+		if(count > SPLIT_MAX_THREADS)
+			count = SPLIT_MAX_THREADS;
+	}
+	if(count == 0)
+		count = 1;
+	for(unsigned int i = 0; i < count; i++)
+		writers.push_back(thread(&SplitOutputBuf::write, this));
+	opened = true;
+}
+
+// close: routes the lines left, waits until the writers wrote them all and
+//   closes the files
+//   returns SPLIT_OK, or SPLIT_NO_OUTPUT if a file could not be created or written
+int SplitOutputBuf::close(void)
+{
+	if(!opened)
+		return(SPLIT_OK);
+
+	// a last line without end of line
+	route();
+	if(pptr() != pbase())
+	{
+		sputc('\n');
+		route();
+	}
+	publish();
+
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for(size_t i = 0; i < writers.size(); i++)
+		writers[i].join();
+	writers.clear();
+
+	for(map<string, Sink *>::iterator it = sinks.begin(); it != sinks.end(); ++it)
+	{
+		Sink * sink = it->second;
+		for(size_t i = 0; i < sink->files.size(); i++)
+		{
+			sink->files[i]->close();
+			if(sink->files[i]->fail())
+				failed = true;
+			delete sink->files[i];
+		}
+		delete sink;
+	}
+	sinks.clear();
+	last = 0;
+	opened = false;
+	setp(0, 0);
+
+	return(failed ? SPLIT_NO_OUTPUT : SPLIT_OK);
+}
+
+// publish: hands the lines gathered so far to the writers, e.g. before
+//   waiting for more input, so the files show everything decoded
+void SplitOutputBuf::publish(void)
+{
+	route();
+	for(map<string, Sink *>::iterator it = sinks.begin(); it != sinks.end(); ++it)
+		if(it->second->pendingBytes > 0)
+			hand(it->second);
+}
+
+// overflow: the put area is full
+SplitOutputBuf::int_type SplitOutputBuf::overflow(int_type c)
+{
+	if(!opened)
+		return(traits_type::eof());
+
+	route();
+	if(pptr() == epptr())
+	{	// a line longer than the buffer
+		size_t used = pptr() - pbase();
+		buffer.resize(buffer.size() * 2);
+		setp(&buffer[0], &buffer[0] + buffer.size());
+		pbump(static_cast<int>(used));
+	}
+	if(!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+	return(traits_type::not_eof(c));
+}
+
+// sync: routes the complete lines; they are written with the next batch
+//   of their sink (publish writes them now)
+int SplitOutputBuf::sync(void)
+{
+	if(opened)
+		route();
+	return(0);
+}
+
+// route: routes the complete lines of the put area and moves a partial
+//   last line to its start
+void SplitOutputBuf::route(void)
+{
+	char * start = pbase();
+	char * end = pptr();
+	char * eol;
+	while(start < end && (eol = static_cast<char *>(memchr(start, '\n', end - start))) != 0)
+	{
+		routeLine(start, eol + 1 - start);
+		start = eol + 1;
+	}
+
+	size_t rest = end - start;
+	if(rest > 0 && start != pbase())
+		memmove(pbase(), start, rest);
+	setp(&buffer[0], &buffer[0] + buffer.size());
+	pbump(static_cast<int>(rest));
+}
+
+// routeLine: adds a line, with its end of line, to the sink of its type
+void SplitOutputBuf::routeLine(const char * line, size_t length)
+{
+	const char * end = line + length;
+	const char * first = static_cast<const char *>(memchr(line, ',', length));
+
+	// the type: CLASS_ID of a UBX line, the sentence ID of an NMEA line
+	const char * data = line;
+	bool nmea = (line[0] == '$');
+	key = SPLIT_OTHER;
+	if(first != 0 && nmea)
+	{
+		key.assign(line + 1, first);
+		data = first + 1;
+	}
+	else if(first != 0)
+	{
+		const char * second = static_cast<const char *>(memchr(first + 1, ',', end - first - 1));
+		if(second != 0)
+		{
+			key.assign(line, first);
+			key += '_';
+			key.append(first + 1, second);
+			data = second + 1;
+		}
+	}
+
+	Sink * sink = last;
+	if(sink == 0 || key != lastKey)
+	{
+		map<string, Sink *>::iterator it = sinks.find(key);
+		if(it == sinks.end() && !nmea && findLayout(key) == 0)
+		{	// a file per unknown key would have no bound (continuation
+			// lines, damage): the whole line goes to the other sink
+			key = SPLIT_OTHER;
+			data = line;
+			it = sinks.find(key);
+		}
+		sink = it != sinks.end() ? it->second : openSink();
+		last = sink;
+		lastKey = key;
+	}
+	lines++;
+
+	if(sink->fixedColumns == 0)
+	{	// CSV
+		sink->pending[0].append(data, end);
+		sink->pendingBytes += end - data;
+	}
+	else
+	{	// a value per column file: the fixed columns, then the repeated blocks
+		//   one after another
+		const char * stop = end - 1;   // the end of line
+		int column = 0;
+		int field = 0;
+		while(data <= stop)
+		{
+			const char * comma = static_cast<const char *>(memchr(data, ',', stop - data));
+			if(comma == 0)
+				comma = stop;
+			if(column < static_cast<int>(sink->files.size()))
+			{
+				string &to = sink->pending[column];
+				to.append(data, comma);
+				to += '\n';
+				sink->pendingBytes += comma - data + 1;
+			}
+			data = comma + 1;
+
+			field++;
+			if(field < sink->fixedColumns || sink->blockColumns == 0)
+				column = field;
+			else
+				column = sink->fixedColumns + (field - sink->fixedColumns) % sink->blockColumns;
+		}
+		// keep the fixed columns aligned if a line is short
+		for(; field < sink->fixedColumns; field++)
+		{
+			sink->pending[field] += '\n';
+			sink->pendingBytes++;
+		}
+	}
+
+	if(sink->pendingBytes >= SPLIT_BATCH_SIZE)
+		hand(sink);
+}
+
+// openSink: creates the files of the type in key and writes the header
+SplitOutputBuf::Sink * SplitOutputBuf::openSink(void)
+{
+	Sink * sink = new Sink;
+	sink->pendingBytes = 0;
+	sink->fixedColumns = 0;
+	sink->blockColumns = 0;
+	sink->scheduled = false;
+
+	ios::openmode mode = append ? ios::out | ios::app : ios::out;
+	const SplitLayout * layout = findLayout(key);
+	if(format == SPLIT_COLUMNS && layout != 0 && layout->columns)
+	{
+		vector<string> names;
+		splitNames(layout->fixed, names);
+		sink->fixedColumns = static_cast<int>(names.size());
+		splitNames(layout->block, names);
+		sink->blockColumns = static_cast<int>(names.size()) - sink->fixedColumns;
+		for(size_t i = 0; i < names.size(); i++)
+			sink->files.push_back(new ofstream((prefix + key + "_" + names[i] + ".col").c_str(), mode));
+	}
+	else
+	{
+		sink->files.push_back(new ofstream((prefix + key + ".csv").c_str(), mode));
+	}
+	sink->pending.resize(sink->files.size());
+
+	for(size_t i = 0; i < sink->files.size(); i++)
+	{
+		if(!sink->files[i]->is_open())
+		{
+			lock_guard<mutex> guard(lock);
+			failed = true;
+		}
+	}
+
+	// a header line names the columns, a repeated block once
+	if(sink->fixedColumns == 0 && layout != 0 && !append)
+	{
+		string &header = sink->pending[0];
+		header = layout->fixed;
+		if(layout->block != 0)
+		{
+			header += ',';
+			header += layout->block;
+		}
+		header += '\n';
+		sink->pendingBytes = header.size();
+	}
+
+	sinks[key] = sink;
+	types++;
+	return(sink);
+}
+
+// hand: queues the gathered lines of a sink for a writer, waits while
+//   SPLIT_QUEUE_LIMIT bytes are queued already
+void SplitOutputBuf::hand(Sink * sink)
+{
+	vector<string> batch(sink->pending.size());
+	for(size_t i = 0; i < batch.size(); i++)
+		batch[i].swap(sink->pending[i]);
+	size_t bytes = sink->pendingBytes;
+	sink->pendingBytes = 0;
+
+	unique_lock<mutex> guard(lock);
+	while(queuedBytes >= SPLIT_QUEUE_LIMIT)
+		space.wait(guard);
+	queuedBytes += bytes;
+	sink->queue.push_back(vector<string>());
+	sink->queue.back().swap(batch);
+	if(!sink->scheduled)
+	{
+		sink->scheduled = true;
+		ready.push_back(sink);
+		wake.notify_one();
+	}
+}
+
+// write: writer thread, writes the batches of one ready sink at a time
+//   until stopping and no sink is ready
+void SplitOutputBuf::write(void)
+{
+	unique_lock<mutex> guard(lock);
+	while(true)
+	{
+		while(ready.empty() && !stopping)
+			wake.wait(guard);
+		if(ready.empty())
+			break;
+
+		Sink * sink = ready.front();
+		ready.pop_front();
+		while(!sink->queue.empty())
+		{
+			vector<string> batch;
+			batch.swap(sink->queue.front());
+			sink->queue.pop_front();
+			guard.unlock();
+
+			TRACE_SPAN("output", "write");
+			size_t bytes = 0;
+			bool ok = true;
+			for(size_t i = 0; i < batch.size(); i++)
+			{
+				if(batch[i].empty())
+					continue;
+				sink->files[i]->write(batch[i].data(), batch[i].size());
+				sink->files[i]->flush();
+				ok = ok && sink->files[i]->good();
+				bytes += batch[i].size();
+			}
+
+			guard.lock();
+			queuedBytes -= bytes;
+			if(!ok)
+				failed = true;
+			space.notify_all();
+		}
+		sink->scheduled = false;
+	}
+}
@@ -0,0 +1,130 @@
+//**************************************************************
+// Per message type output
+//   - this library splits the CSV lines of the parser into one
+//     output per message type while they are written, so no
+//     second pass over the combined CSV (sep_mess.py) is needed.
+//   - a line is routed by its first two fields (class, ID) to
+//     the sink of its type, which drops them; NMEA sentences go
+//     to the sink of their sentence ID.  Known types start with
+//     a header line naming their columns.  Any other line (no
+//     known class and ID) goes whole to one <prefix>other.csv,
+//     so damaged input cannot open a file per junk key.
+//   - lines are gathered per sink and handed in batches to
+//     writer threads.  A sink is written by one thread at a
+//     time, so each file stays in line order, while different
+//     types are written in parallel.
+//
+//   SPLIT_CSV:      <prefix><CLASS>_<ID>.csv, the names
+//                   sep_mess.py gave, and <prefix><NMEA ID>.csv
+//   SPLIT_COLUMNS:  <prefix><CLASS>_<ID>_<column>.col, one value
+//                   per line; a repeated block column has one
+//                   line per block, the count column of the
+//                   type tells how many belong to each message.
+//                   Types without a fixed layout (EPH, NMEA)
+//                   are written as CSV.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBSPLIT_H
+#define LIBSPLIT_H
+
+// defined constants
+#define SPLIT_LINE_SIZE      (64 << 10)   // initial size of the line buffer
+#define SPLIT_BATCH_SIZE     (256 << 10)  // bytes of a sink handed to a writer at once
+#define SPLIT_QUEUE_LIMIT    (64 << 20)   // queued bytes before the parser waits
+
+// output formats
+#define SPLIT_CSV            0
+#define SPLIT_COLUMNS        1
+
+// results
+#define SPLIT_OK             0
+#define SPLIT_NO_OUTPUT      1            // an output file could not be created or written
+
+// included libraries
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// definition of SplitOutputBuf class
+class SplitOutputBuf : public streambuf
+{
+	public:
+		// constructors
+		SplitOutputBuf();
+
+		// destructor
+		~SplitOutputBuf(void);
+
+		// methods
+		// prefix: start of the output file names
+		// threads: writer threads, 0 => one per hardware thread (at most 4)
+		// append: continue earlier outputs, without new header lines
+		void open(const string &prefix, int format = SPLIT_CSV, unsigned int threads = 0, bool append = false);
+		int  close(void);               // writes all lines, SPLIT_NO_OUTPUT if a file failed
+		void publish(void);             // hands all gathered lines to the writers
+		bool is_open(void) const { return(opened); }
+
+		// counters
+		unsigned long long lines;       // lines routed
+		unsigned long types;            // sinks opened
+
+	protected:
+		int_type overflow(int_type c);
+		int sync(void);
+
+	private:
+		struct Sink {
+			vector<ofstream *> files;       // one (CSV) or one per column
+			vector<string> pending;         // gathered text per file
+			size_t pendingBytes;
+			int fixedColumns;               // columns before the repeated blocks, 0 => CSV
+			int blockColumns;               // columns per repeated block
+			deque< vector<string> > queue;  // batches handed over, not yet written
+			bool scheduled;                 // in ready or being written
+		};
+
+		SplitOutputBuf(const SplitOutputBuf &);   // not copyable
+		SplitOutputBuf & operator=(const SplitOutputBuf &);
+
+		string prefix;
+		int format;
+		bool append;
+		bool opened;
+		vector<char> buffer;            // put area
+		map<string, Sink *> sinks;
+		string key;                     // type of the line being routed
+		Sink * last;                    // sink of the previous line
+		string lastKey;
+
+		vector<thread> writers;
+		mutex lock;
+		condition_variable wake;        // a sink is ready, or stopping
+		condition_variable space;       // a batch was written
+		deque<Sink *> ready;            // sinks with batches and no writer
+		size_t queuedBytes;
+		bool stopping;
+		bool failed;
+
+		// methods
+		void write(void);               // writer thread
+		void route(void);               // routes the complete lines of the put area
+		void routeLine(const char * line, size_t length);
+		Sink * openSink(void);
+		void hand(Sink * sink);
+};
+
+#endif  // LIBSPLIT_H
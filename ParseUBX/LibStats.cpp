@@ -0,0 +1,206 @@
+//**************************************************************
+// Parser statistics
+//   - this file implements the per-thread parse counters and
+//     the progress reporter thread.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include <iomanip>
+#include <cstring>
+#include <chrono>
+#include "LibStats.h"
+#include "LibUBX.h"
+
+using namespace std;
+
+// message types with their own slot, NMEA and other follow
+static const struct { int messageClass; int messageID; const char * name; } statsTypes[STATS_NUM_TYPES - 2] = {
+	{ NAV, CLOCK,   "NAV-CLOCK"   },
+	{ NAV, DGPS,    "NAV-DGPS"    },
+	{ NAV, DOP,     "NAV-DOP"     },
+	{ NAV, POSECEF, "NAV-POSECEF" },
+	{ NAV, POSLLH,  "NAV-POSLLH"  },
+	{ NAV, SBAS,    "NAV-SBAS"    },
+	{ NAV, SOL,     "NAV-SOL"     },
+	{ NAV, STATUS,  "NAV-STATUS"  },
+	{ NAV, SVINFO,  "NAV-SVINFO"  },
+	{ NAV, TIMEGPS, "NAV-TIMEGPS" },
+	{ NAV, TIMEUTC, "NAV-TIMEUTC" },
+	{ RXM, EPH,     "RXM-EPH"     },
+	{ RXM, RAW,     "RXM-RAW"     },
+	{ RXM, SFRB,    "RXM-SFRB"    },
+	{ RXM, SVSI,    "RXM-SVSI"    },
+	{ RXM, SFRBX,   "RXM-SFRBX"   },
+	{ RXM, RAWX,    "RXM-RAWX"    },
+	{ RXM, MEASX,   "RXM-MEASX"   },
+	{ AID, HUI,     "AID-HUI"     },
+	{ AID, EPH,     "AID-EPH"     }
+};
+
+// parseStats: statistics shared by all parsers of the program
+ParseStats & parseStats(void)
+{
+	static ParseStats stats;
+	return(stats);
+}
+
+// ParseStats: default constructor
+ParseStats::ParseStats()
+{
+	reset();
+}
+
+// local: counter block of the calling thread, assigned on first use
+ParseCounters & ParseStats::local(void)
+{
+	static atomic<unsigned int> threadCount(0);
+	static thread_local unsigned int block = threadCount.fetch_add(1) % STATS_MAX_THREADS;
+
+	return(blocks[block]);
+}
+
+// snapshot: sums the blocks of all threads
+void ParseStats::snapshot(ParseSnapshot &total) const
+{
+	memset(&total, 0, sizeof(total));
+
+	for(int b = 0; b < STATS_MAX_THREADS; b++)
+	{
+		const ParseCounters &c = blocks[b];
+		total.frames         += c.frames.load(memory_order_relaxed);
+		total.bytes          += c.bytes.load(memory_order_relaxed);
+		total.checksumErrors += c.checksumErrors.load(memory_order_relaxed);
+		total.resyncs        += c.resyncs.load(memory_order_relaxed);
+		total.skippedBytes   += c.skippedBytes.load(memory_order_relaxed);
+		total.skippedTypes   += c.skippedTypes.load(memory_order_relaxed);
+		for(int t = 0; t < STATS_NUM_TYPES; t++)
+		{
+			total.typeFrames[t]      += c.typeFrames[t].load(memory_order_relaxed);
+			total.typeNanoseconds[t] += c.typeNanoseconds[t].load(memory_order_relaxed);
+		}
+	}
+}
+
+// reset: clears all counters (no parser may be running)
+void ParseStats::reset(void)
+{
+	for(int b = 0; b < STATS_MAX_THREADS; b++)
+	{
+		ParseCounters &c = blocks[b];
+		c.frames.store(0);
+		c.bytes.store(0);
+		c.checksumErrors.store(0);
+		c.resyncs.store(0);
+		c.skippedBytes.store(0);
+		c.skippedTypes.store(0);
+		for(int t = 0; t < STATS_NUM_TYPES; t++)
+		{
+			c.typeFrames[t].store(0);
+			c.typeNanoseconds[t].store(0);
+		}
+	}
+}
+
+// typeSlot: slot of a UBX class/ID, STATS_OTHER_TYPE if not listed
+int ParseStats::typeSlot(int messageClass, int messageID)
+{
+	for(int t = 0; t < STATS_NUM_TYPES - 2; t++)
+		if(statsTypes[t].messageClass == messageClass && statsTypes[t].messageID == messageID)
+			return(t);
+	return(STATS_OTHER_TYPE);
+}
+
+// typeName: name of a type slot
+string ParseStats::typeName(int slot)
+{
+	if(slot >= 0 && slot < STATS_NUM_TYPES - 2)
+		return(statsTypes[slot].name);
+	if(slot == STATS_NMEA_TYPE)
+		return("NMEA");
+	return("other");
+}
+
+
+// ProgressReporter: default constructor
+ProgressReporter::ProgressReporter()
+{
+	running = false;
+	out = 0;
+	intervalMs = PROGRESS_INTERVAL_MS;
+}
+
+// ~ProgressReporter: destructor
+ProgressReporter::~ProgressReporter(void)
+{
+	stop();
+}
+
+// start: prints the parse totals to out every intervalMs until stop()
+void ProgressReporter::start(ostream &stream, unsigned int interval)
+{
+	stop();
+
+	out = &stream;
+	intervalMs = interval > 0 ? interval : 1;
+	running = true;
+	reporter = thread(&ProgressReporter::report, this);
+}
+
+// stop: prints the final totals and ends the reporter thread
+void ProgressReporter::stop(void)
+{
+	if(!reporter.joinable())
+		return;
+
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_one();
+	reporter.join();
+}
+
+// report: reporter thread
+void ProgressReporter::report(void)
+{
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	chrono::steady_clock::time_point next = begin;
+	unique_lock<mutex> guard(lock);
+
+	ParseSnapshot first;
+	parseStats().snapshot(first);
+
+	while(running)
+	{
+		next += chrono::milliseconds(intervalMs);
+		wake.wait_until(guard, next, [this] { return(!running); });
+		printLine(chrono::duration<double>(chrono::steady_clock::now() - begin).count(), first.bytes);
+	}
+	*out << endl;
+}
+
+// printLine: one progress line over the previous one
+//   the rate counts the bytes parsed since firstBytes
+void ProgressReporter::printLine(double seconds, unsigned long long firstBytes)
+{
+	ParseSnapshot total;
+	parseStats().snapshot(total);
+	ios::fmtflags flags = out->flags();
+	streamsize precision = out->precision();
+
+	*out << "\r" << total.frames << " messages, ";
+	*out << fixed << setprecision(1) << total.bytes / 1048576.0 << " MB";
+	if(seconds > 0.0)
+		*out << " (" << (total.bytes - firstBytes) / 1048576.0 / seconds << " MB/s)";
+	*out << ", " << total.checksumErrors << " checksum errors";
+	*out << ", " << total.resyncs << " resyncs   " << flush;
+	out->flags(flags);
+	out->precision(precision);
+}
@@ -0,0 +1,124 @@
+//**************************************************************
+// Parser statistics
+//   - this library provides per-thread counters for the
+//     parsing hot path (frames, bytes, checksum failures,
+//     resyncs, unsupported types and per-type decode time)
+//     and a progress reporter that prints them from its own
+//     thread at a limited rate.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBSTATS_H
+#define LIBSTATS_H
+
+// defined constants
+#define STATS_CACHE_LINE    64    // bytes, counter blocks never share a line
+#define STATS_MAX_THREADS   32    // counter blocks, more threads share them
+#define STATS_NUM_TYPES     22    // message types timed separately
+#define STATS_OTHER_TYPE    (STATS_NUM_TYPES - 1)   // any other UBX class/ID
+#define STATS_NMEA_TYPE     (STATS_NUM_TYPES - 2)   // NMEA sentences
+#define PROGRESS_INTERVAL_MS 500  // default time between progress lines
+
+// included libraries
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// custom data types
+// counters of one thread, written with relaxed atomics so that other
+// threads may read them while parsing runs
+struct ParseCounters {
+	atomic<unsigned long long> frames;          // UBX frames and NMEA sentences
+	atomic<unsigned long long> bytes;           // bytes in frames
+	atomic<unsigned long long> checksumErrors;
+	atomic<unsigned long long> resyncs;         // searches for the next sync
+	atomic<unsigned long long> skippedBytes;    // bytes outside any frame
+	atomic<unsigned long long> skippedTypes;    // frames of unsupported types
+	atomic<unsigned long long> typeFrames[STATS_NUM_TYPES];
+	atomic<unsigned long long> typeNanoseconds[STATS_NUM_TYPES];   // decode and CSV output
+	unsigned char pad[STATS_CACHE_LINE];        // keeps the next block off this line
+};
+
+// totals of all threads at one moment
+struct ParseSnapshot {
+	unsigned long long frames;
+	unsigned long long bytes;
+	unsigned long long checksumErrors;
+	unsigned long long resyncs;
+	unsigned long long skippedBytes;
+	unsigned long long skippedTypes;
+	unsigned long long typeFrames[STATS_NUM_TYPES];
+	unsigned long long typeNanoseconds[STATS_NUM_TYPES];
+};
+
+// definition of ParseStats class
+class ParseStats
+{
+	public:
+		// constructors
+		ParseStats();
+
+		// methods
+		ParseCounters & local(void);          // block of the calling thread
+		void snapshot(ParseSnapshot &total) const;
+		void reset(void);
+
+		// type slots
+		static int typeSlot(int messageClass, int messageID);
+		static string typeName(int slot);
+
+	private:
+		ParseStats(const ParseStats &);       // not copyable
+		ParseStats & operator=(const ParseStats &);
+
+		ParseCounters blocks[STATS_MAX_THREADS];
+};
+
+// definition of ProgressReporter class
+class ProgressReporter
+{
+	public:
+		// constructors
+		ProgressReporter();
+
+		// destructor
+		~ProgressReporter(void);
+
+		// methods
+		void start(ostream &out, unsigned int intervalMs = PROGRESS_INTERVAL_MS);
+		void stop(void);
+
+	private:
+		ProgressReporter(const ProgressReporter &);   // not copyable
+		ProgressReporter & operator=(const ProgressReporter &);
+
+		thread reporter;
+		mutex lock;
+		condition_variable wake;
+		bool running;
+		ostream * out;
+		unsigned int intervalMs;
+
+		// methods
+		void report(void);
+		void printLine(double seconds, unsigned long long firstBytes);
+};
+
+// function prototypes
+ParseStats & parseStats(void);       // statistics shared by all parsers
+inline void countStat(atomic<unsigned long long> &counter, unsigned long long n = 1)
+{
+	counter.fetch_add(n, memory_order_relaxed);
+}
+
+#endif  // LIBSTATS_H
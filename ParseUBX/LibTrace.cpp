@@ -0,0 +1,206 @@
+//**************************************************************
+// Span tracing
+//   - this file implements the per-thread span buffers and the
+//     trace writer thread (Chrome trace-event JSON).
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+
+// included libraries
+#include "LibTrace.h"
+
+#ifdef UBX_TRACE
+
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+using namespace std;
+
+// custom data types
+struct TraceEvent {
+	const char * category;
+	const char * name;
+	long long    start;      // ns since traceStart
+	long long    duration;   // ns
+};
+
+struct TraceChunk {
+	unsigned int tid;
+	vector<TraceEvent> events;
+};
+
+// trace state shared by all threads
+static atomic<bool> traceOn(false);
+static atomic<unsigned int> traceThreads(0);
+static chrono::steady_clock::time_point traceEpoch;
+static mutex traceLock;                  // guards the queue, writing and the file
+static condition_variable traceWake;
+static deque<TraceChunk *> traceQueue;
+static bool traceWriting = false;        // writer thread accepts chunks
+static thread traceWriter;
+static ofstream traceFile;
+
+// elapsed: ns since traceStart
+static long long traceClock(void)
+{
+	return(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - traceEpoch).count());
+}
+
+// definition of TraceBuffer class, one per thread
+class TraceBuffer
+{
+	public:
+		TraceBuffer() : tid(++traceThreads), chunk(0) {}
+		~TraceBuffer(void) { handOff(); }
+
+		// add: records an event, handing the chunk off once full
+		void add(const TraceEvent &event)
+		{
+			if(chunk == 0)
+			{
+				chunk = new TraceChunk;
+				chunk->tid = tid;
+				chunk->events.reserve(TRACE_BUFFER_EVENTS);
+			}
+			chunk->events.push_back(event);
+			if(chunk->events.size() >= TRACE_BUFFER_EVENTS)
+				handOff();
+		}
+
+		// handOff: queues the recorded events for the writer
+		void handOff(void)
+		{
+			if(chunk == 0)
+				return;
+
+			bool queued = false;
+			{
+				lock_guard<mutex> guard(traceLock);
+				if(traceWriting && !chunk->events.empty())
+				{
+					traceQueue.push_back(chunk);
+					queued = true;
+				}
+			}
+			if(queued)
+				traceWake.notify_one();
+			else
+				delete chunk;   // tracing stopped, events dropped
+			chunk = 0;
+		}
+
+	private:
+		unsigned int tid;
+		TraceChunk * chunk;
+};
+
+static thread_local TraceBuffer traceBuffer;
+
+// traceWrite: writer thread, appends queued chunks to the file
+static void traceWrite(void)
+{
+	bool first = true;
+	unique_lock<mutex> guard(traceLock);
+
+	while(true)
+	{
+		traceWake.wait(guard, [] { return(!traceQueue.empty() || !traceWriting); });
+		if(traceQueue.empty())
+			break;   // stopped and drained
+
+		TraceChunk * chunk = traceQueue.front();
+		traceQueue.pop_front();
+		guard.unlock();
+
+		for(unsigned int e = 0; e < chunk->events.size(); e++)
+		{
+			const TraceEvent &event = chunk->events[e];
+			traceFile << (first ? "\n" : ",\n");
+			traceFile << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\"";
+			traceFile << ",\"ts\":" << event.start / 1000 << "." << setw(3) << setfill('0') << event.start % 1000;
+			traceFile << ",\"dur\":" << event.duration / 1000 << "." << setw(3) << setfill('0') << event.duration % 1000;
+			traceFile << ",\"pid\":1,\"tid\":" << chunk->tid << "}";
+			first = false;
+		}
+		delete chunk;
+
+		guard.lock();
+	}
+}
+
+// TraceSpan: starts a span if tracing is on
+TraceSpan::TraceSpan(const char * spanCategory, const char * spanName)
+{
+	category = spanCategory;
+	name = spanName;
+	start = traceOn.load(memory_order_relaxed) ? traceClock() : -1;
+}
+
+// ~TraceSpan: records the span in the thread's buffer
+TraceSpan::~TraceSpan(void)
+{
+	if(start < 0)
+		return;
+
+	TraceEvent event;
+	event.category = category;
+	event.name     = name;
+	event.start    = start;
+	event.duration = traceClock() - start;
+	traceBuffer.add(event);
+}
+
+// traceStart: opens the trace file and starts recording spans
+//   returns 0 on success, -1 if tracing is on or the file cannot be opened
+int traceStart(const string &fname)
+{
+	if(traceOn.load())
+		return(-1);
+
+	traceFile.open(fname.c_str(), ios::out | ios::trunc);
+	if(!traceFile.is_open())
+		return(-1);
+	traceFile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	traceEpoch = chrono::steady_clock::now();
+	traceWriting = true;
+	traceWriter = thread(traceWrite);
+	traceOn.store(true);
+
+	return(0);
+}
+
+// traceStop: writes the spans recorded so far and closes the file
+//   spans of threads still running are dropped
+void traceStop(void)
+{
+	if(!traceOn.load())
+		return;
+
+	traceOn.store(false);
+	traceBuffer.handOff();   // calling thread's partial chunk
+
+	{
+		lock_guard<mutex> guard(traceLock);
+		traceWriting = false;
+	}
+	traceWake.notify_one();
+	traceWriter.join();
+
+	traceFile << "\n]}" << endl;
+	traceFile.close();
+}
+
+#endif // UBX_TRACE
@@ -0,0 +1,70 @@
+//**************************************************************
+// Span tracing
+//   - this library records timed spans of the parsing and
+//     positioning stages into per-thread buffers and writes
+//     them from a background thread as Chrome trace-event
+//     JSON (chrome://tracing, ui.perfetto.dev).
+//   - tracing is compiled in only when UBX_TRACE is defined;
+//     otherwise the TRACE_* macros expand to nothing.
+//**************************************************************
+// Programmer: Guoyu Fu
+// Date: 2026 Oct. 19
+//**************************************************************
+// Change Log:
+//   - 2026 Oct. 19 - Created.
+//
+//**************************************************************
+#ifndef LIBTRACE_H
+#define LIBTRACE_H
+
+// defined constants
+#define TRACE_BUFFER_EVENTS 4096   // events a thread records before handing them off
+
+#ifdef UBX_TRACE
+
+// included libraries
+#include <string>
+
+using namespace std;
+
+// definition of TraceSpan class
+//   records one complete event from construction to destruction;
+//   name and category must be string literals
+class TraceSpan
+{
+	public:
+		// constructors
+		TraceSpan(const char * category, const char * name);
+
+		// destructor
+		~TraceSpan(void);
+
+	private:
+		TraceSpan(const TraceSpan &);            // not copyable
+		TraceSpan & operator=(const TraceSpan &);
+
+		const char * category;
+		const char * name;
+		long long start;                         // ns since traceStart, -1 when off
+};
+
+// function prototypes
+int  traceStart(const string &fname);   // 0 on success, -1 if the file cannot be opened
+void traceStop(void);                   // call after worker threads have ended
+
+// span macros
+#define TRACE_JOIN2(a, b)        a##b
+#define TRACE_JOIN(a, b)         TRACE_JOIN2(a, b)
+#define TRACE_SPAN(category, name) TraceSpan TRACE_JOIN(traceSpan, __LINE__)(category, name)
+#define TRACE_START(fname)       traceStart(fname)
+#define TRACE_STOP()             traceStop()
+
+#else  // UBX_TRACE
+
+#define TRACE_SPAN(category, name)
+#define TRACE_START(fname)       ((void)0)
+#define TRACE_STOP()             ((void)0)
+
+#endif // UBX_TRACE
+
+#endif  // LIBTRACE_H
@@ -16,6 +16,8 @@
 #include <iomanip>
 #include <cstring>
 #include "LibUBX.h"
+#include "LibStats.h"
+#include "LibTrace.h"
 #include <bitset>
 
 using namespace std;
@@ -37,12 +39,15 @@ UBXMessage::UBXMessage()  // default constructor
 
 UBXMessage::UBXMessage(const UBXMessage& message)  // copy constructor
 {
+	payload = 0;  // nothing to release before the copy
+
 	// use overloaded assignment operator to copy
 	*this = message;
 }
 
 UBXMessage::UBXMessage(char * buffer, int bufferSize)
 {
+	TRACE_SPAN("parse", "decode");
 
 	UBXHeader * tempHeader;
 	tempHeader = reinterpret_cast<UBXHeader*>(buffer);
@@ -105,6 +110,7 @@ UBXMessage& UBXMessage::operator=(const UBXMessage &message)
 // function implementatons
 bool UBXMessage::verifyChecksum(void)
 {
+	TRACE_SPAN("parse", "checksum");
 	// calculate packet checksum
 	U1 ck_A = 0;
 	U1 ck_B = 0;
@@ -134,12 +140,13 @@ bool UBXMessage::verifyChecksum(void)
 	return(true);
 }
 
-int UBXMessage::writeCSV(ofstream &outFile)
+int UBXMessage::writeCSV(ostream &outFile)
 {
+	TRACE_SPAN("parse", "format");
 	int bytesWritten = 0;
 
-	// check that file is ready
-	if(!outFile.is_open())
+	// check that the output is ready
+	if(!outFile)
 		return(0);
 
 	switch(header.MessageClass)
@@ -181,8 +188,8 @@ int UBXMessage::writeCSV(ofstream &outFile)
 				case TIMEUTC:
 					bytesWritten = writeNAV_TIMEUTC(outFile);
 					break;
-				default:
-					cout << "Unsupported NAV message ID!" << endl;
+				default:  // unsupported NAV message ID
+					countStat(parseStats().local().skippedTypes);
 			}
 			break;
 			
@@ -222,8 +229,8 @@ int UBXMessage::writeCSV(ofstream &outFile)
 				case SFRB:
 					//bytesWritten = writeRXM_SFRB(outFile);
 					break;
-				default:
-					cout << "Unsupported RXM message ID!" << endl;
+				default:  // unsupported RXM message ID
+					countStat(parseStats().local().skippedTypes);
 			}
 			break;
 			
@@ -235,27 +242,20 @@ int UBXMessage::writeCSV(ofstream &outFile)
 					break;
 				case HUI:
 					bytesWritten = writeAID_HUI(outFile);
-				default:
-					cout << "Unsupported AID message ID!" << endl;
+					break;
+				default:  // unsupported AID message ID
+					countStat(parseStats().local().skippedTypes);
 			}
 			break;
 			
-		default:
-			//cout << "Unsupported message class!" << endl;
-			/*DEBUG-Start*/
-			cout << "Unsupported message class!";
-			cout << "  Message: 0x";
-			cout << hex << setfill('0') << setw(2);
-			cout << static_cast<unsigned>(header.MessageClass) << " 0x";
-			cout << setw(2) << static_cast<unsigned>(header.MessageID);
-			cout << dec << endl;
-			/*DEBUG-End*/
+		default:  // unsupported message class, counted in the parse statistics
+			countStat(parseStats().local().skippedTypes);
 	}
 
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_CLOCK(ofstream &outFile)
+int UBXMessage::writeNAV_CLOCK(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -286,7 +286,7 @@ int UBXMessage::writeNAV_CLOCK(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_DGPS(ofstream &outFile)
+int UBXMessage::writeNAV_DGPS(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -342,7 +342,7 @@ int UBXMessage::writeNAV_DGPS(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_DOP(ofstream &outFile)
+int UBXMessage::writeNAV_DOP(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -377,7 +377,7 @@ int UBXMessage::writeNAV_DOP(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_POSECEF(ofstream &outFile)
+int UBXMessage::writeNAV_POSECEF(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -409,7 +409,7 @@ int UBXMessage::writeNAV_POSECEF(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_POSLLH(ofstream &outFile)
+int UBXMessage::writeNAV_POSLLH(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -443,7 +443,7 @@ int UBXMessage::writeNAV_POSLLH(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_SBAS(ofstream &outFile)
+int UBXMessage::writeNAV_SBAS(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -510,7 +510,7 @@ int UBXMessage::writeNAV_SBAS(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_SOL(ofstream &outFile)
+int UBXMessage::writeNAV_SOL(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -560,7 +560,7 @@ int UBXMessage::writeNAV_SOL(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_STATUS(ofstream &outFile)
+int UBXMessage::writeNAV_STATUS(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -613,7 +613,7 @@ int UBXMessage::writeNAV_STATUS(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_SVINFO(ofstream &outFile)
+int UBXMessage::writeNAV_SVINFO(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -680,7 +680,7 @@ int UBXMessage::writeNAV_SVINFO(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_TIMEGPS(ofstream &outFile)
+int UBXMessage::writeNAV_TIMEGPS(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -719,7 +719,7 @@ int UBXMessage::writeNAV_TIMEGPS(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeNAV_TIMEUTC(ofstream &outFile)
+int UBXMessage::writeNAV_TIMEUTC(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -759,7 +759,7 @@ int UBXMessage::writeNAV_TIMEUTC(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_RAW(ofstream &outFile)
+int UBXMessage::writeRXM_RAW(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -821,7 +821,7 @@ int UBXMessage::writeRXM_RAW(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_RAWX(ofstream &outFile)
+int UBXMessage::writeRXM_RAWX(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -883,7 +883,7 @@ int UBXMessage::writeRXM_RAWX(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_EPH(ofstream &outFile)
+int UBXMessage::writeRXM_EPH(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -916,7 +916,7 @@ int UBXMessage::writeRXM_EPH(ofstream &outFile)
 		if(p_data->how != 0)
 		{	// ephemeris data is present in payload
 			// get pointer to optional block
-			UBXPayload_RXM_EPH_opt * p_block = new UBXPayload_RXM_EPH_opt(payload+8);
+			UBXPayload_RXM_EPH_opt * p_block = new UBXPayload_RXM_EPH_opt(payload);
 			//p_block = reinterpret_cast<UBXPayload_RXM_EPH_opt*>(&payload[sizeof(UBXPayload_RXM_EPH)]);
 
 			outputLine << ",SF1,";
@@ -949,7 +949,7 @@ int UBXMessage::writeRXM_EPH(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_SFRB(ofstream &outFile)
+int UBXMessage::writeRXM_SFRB(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -982,7 +982,7 @@ int UBXMessage::writeRXM_SFRB(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_SFRBX(ofstream &outFile)
+int UBXMessage::writeRXM_SFRBX(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -996,12 +996,24 @@ int UBXMessage::writeRXM_SFRBX(ofstream &outFile)
 	outputLine << "SFRBX,";
 
 	// write payload content to output line
-	outputLine << static_cast<unsigned int>(p_data->chn) << ",";  // u-Blox channel number
-	outputLine << static_cast<unsigned int>(p_data->svId) << ",";  // Space Vehicle Identifier (PRN)
-
-																   // output raw subframe buffer data
-	for (int i = 0; i < 10; i++)
-		outputLine << " " << setw(8) << setfill('0') << hex << p_data->dwrd[i];
+	outputLine << static_cast<unsigned int>(p_data->gnssId) << ",";    // GNSS identifier
+	outputLine << static_cast<unsigned int>(p_data->svId) << ",";      // Space Vehicle Identifier (PRN)
+	outputLine << static_cast<unsigned int>(p_data->numWords) << ",";  // number of data words
+	outputLine << static_cast<unsigned int>(p_data->chn) << ",";       // u-Blox channel number
+
+	// output raw subframe buffer data, the words the message holds (SBAS
+	// and GLONASS carry fewer than 10), read little endian from the payload
+	unsigned int numWords = p_data->numWords;
+	unsigned int inPayload = header.length >= 8 ? (header.length - 8) / 4 : 0;
+	if(numWords > inPayload)
+		numWords = inPayload;
+	for (unsigned int i = 0; i < numWords; i++)
+	{
+		const U1 * p = &payload[8 + 4 * i];
+		unsigned long word = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<unsigned long>(p[3]) << 24);
+		outputLine << " " << setw(8) << setfill('0') << hex << word;
+	}
+	outputLine << dec;
 
 	outputLine << endl;
 
@@ -1015,7 +1027,7 @@ int UBXMessage::writeRXM_SFRBX(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeRXM_MEASX(ofstream &outFile)
+int UBXMessage::writeRXM_MEASX(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -1078,7 +1090,7 @@ int UBXMessage::writeRXM_MEASX(ofstream &outFile)
 }
 
 
-int UBXMessage::writeAID_EPH(ofstream &outFile)
+int UBXMessage::writeAID_EPH(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -1137,7 +1149,7 @@ int UBXMessage::writeAID_EPH(ofstream &outFile)
 	return(bytesWritten);
 }
 
-int UBXMessage::writeAID_HUI(ofstream &outFile)
+int UBXMessage::writeAID_HUI(ostream &outFile)
 {
 	int bytesWritten = 0;     // number of bytes written to output file
 	stringstream outputLine;  // string stream in which to build output line for file
@@ -50,6 +50,7 @@
 
 // included libraries
 #include <fstream>
+#include <cstring>
 
 using namespace std;
 
@@ -493,29 +494,29 @@ class UBXMessage
 
 		// methods
 		bool verifyChecksum(void);
-		int  writeCSV(ofstream &outFile);
+		int  writeCSV(ostream &outFile);
 
 	private:
 		// methods to output CSV data from UBX messages
-		int writeNAV_CLOCK(ofstream &outFile);
-		int writeNAV_DGPS(ofstream &outFile);
-		int writeNAV_DOP(ofstream &outFile);
-		int writeNAV_POSECEF(ofstream &outFile);
-		int writeNAV_POSLLH(ofstream &outFile);
-		int writeNAV_SBAS(ofstream &outFile);
-		int writeNAV_SOL(ofstream &outFile);
-		int writeNAV_STATUS(ofstream &outFile);
-		int writeNAV_SVINFO(ofstream &outFile);
-		int writeNAV_TIMEGPS(ofstream &outFile);
-		int writeNAV_TIMEUTC(ofstream &outFile);
-		int writeRXM_RAW(ofstream &outFile);
-		int writeRXM_RAWX(ofstream &outFile);
-		int writeRXM_SFRB(ofstream &outFile);
-		int writeRXM_SFRBX(ofstream &outFile);
-		int writeRXM_MEASX(ofstream &outFile);
-		int writeRXM_EPH(ofstream &outFile);
-		int writeAID_EPH(ofstream &outFile);
-		int writeAID_HUI(ofstream &outFile);
+		int writeNAV_CLOCK(ostream &outFile);
+		int writeNAV_DGPS(ostream &outFile);
+		int writeNAV_DOP(ostream &outFile);
+		int writeNAV_POSECEF(ostream &outFile);
+		int writeNAV_POSLLH(ostream &outFile);
+		int writeNAV_SBAS(ostream &outFile);
+		int writeNAV_SOL(ostream &outFile);
+		int writeNAV_STATUS(ostream &outFile);
+		int writeNAV_SVINFO(ostream &outFile);
+		int writeNAV_TIMEGPS(ostream &outFile);
+		int writeNAV_TIMEUTC(ostream &outFile);
+		int writeRXM_RAW(ostream &outFile);
+		int writeRXM_RAWX(ostream &outFile);
+		int writeRXM_SFRB(ostream &outFile);
+		int writeRXM_SFRBX(ostream &outFile);
+		int writeRXM_MEASX(ostream &outFile);
+		int writeRXM_EPH(ostream &outFile);
+		int writeAID_EPH(ostream &outFile);
+		int writeAID_HUI(ostream &outFile);
 
 };
 
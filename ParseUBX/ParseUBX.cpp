@@ -1,31 +1,39 @@
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <cstring>
 
 #include "ParseUBX.h"
 using namespace std;
 
-int UBXParser::open(string fname)
+UBXParser::~UBXParser()
 {
-	// TODO, close the in_file if it is open
-	if( in_file_p != NULL && in_file_p->is_open() )
+	close();
+	delete input_p;
+	delete nav_p;
+}
+
+int UBXParser::open(string fname, long long start)
+{
+	close();
+
+	if( input_p == NULL)
 	{
-		in_file_p->close();
-		in_file_p = NULL;
+		input_p = new LogInputBuf();
 	}
 
-	if( in_file_p == NULL)
+	// Step 1 : open the file, plain, gzip or zstd compressed, or a .ubz
+	// archive (a read-ahead thread decompresses it for the parser)
+	input_p->follow(following, followIdle * 1000);
+	int res = input_p->open(fname, 0, start);
+	if(res == INPUT_UNSUPPORTED)
 	{
-		in_file_p = new basic_ifstream<unsigned char>();
+		cout << "Compressed input file, but this build has no " << (input_p->format() == INPUT_GZIP ? "gzip (UBX_ZLIB)" : "zstd (UBX_ZSTD)") << " support!" << endl << endl;
+		return 1;
 	}
-
-	// Step 1 : check whether the file exist
-	// TODO
-	in_file_p->open(fname.c_str(), ios::in|ios::binary);	
-	if(!in_file_p->is_open())
+	if(res != INPUT_OK)
 	{
 		cout << "Unable to open input file!" << endl << endl;
-		in_file_p->close();
-		in_file_p = NULL;
 		return 1;
 	}
 
@@ -34,74 +42,200 @@ int UBXParser::open(string fname)
 	// TODO
 
 	// Step 3 : open the file open handler
+	in_file_p = new basic_istream<unsigned char>(input_p);
+	heldCount = 0;
+	heldPos = 0;
+	searching = false;
+	frameEnd = position();
+	return 0;
+}
+
+int UBXParser::open(const unsigned char* data, size_t length)
+{
+	close();
+
+	if( input_p == NULL)
+	{
+		input_p = new LogInputBuf();
+	}
+
+	input_p->open(data, length);
+	in_file_p = new basic_istream<unsigned char>(input_p);
+	heldCount = 0;
+	heldPos = 0;
+	searching = false;
+	frameEnd = position();
 	return 0;
 }
 
-int UBXParser::writecsv(string outname)
+void UBXParser::close(void)
 {
-	int res = 0;
+	delete in_file_p;
+	in_file_p = NULL;
+	if( input_p != NULL )
+	{
+		input_p->close();
+	}
+}
+
+int UBXParser::writecsv(string outname, bool append)
+{
+	TRACE_SPAN("parse", "writecsv");
 	// Step 1 : 
 	ofstream out_file;
+	SplitOutputBuf split_buf;       // per type outputs, when splitting
+	ostream split_file(&split_buf);
+	ostream &out = splitting ? split_file : out_file;
 	
 	int messageLength;
-	int messagesProcessed = 0;
+	bool cut = false;         // the log ends inside a frame
+	ParseCounters &stats = parseStats().local();
+	ProgressReporter progress;
 
-	out_file.open(outname.c_str(),ios::out);
-	if(!out_file.is_open())
+	if(splitting)
+	{	// the type files are created with their first lines
+		string prefix = outname;
+		if(prefix.size() >= 4 && prefix.compare(prefix.size() - 4, 4, ".csv") == 0)
+		{
+			prefix.erase(prefix.size() - 4);
+		}
+		split_buf.open(prefix, splitFormat, splitThreads, append);
+	}
+	else
 	{
-		cout << "Unable to open output file!" << endl << endl;
-		in_file_p->close();
-		return 1;
+		out_file.open(outname.c_str(),append ? ios::out | ios::app : ios::out);
+		if(!out_file.is_open())
+		{
+			cout << "Unable to open output file!" << endl << endl;
+			close();
+			return 1;
+		}
 	}
 
 	if(log)
 	{
 		cout << "Processing Logfile Messages" << endl;
-		cout << "Message Count:" << endl;
 	}
+	progress.start(cout);
 
-	// process messages from file
-	while(!in_file_p->eof())
+	// process messages until end of file, or a read error (a closed serial
+	// port or pty ends with one)
+	while(in_file_p->good())
 	{
+		// nothing is buffered, so the next read may wait for a live stream
+		// or a followed log: let the output show what is decoded so far
+		if(in_file_p->rdbuf()->in_avail() == 0)
+		{
+			TRACE_SPAN("output", "flush");
+			if(splitting)
+				split_buf.publish();
+			else
+				out_file.flush();
+		}
+
 		// find start of a message
-		in_file_p->read(&buffer[0], 1);
+		long long start = position();
+		take(&buffer[0], 1);
+		if(!in_file_p->good())
+		{	// end of the log between frames
+			break;
+		}
 		
 		if(buffer[0] == '$')
 		{
+			frameArrival = input_p->arrival(start);
 
 			/*DEBUG cout << "Found NMEA message..." << endl;*/
 			messageLength = readNMEA(buffer, BUFFER_SIZE);
-			res = processNMEAMessage(out_file, buffer, messageLength);
-			messagesProcessed++;
+			if(!in_file_p->good())
+			{	// cut by the end of the log, not a checksum error
+				cut = true;
+				break;
+			}
+			if(processNMEAMessage(out, buffer, messageLength) != 0)
+			{	// counted, scanned again after the '$'
+				reject(messageLength);
+				continue;
+			}
+			frameEnd = position();
+			countStat(stats.frames);
+			countStat(stats.bytes, messageLength);
+			searching = false;
 		}
 		else if(static_cast<unsigned char>(buffer[0]) == 0xb5)
 		{
-			if(!in_file_p->eof())
+			frameArrival = input_p->arrival(start);
+			take(&buffer[1], 1);
+			if(!in_file_p->good())
 			{
-				in_file_p->read(&buffer[1], 1);
-				if(buffer[1] = 'b')
-				{
-					/*DEBUG cout << "Found UBX message..." << endl;*/
-					messageLength = readUBX(buffer, BUFFER_SIZE);
-					res = processUBXMessage(out_file, buffer, messageLength);
-					messagesProcessed++;
-				}
+				cut = true;
+				break;
+			}
+			if(buffer[1] != 'b')
+			{	// not a sync pair, the second byte may start a frame
+				reject(2);
+				continue;
 			}
+
+			/*DEBUG cout << "Found UBX message..." << endl;*/
+			messageLength = readUBX(buffer, BUFFER_SIZE);
+			if(!in_file_p->good())
+			{
+				cut = true;
+				break;
+			}
+			if(messageLength == 0)
+			{	// length beyond any frame: damaged or mis-synced
+				reject(sizeof(UBXHeader));
+				continue;
+			}
+			if(processUBXMessage(out, buffer, messageLength) != 0)
+			{	// counted, the declared length may be damaged too: scanned
+				// again after the 0xB5
+				reject(messageLength);
+				continue;
+			}
+			frameEnd = position();
+			countStat(stats.frames);
+			countStat(stats.bytes, messageLength);
+			searching = false;
+		}
+		else
+		{	// not the start of a message
+			countStat(stats.skippedBytes);
+			if(!searching)
+				countStat(stats.resyncs);
+			searching = true;
 		}
+	}
 
-		if( res != 0 )
+	progress.stop();
+	if(splitting)
+	{
+		int res;
 		{
-			out_file.close();
-			break;
+			TRACE_SPAN("output", "flush");   // waits for the writer threads
+			res = split_buf.close();
 		}
-		cout << "\r" << messagesProcessed << " ";
-		if (messagesProcessed == 12760) {
-			int dfasdfa;
-			dfasdfa = 1;
+		if(res != SPLIT_OK)
+		{
+			cout << "Unable to write all per type output files!" << endl;
 		}
+		cout << split_buf.lines << " lines split into " << split_buf.types << " message types." << endl;
+	}
+	else
+	{
+		TRACE_SPAN("output", "flush");
+		out_file.close();
+	}
+	if(input_p->failed())
+	{
+		cout << "Compressed input damaged, messages after the damage not processed!" << endl;
+	}
+	if(cut)
+	{
+		cout << "Last frame incomplete, not processed (resume at offset " << frameEnd << ")." << endl;
 	}
-
-	cout << endl;
 	cout << "All messages processed." << endl;
 
 	return 0;
@@ -109,49 +243,107 @@ int UBXParser::writecsv(string outname)
 
 int UBXParser::read_next_ubx(UBXMessage & um)
 {
+	const unsigned char* frame;
 	int messageLength = 0;
+	ParseCounters &stats = parseStats().local();
 
-	while(true){
-		if( in_file_p->eof() )
+	while(read_next_frame(frame, messageLength) == 0)
+	{
+		long long framed = latencyClock();
+		if(frame[0] == '$')
 		{
-			cout << "end of file, cannot read more" << endl;
-			return 1;
+			latencyStats().record(STATS_NMEA_TYPE, LATENCY_FRAMED, frameArrival, framed);
+			countStat(stats.frames);
+			countStat(stats.bytes, messageLength);
+			countStat(stats.typeFrames[STATS_NMEA_TYPE]);
+			searching = false;
+			continue;
 		}
-		
+
+		um = UBXMessage(reinterpret_cast<char *>(buffer), messageLength);
+		//UBXMessage message(reinterpret_cast<char *>(buffer), bufferSize);
+		if(!um.verifyChecksum())
+		{	// the declared length may be damaged too: scanned again after the 0xB5
+			countStat(stats.checksumErrors);
+			reject(messageLength);
+			return 2;
+		}
+		int slot = ParseStats::typeSlot(um.header.MessageClass, um.header.MessageID);
+		countStat(stats.frames);
+		countStat(stats.bytes, messageLength);
+		countStat(stats.typeFrames[slot]);
+		searching = false;
+		latencyStats().record(slot, LATENCY_FRAMED, frameArrival, framed);
+		latencyStats().record(slot, LATENCY_DECODED, frameArrival, latencyClock());
+		return 0;
+	}
+
+	if(input_p->failed())
+	{
+		cout << "compressed input damaged, cannot read more" << endl;
+	}
+	cout << "end of file, cannot read more" << endl;
+	return 1;
+}
+
+int UBXParser::read_next_frame(const unsigned char* &frame, int &length)
+{
+	ParseCounters &stats = parseStats().local();
+
+	while(in_file_p->good())
+	{
 		// find start of a message
-		in_file_p->read(&buffer[0], 1);		
+		long long start = position();
+		take(&buffer[0], 1);
+		if(!in_file_p->good())
+		{
+			break;
+		}
 		if(buffer[0] == '$')
 		{
-			messageLength = readNMEA(buffer, BUFFER_SIZE);
-			continue;
+			frameArrival = input_p->arrival(start);
+			length = readNMEA(buffer, BUFFER_SIZE);
+			if(!in_file_p->good())
+			{	// cut by the end of the log
+				break;
+			}
+			frameEnd = position();
+			frame = buffer;
+			return 0;
 		}
 		else if(static_cast<unsigned char>(buffer[0]) == 0xb5)
 		{
-			if(!in_file_p->eof())
+			frameArrival = input_p->arrival(start);
+			take(&buffer[1], 1);
+			if(!in_file_p->good())
 			{
-				in_file_p->read(&buffer[1], 1);
-				//if(buffer[1] == 'b')
-				if(buffer[1] == 'b')
-				{
-					messageLength = readUBX(buffer, BUFFER_SIZE);
-					um = UBXMessage(reinterpret_cast<char *>(buffer), messageLength);
-					//UBXMessage message(reinterpret_cast<char *>(buffer), bufferSize);
-					if(!um.verifyChecksum())
-					{
-						cout << "check sum error"<< endl;
-						return 1;
-					}
-					else
-					{
-						return 0;
-					}
-				}
+				break;
 			}
-			else
-			{
-				cout << "read file error" << endl;
-				return 1;
+			if(buffer[1] != 'b')
+			{	// not a sync pair, the second byte may start a frame
+				reject(2);
+				continue;
+			}
+			length = readUBX(buffer, BUFFER_SIZE);
+			if(!in_file_p->good())
+			{	// cut by the end of the log, not a checksum error
+				break;
 			}
+			if(length == 0)
+			{	// length beyond any frame: damaged or mis-synced
+				reject(sizeof(UBXHeader));
+				continue;
+			}
+			frameEnd = position();
+			frame = buffer;
+			return 0;
+		}
+		else
+		{	// not the start of a message
+			countStat(stats.skippedBytes);
+			if(!searching)
+				countStat(stats.resyncs);
+			searching = true;
 		}
 	}
 
@@ -160,12 +352,14 @@ int UBXParser::read_next_ubx(UBXMessage & um)
 
 int UBXParser::readNMEA(unsigned char* buffer, int bufferSize)
 {
+	TRACE_SPAN("parse", "read NMEA");
 	int index = 0;
-	// read NMEA message from file into buffer
-	while(!in_file_p->eof() && buffer[index] != '\n')
+	// read NMEA message from file into buffer, a sentence without end that
+	// fills the buffer is cut there and fails its checksum
+	while(in_file_p->good() && buffer[index] != '\n' && index + 1 < bufferSize)
 	{	// '$' is already in buffer at buffer[0], remaining chars start at buffer[1]
 		index++;
-		in_file_p->read(&buffer[index], 1);
+		take(&buffer[index], 1);
 	}
 	// return length of message (index is position of last char)
 	return (index+1);
@@ -173,49 +367,137 @@ int UBXParser::readNMEA(unsigned char* buffer, int bufferSize)
 
 int UBXParser::readUBX(unsigned char* buffer, int bufferSize)
 {
+	TRACE_SPAN("parse", "read UBX");
 	UBXHeader * header;
 	// read UBX header to get length to read
-	in_file_p->read(&buffer[2], sizeof(UBXHeader) - 2);
+	take(&buffer[2], sizeof(UBXHeader) - 2);
 	header = reinterpret_cast<UBXHeader*>(buffer);
+	if(!in_file_p->good())
+	{
+		return(0);
+	}
+	// a length from the stream beyond the buffer is not a frame (the
+	// caller rejects the header)
+	if(header->length > bufferSize - sizeof(UBXHeader) - sizeof(UBXChecksum))
+	{
+		return(0);
+	}
 	// read bytes (length + 2 bytes for checksum)
-	in_file_p->read(&buffer[sizeof(UBXHeader)], header->length + sizeof(UBXChecksum));
+	take(&buffer[sizeof(UBXHeader)], header->length + sizeof(UBXChecksum));
 	// compute and return overall message length
 	return(sizeof(UBXHeader) + header->length + sizeof(UBXChecksum));
 }
 
-int UBXParser::processNMEAMessage(ofstream &outFile,unsigned char* buffer, int bufferSize)
+// take: reads bytes, those held back first
+void UBXParser::take(unsigned char* to, int count)
 {
+	while(count > 0 && heldPos < heldCount)
+	{
+		*to++ = held[heldPos++];
+		count--;
+	}
+	if(count > 0)
+	{
+		in_file_p->read(to, count);
+	}
+}
+
+// hold: puts bytes back in front of those not taken yet
+void UBXParser::hold(const unsigned char* from, int count)
+{
+	int rest = heldCount - heldPos;
+	memmove(&held[count], &held[heldPos], rest);
+	memcpy(held, from, count);
+	heldCount = count + rest;
+	heldPos = 0;
+}
+
+// reject: the first length bytes of buffer turned out not to be a frame;
+//   the first is skipped (counted), the others are scanned again
+void UBXParser::reject(int length)
+{
+	ParseCounters &stats = parseStats().local();
+
+	hold(&buffer[1], length - 1);
+	countStat(stats.skippedBytes);
+	if(!searching)
+		countStat(stats.resyncs);
+	searching = true;
+}
+
+int UBXParser::processNMEAMessage(ostream &outFile,unsigned char* buffer, int bufferSize)
+{
+	TRACE_SPAN("parse", "NMEA");
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ParseCounters &stats = parseStats().local();
+	LatencyStats &latency = latencyStats();
+	latency.record(STATS_NMEA_TYPE, LATENCY_FRAMED, frameArrival, latencyClock());
+
 	string message(reinterpret_cast<char *>(buffer), bufferSize);  // convert buffered message to a string
 	if (message.size() < 5) return 0;
 																   // write NMEA message to output file
 	if(verifyChecksum(message))
 	{
+		latency.record(STATS_NMEA_TYPE, LATENCY_DECODED, frameArrival, latencyClock());
 		outFile << message.substr(0,message.length() - 2);  // strip off <CR><LF>
 		outFile << endl;
 		/*DEBUG cout << message;*/
+		latency.record(STATS_NMEA_TYPE, LATENCY_OUTPUT, frameArrival, latencyClock());
 	}
 	else
-	{
-		cout << "Checksum error!" << endl;
-		return 1;
+	{	// counted, reported with the statistics
+		countStat(stats.checksumErrors);
+		return 2;
 	}
+
+	countStat(stats.typeFrames[STATS_NMEA_TYPE]);
+	countStat(stats.typeNanoseconds[STATS_NMEA_TYPE],
+		chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
 	
 	return 0;
 }
 
-int UBXParser::processUBXMessage(ofstream &outFile,unsigned char* buffer, int bufferSize)
+int UBXParser::processUBXMessage(ostream &outFile,unsigned char* buffer, int bufferSize)
 {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ParseCounters &stats = parseStats().local();
+	LatencyStats &latency = latencyStats();
+	long long framed = latencyClock();
+
 	//string message(reinterpret_cast<char *>(buffer), bufferSize);  // convert buffered message to a string
 	UBXMessage message(reinterpret_cast<char *>(buffer), bufferSize);
+	int slot = ParseStats::typeSlot(message.header.MessageClass, message.header.MessageID);
 	if(message.verifyChecksum())
 	{
+		latency.record(slot, LATENCY_FRAMED, frameArrival, framed);
+		latency.record(slot, LATENCY_DECODED, frameArrival, latencyClock());
 		message.writeCSV(outFile);
+
+		// assemble navigation data sets from subframe words
+		if(message.header.MessageClass == RXM && message.header.MessageID == SFRBX)
+		{
+			NavRecord record;
+			if(nav_p == NULL)
+			{
+				nav_p = new NavAssembler();
+			}
+			TRACE_SPAN("parse", "nav assembly");
+			if(nav_p->add(message.payload, message.header.length, record) == 1)
+			{
+				writeNavRecord(outFile, record);
+			}
+		}
+		latency.record(slot, LATENCY_OUTPUT, frameArrival, latencyClock());
 	}
 	else
-	{
-		cout << "Checksum error!" << endl;
-		return 1;
+	{	// counted, reported with the statistics
+		countStat(stats.checksumErrors);
+		return 2;
 	}
+
+	countStat(stats.typeFrames[slot]);
+	countStat(stats.typeNanoseconds[slot],
+		chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
 	return 0;
 }
 
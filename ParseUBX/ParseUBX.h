@@ -2,7 +2,13 @@
 #define PARSE_UBX_H
 
 #include "LibUBX.h"
-#include "libNMEA.h"
+#include "LibNMEA.h"
+#include "LibNavMsg.h"
+#include "LibStats.h"
+#include "LibTrace.h"
+#include "LibLatency.h"
+#include "LibInput.h"
+#include "LibSplit.h"
 
 // defined constants
 #define BUFFER_SIZE 4096
@@ -10,25 +16,77 @@
 class UBXParser
 {
 public:
-	UBXParser():log(0),in_file_p(NULL){};
-	int open(string fname);			// initialize the name of the ubx file
+	UBXParser():log(0),in_file_p(NULL),input_p(NULL),nav_p(NULL),frameArrival(0),frameEnd(0),following(false),followIdle(0),splitting(false),splitFormat(SPLIT_CSV),splitThreads(0),heldCount(0),heldPos(0),searching(false){};
+	~UBXParser();
+	int open(string fname, long long start = 0);	// initialize the name of the ubx file (.ubx, .gz, .zst or .ubz), start: offset in a plain log
+	int open(const unsigned char* data, size_t length);	// a plain log in memory, kept valid until close
+	void close(void);
+
+	// follow a log that is still being written (set before open): at its
+	// end wait for appends instead of stopping, until it has not grown for
+	// idleSeconds (0 => never); a frame cut by the end is left for later
+	void follow(bool on, unsigned int idleSeconds = 0) { following = on; followIdle = idleSeconds; }
+
+	// write one output per message type instead of one CSV (set before
+	// writecsv), named after outname without ".csv" (LibSplit.h)
+	//   format: SPLIT_CSV or SPLIT_COLUMNS, threads: writer threads, 0 => default
+	void split(bool on, int format = SPLIT_CSV, unsigned int threads = 0) { splitting = on; splitFormat = format; splitThreads = threads; }
 	
 	// TODO, define the message here
+	// returns 0 => message read, 1 => end of file, 2 => checksum error
 	int read_next_ubx(UBXMessage &um);
 
-	int writecsv(string outname);	// write out the package in csv format
+	// next UBX frame or NMEA sentence, checksum not verified
+	//   frame: its bytes, valid until the next read; length: its length
+	// returns 0 => frame read, 1 => end of file
+	int read_next_frame(const unsigned char* &frame, int &length);
+
+	int writecsv(string outname, bool append = false);	// write out the package in csv format
+
+	// offset in the log just after the last complete frame, where to
+	// start again (open) when the log has grown
+	long long resumeOffset(void) const { return frameEnd; }
+
+	// latencyClock() time the first byte of the last frame was read from
+	// the log, before the read-ahead queue (LibInput.h)
+	long long arrival(void) const { return frameArrival; }
 private:
+	UBXParser(const UBXParser &);	// not copyable, owns the input and assembler
+	UBXParser & operator=(const UBXParser &);
+
 	int log;
 	//ifstream in_file;
 	//basic_ifstream<unsigned char> in_file;
 	// The copy of in_file is not permitted.
-	basic_ifstream<unsigned char> * in_file_p;
+	basic_istream<unsigned char> * in_file_p;
+	// read-ahead/decompressing buffer under in_file_p
+	LogInputBuf * input_p;
+	// RXM-SFRBX assembler, allocated on the first SFRBX message
+	NavAssembler * nav_p;
+	long long frameArrival;
+	long long frameEnd;
+	bool following;
+	unsigned int followIdle;
+	bool splitting;
+	int splitFormat;
+	unsigned int splitThreads;
 	unsigned char buffer[BUFFER_SIZE];
+	// bytes taken out of the stream for a frame that turned out not to be
+	// one (bad sync, length or checksum), scanned again before the stream
+	unsigned char held[BUFFER_SIZE];
+	int heldCount;
+	int heldPos;
+	bool searching;	// skipping bytes outside any frame
 	// forward declarations
 	int readNMEA(unsigned char* buffer, int bufferSize);
-	int readUBX(unsigned char* buffer, int bufferSize);
-	int processNMEAMessage(ofstream &outFile, unsigned char* buffer, int bufferSize);
-	int processUBXMessage(ofstream &outFile, unsigned char* buffer, int bufferSize);
+	int readUBX(unsigned char* buffer, int bufferSize);	// 0 => not a frame, scan on
+	void take(unsigned char* to, int count);
+	void hold(const unsigned char* from, int count);
+	void reject(int length);	// the length bytes in buffer are not a frame
+	long long position(void) const { return input_p->offset() - (heldCount - heldPos); }
+	// return 0 => written, 2 => checksum error (counted, nothing written)
+	int processNMEAMessage(ostream &outFile, unsigned char* buffer, int bufferSize);
+	int processUBXMessage(ostream &outFile, unsigned char* buffer, int bufferSize);
 };
 
 #endif
\ No newline at end of file
@@ -2,22 +2,61 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <cstdlib>
 #include "LibUBX.h"
-#include "libNMEA.h"
+#include "LibNMEA.h"
 #include "ParseUBX.h"
 
 // main program module
+//   ParseUBX [-f idle] [-s offset] [-p csv|col] [input.ubx [output.csv [latency.csv]]]
+//   the input may be a live stream (serial port, pty); with a latency
+//   file the per-type latency percentiles are written to it every second
+//   -f: follow a log that is still being written, new frames are decoded
+//       as they are appended, until it has not grown for idle seconds
+//       (0 => until stopped)
+//   -s: start at an offset of a plain log, given at the end of an earlier
+//       run, and append to the output
+//   -p: one output per message type instead of output.csv, output<CLASS>_<ID>.csv
+//       (the files sep_mess.py used to make), or with col a file per column
 int main(int argc, char* argv[])
 {
 	UBXParser up;
+	LatencyExporter latency;
 	int res;
+	bool follow = false;
+	long long start = 0;
+	vector<string> args;
+
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg == "-f" && i + 1 < argc)
+		{
+			follow = true;
+			up.follow(true, atoi(argv[++i]));
+		}
+		else if(arg == "-s" && i + 1 < argc)
+			start = atoll(argv[++i]);
+		else if(arg == "-p" && i + 1 < argc)
+		{
+			string format = argv[++i];
+			up.split(true, format == "col" ? SPLIT_COLUMNS : SPLIT_CSV);
+		}
+		else
+			args.push_back(arg);
+	}
+
+	TRACE_START("ParseUBX-trace.json");  // only when built with UBX_TRACE
 
 	//get the input data
 	string input;
 	//cout<<"Enter input file (.ubx):\n";
 	//getline(cin,input);
 	input = "ds3_r2.ubx";
-	res = up.open(input);
+	if(args.size() > 0)
+		input = args[0];
+	res = up.open(input, start);
 	if(res != 0)
 	{
 		return res;
@@ -27,11 +66,26 @@ int main(int argc, char* argv[])
 	//cout<<"Enter output file (.csv):\n";
 	//getline(cin,output);
 	output = "ds3-r2.csv";
-	res = up.writecsv(output);
+	if(args.size() > 1)
+		output = args[1];
+
+	if(args.size() > 2 && latency.start(args[2]) != 0)
+	{
+		cout << "Unable to open latency file!" << endl << endl;
+		return 1;
+	}
+
+	res = up.writecsv(output, start > 0);
+	latency.stop();
+	TRACE_STOP();
 	if(res != 0)
 	{
 		return res;
 	}
+	if(follow)
+	{
+		cout << "Log stopped growing, continue with -s " << up.resumeOffset() << endl;
+	}
 
 	return(0);
 }
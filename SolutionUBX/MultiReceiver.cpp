@@ -0,0 +1,248 @@
+//**********************************************************************
+// File:			MultiReceiver.cpp
+// Programmer:		Guoyu Fu
+// Description:		Positions several simultaneous receiver logs together
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+//
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+#include "MultiReceiver.h"
+#include "UBXMeasurements.h"
+#include "..\ParseUBX\LibTrace.h"
+
+using namespace std;
+
+
+// MultiReceiver: default constructor
+MultiReceiver::MultiReceiver()
+{
+	engine = 0;
+	epochsMerged = 0;
+	fixes = 0;
+	nextReceiver.store(0);
+}
+
+// ~MultiReceiver: destructor
+MultiReceiver::~MultiReceiver(void)
+{
+	merger.stop();
+	for(unsigned int r = 0; r < receivers.size(); r++)
+		delete receivers[r];
+}
+
+// addReceiver: adds a .ubx log and the file its solutions are written to
+//   returns 0 on success, -1 if either file cannot be opened
+int MultiReceiver::addReceiver(const string &input, const string &output)
+{
+	Receiver * rx = new Receiver;
+
+	rx->out.open(output.c_str());
+	if(!rx->out.is_open() || merger.add(input) != 0)
+	{
+		delete rx;
+		return(-1);
+	}
+
+	rx->klob.valid = false;
+	rx->fixes = 0;
+	rx->out << "TOW(s),X(m),Y(m),Z(m),b(s),SVs,GDOP" << endl;
+	receivers.push_back(rx);
+
+	return(0);
+}
+
+// setCorrections: correction steps applied to every epoch (copied)
+void MultiReceiver::setCorrections(const CorrectionStage &stage)
+{
+	corrections = stage;
+}
+
+// setSource: SV states from the precise orbit store
+void MultiReceiver::setSource(OrbitInterpolator *orbits)
+{
+	cache.setSource(orbits);
+	engine = 0;
+}
+
+// setSource: SV states from the broadcast ephemerides of all logs
+void MultiReceiver::setSource(SVStateEngine *broadcastEngine)
+{
+	cache.setSource(broadcastEngine);
+	engine = broadcastEngine;
+}
+
+// run: merges and positions all logs to the end
+//   threads: worker threads, 0 => one per hardware thread
+//   returns 0 on success, -1 if no receivers were added
+int MultiReceiver::run(unsigned int threads)
+{
+	MergedEpoch merged;
+
+	if(receivers.empty())
+		return(-1);
+
+	while(merger.next(merged) == 0)
+	{
+		TRACE_SPAN("solve", "decode epoch");
+
+		// ephemerides and ionosphere of every log first, then the measurements
+		for(unsigned int r = 0; r < receivers.size(); r++)
+			decode(*receivers[r], merged.messages[r], false);
+		for(unsigned int r = 0; r < receivers.size(); r++)
+			decode(*receivers[r], merged.messages[r], true);
+
+		if(++epochsMerged % MULTI_BLOCK_EPOCHS == 0)
+		{
+			solveBlock(threads);
+			cout << "\r" << epochsMerged;
+		}
+	}
+	solveBlock(threads);
+	cout << "\r" << epochsMerged << endl;
+
+	return(0);
+}
+
+// decode: takes the messages of one log in one merged epoch
+//   measurements: false => ephemeris and AID-HUI, true => RXM-RAW/RAWX
+void MultiReceiver::decode(Receiver &rx, vector<UBXMessage> &messages, bool measurements)
+{
+	BroadcastEphemeris broadcast;
+	NavRecord record;
+	EpochSVData epoch;
+
+	for(unsigned int m = 0; m < messages.size(); m++)
+	{
+		const UBXMessage &message = messages[m];
+
+		if(!measurements)
+		{
+			if(decodeEphemerisMessage(message, broadcast) == 1)
+			{	// RXM-EPH/AID-EPH subframes
+				if(engine != 0)
+					engine->setEphemeris(broadcast);
+			}
+			else if(message.header.MessageClass == RXM && message.header.MessageID == SFRBX)
+			{	// subframe words, ephemeris once a set is complete
+				if(rx.nav.add(message.payload, message.header.length, record) == 1 &&
+				   decodeNavRecord(record, broadcast) == 0 && engine != 0)
+					engine->setEphemeris(broadcast);
+			}
+			else
+			{
+				decodeKlobucharMessage(message, rx.klob);
+			}
+		}
+		else if(decodeRawEpoch(message, epoch) == 1)
+		{
+			selectUsableSVs(epoch);
+
+			rx.epochs.push_back(ReceiverEpoch());
+			ReceiverEpoch &e = rx.epochs.back();
+			e.week  = epoch.week;
+			e.tow   = epoch.tow;
+			e.numSV = epoch.numSV;
+			for(unsigned int i = 0; i < epoch.numSV; i++)
+			{
+				e.sv[i] = epoch.sv[i];
+				e.pr[i] = epoch.pr[i];
+			}
+			e.slot = cache.prepare(epoch.week, epoch.tow);  // shared by all receivers at this time
+			e.klob = rx.klob;
+		}
+	}
+}
+
+// solveBlock: solves the decoded epochs of every receiver on the pool,
+//   then releases the SV states they used
+void MultiReceiver::solveBlock(unsigned int threads)
+{
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+	if(threads > receivers.size())
+		threads = receivers.size();
+	nextReceiver.store(0);
+
+	// the calling thread works too
+	vector<thread> pool;
+	for(unsigned int t = 1; t < threads; t++)
+		pool.push_back(thread(&MultiReceiver::worker, this));
+	worker();
+	for(unsigned int t = 0; t < pool.size(); t++)
+		pool[t].join();
+
+	for(unsigned int r = 0; r < receivers.size(); r++)
+	{
+		fixes += receivers[r]->fixes;
+		receivers[r]->fixes = 0;
+		receivers[r]->epochs.clear();
+	}
+	cache.clear();
+}
+
+// worker: solves receivers until none are left
+void MultiReceiver::worker(void)
+{
+	CorrectionStage stage = corrections;  // private copy, klob changes per epoch
+
+	while(true)
+	{
+		unsigned int r = nextReceiver.fetch_add(1);
+		if(r >= receivers.size())
+			break;
+
+		solveReceiver(*receivers[r], stage);
+	}
+}
+
+// solveReceiver: solves the pending epochs of one receiver in order and
+//   writes the fixes to its output file
+void MultiReceiver::solveReceiver(Receiver &rx, CorrectionStage &stage)
+{
+	TRACE_SPAN("solve", "receiver block");
+	EpochSVData epoch;
+	BatchFix fix;
+
+	for(unsigned int n = 0; n < rx.epochs.size(); n++)
+	{
+		const ReceiverEpoch &e = rx.epochs[n];
+
+		epoch.week  = e.week;
+		epoch.tow   = e.tow;
+		epoch.numSV = e.numSV;
+		for(unsigned int i = 0; i < e.numSV; i++)
+		{
+			epoch.sv[i] = e.sv[i];
+			epoch.pr[i] = e.pr[i];
+		}
+		cache.apply(e.slot, epoch);  // read only, shared with the other workers
+
+		stage.klob = e.klob;
+		if(rx.solver.solve(epoch, stage, fix) != 0)
+			continue;
+
+		rx.out << fix.tow                     << ",";
+		rx.out << setprecision(15) << fix.x   << ",";
+		rx.out << setprecision(15) << fix.y   << ",";
+		rx.out << setprecision(15) << fix.z   << ",";
+		rx.out << setprecision(15) << fix.clockBias;
+		rx.out << "," << fix.numSV;
+		rx.out << "," << fix.gdop;
+		rx.out << endl;
+		rx.fixes++;
+	}
+}
@@ -0,0 +1,101 @@
+//**********************************************************************
+// File:			MultiReceiver.h
+// Programmer:		Guoyu Fu
+// Description:		Positions several simultaneous receiver logs together
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// The logs are merged epoch by epoch (LogMerger).  The main thread
+// decodes the messages and evaluates the SV states once per epoch in an
+// EpochStateCache shared by all receivers, from one read-only orbit
+// store or one broadcast engine fed by every log.  Every
+// MULTI_BLOCK_EPOCHS merged epochs the receivers are solved on a pool
+// of worker threads, one receiver at a time per thread, so each
+// receiver still sees its epochs in order and only its own corrections
+// and solution are computed per receiver.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef MULTI_RECEIVER_H
+#define MULTI_RECEIVER_H
+
+// defined constants
+#define MULTI_BLOCK_EPOCHS  300   // merged epochs decoded before the receivers are solved
+
+// included libraries
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "..\ParseUBX\LibMerge.h"
+#include "..\ParseUBX\LibNavMsg.h"
+#include "..\GPSUtilities\EpochData.h"
+#include "..\GPSUtilities\SVState.h"
+#include "..\GPSUtilities\OrbitStore.h"
+#include "..\GPSUtilities\Corrections.h"
+#include "..\GPSUtilities\BatchPositioner.h"
+#include "..\GPSUtilities\EpochStateCache.h"
+
+// definition of MultiReceiver class
+class MultiReceiver
+{
+	public:
+		// constructors
+		MultiReceiver();
+
+		// destructor
+		~MultiReceiver(void);
+
+		// methods
+		int  addReceiver(const std::string &input, const std::string &output);
+		void setCorrections(const CorrectionStage &stage);
+		void setSource(OrbitInterpolator *orbits);
+		void setSource(SVStateEngine *engine);
+		int  run(unsigned int threads = 0);
+
+		// statistics
+		unsigned long epochsMerged;
+		unsigned long fixes;
+
+	private:
+		struct ReceiverEpoch {
+			int    week;
+			double tow;
+			unsigned int numSV;
+			int    sv[MAX_EPOCH_SV];
+			double pr[MAX_EPOCH_SV];
+			int    slot;              // SV states in the shared cache
+			KlobucharParams klob;     // ionospheric model in effect
+		};
+
+		struct Receiver {
+			std::ofstream out;
+			NavAssembler nav;         // RXM-SFRBX assembler of this log
+			KlobucharParams klob;     // latest AID-HUI of this log
+			SequentialSolver solver;
+			std::vector<ReceiverEpoch> epochs;   // decoded, not yet solved
+			unsigned long fixes;
+		};
+
+		MultiReceiver(const MultiReceiver &);               // not copyable
+		MultiReceiver & operator=(const MultiReceiver &);
+
+		std::vector<Receiver *> receivers;
+		LogMerger merger;
+		EpochStateCache cache;
+		SVStateEngine * engine;        // broadcast source, NULL with precise orbits
+		CorrectionStage corrections;
+		std::atomic<unsigned int> nextReceiver;
+
+		// methods
+		void decode(Receiver &rx, std::vector<UBXMessage> &messages, bool measurements);
+		void solveBlock(unsigned int threads);
+		void worker(void);
+		void solveReceiver(Receiver &rx, CorrectionStage &stage);
+};
+
+#endif // MULTI_RECEIVER_H
@@ -9,16 +9,21 @@
 #include <vector>
 
 // included GPSTk libraries
-#include "SP3EphemerisStore.hpp"
-#include "DayTime.hpp"
-#include "Xvt.hpp"
-#include "SatID.hpp"
 #include "Matrix.hpp"
 #include "Vector.hpp"
-#include "Bancroft.hpp"
 
 // other included libraries
 #include "..\GPSUtilities\GPSUtilities.h"
+#include "..\GPSUtilities\DirectSolution.h"
+#include "..\GPSUtilities\SVState.h"
+#include "..\GPSUtilities\OrbitStore.h"
+#include "..\GPSUtilities\Corrections.h"
+#include "..\GPSUtilities\BatchPositioner.h"
+#include "..\GPSUtilities\PositionFilter.h"
+#include "MultiReceiver.h"
+#include "..\ParseUBX\ParseUBX.h"
+#include "..\ParseUBX\LibTrace.h"
+#include "UBXMeasurements.h"
 
 using namespace std;
 using namespace gpstk;
@@ -44,6 +49,9 @@ struct RXM_RAW_DATA {
 
 // forward declarations
 bool parseLine(string &fileLine, RXM_RAW_DATA &lineData);
+bool parseEphLine(string &fileLine, int &svid, unsigned int subframes[3][8]);
+bool parseHuiLine(string &fileLine, KlobucharParams &klob);
+void writeFix(ofstream &outFile, const BatchFix &fix);
 
 // main program module
 int main(int argc, char* argv[])
@@ -54,19 +62,34 @@ int main(int argc, char* argv[])
 	ofstream outFile;
 	string fileLine;
 	RXM_RAW_DATA lineData;
+	int ephSV;                      // SV of a parsed RXM-EPH line
+	unsigned int subframes[3][8];   // subframes 1-3 (words 3-10) of a parsed RXM-EPH line
+	bool binaryInput;               // input is a .ubx log read through UBXParser
+	UBXParser ubxIn;                // reader for .ubx input
+	UBXMessage message;             // last message read from .ubx input
+	NavAssembler nav;               // RXM-SFRBX subframe assembler for .ubx input
+	NavRecord record;               // data set completed by nav
+
+	TRACE_START("SolutionUBX-trace.json");  // only when built with UBX_TRACE
 
 	try
 	{
-		//Bancroft solver;                // create a Bancroft GPS solver
-		Matrix<double> dataSV(0,4);       // solver input data
-		Matrix<double> matrixDOP(0,4);    // dilution of precision matrix
-		Vector<double> solution(4);       // GPS solution
-		Vector<double> dataRow(4);        // one data row for solver data matrix
-		SP3EphemerisStore ephem;     // class to store ephemeris data
-		DayTime time;                // store time of interest
-		double userClockBias;        // approximate receiver clock bias
-
-		SatID sv(1,SatID::systemGPS);  // GPS satellite identifier (initialized to PRN #1)
+		SequentialSolver solver;     // per-epoch least squares, warm started epoch to epoch
+		BatchFix fix;                // GPS solution of the current epoch
+		OrbitStore orbits;           // memory-mapped binary SP3 orbit/clock store
+		OrbitInterpolator interpolator(orbits);  // all-SV precise orbit interpolation
+		SVStateEngine svEngine;      // broadcast ephemeris SV state engine
+		BroadcastEphemeris broadcast;  // most recently decoded broadcast ephemeris
+		EpochSVData epoch;           // SV data of the current epoch
+		bool useBroadcast;           // take SV states from logged RXM-EPH instead of IGS
+		bool batchMode;              // collect all epochs, then solve them in parallel
+		BatchPositioner batch;       // epoch store and solver for batch mode
+		bool filterMode;             // track with the Kalman filter instead of per-epoch least squares
+		PositionFilter filter;       // position/velocity/clock filter for filter mode
+		bool multiMode;              // position several simultaneous logs together
+		CorrectionStage corrections; // pseudorange corrections applied before the solver
+		double position[3];          // receiver position used for SV geometry in filter mode
+		LatencyExporter latency;     // arrival-to-fix latencies of .ubx input
 
 		// set times
 		short int week;
@@ -79,23 +102,107 @@ int main(int argc, char* argv[])
 		cout<<"Please enter the start time: (334053.0)\n";
 		cin>>startTime;
 		
+		char source;
+		cout<<"Use broadcast ephemeris from the log instead of IGS rapid orbits? (y/n)\n";
+		cin>>source;
+		useBroadcast = (source == 'y' || source == 'Y');
+
+		char mode;
+		cout<<"Position several simultaneous receiver logs (.ubx) together? (y/n)\n";
+		cin>>mode;
+		multiMode = (mode == 'y' || mode == 'Y');
+
+		batchMode = false;
+		if(!multiMode)
+		{
+			cout<<"Solve all epochs in parallel batch mode? (y/n)\n";
+			cin>>mode;
+			batchMode = (mode == 'y' || mode == 'Y');
+		}
+
+		filterMode = false;
+		if(!batchMode && !multiMode)
+		{
+			cout<<"Track with the Kalman filter instead of least squares? (y/n)\n";
+			cin>>mode;
+			filterMode = (mode == 'y' || mode == 'Y');
+		}
+		
 		cin.clear();cin.ignore(INT_MAX,'\n');
 
+		// corrections applied to every epoch, in order
+		corrections.add(relativisticStep);
+		corrections.add(sagnacStep);
+		corrections.add(klobucharStep);
+		corrections.add(troposphereStep);
+
 		// load rapid ephemeris for GPS week 1715 day 3 (Wednesday)
-		loadRapidEphemeris(ephem, static_cast<unsigned int>(week), day);
+		if(!useBroadcast)
+		{
+			if(loadRapidOrbitStore(orbits, static_cast<unsigned int>(week), day) != 0)
+				return(-1);
+		}
+
+		// multi-receiver mode: SV states shared by all logs, receivers solved on a thread pool
+		if(multiMode)
+		{
+			MultiReceiver receivers;
+			string input;
+
+			cout<<"Enter one input file (.ubx) per line, empty line to finish\n";
+			cout<<"(solutions go to <input>-solutions.csv):\n";
+			while(getline(cin,input) && !input.empty())
+			{
+				string output = input.substr(0, input.find_last_of('.')) + "-solutions.csv";
+				if(receivers.addReceiver(input, output) != 0)
+				{
+					cout << "Unable to open " << input << " or " << output << "!" << endl << endl;
+					return(-1);
+				}
+			}
+
+			receivers.setCorrections(corrections);
+			if(useBroadcast)
+				receivers.setSource(&svEngine);
+			else
+				receivers.setSource(&interpolator);
+
+			cout << "Processing Logfile Epochs" << endl;
+			if(receivers.run() != 0)
+			{
+				cout << "No input files!" << endl << endl;
+				return(-1);
+			}
+			cout << receivers.fixes << " fixes from " << receivers.epochsMerged << " epochs" << endl;
+
+			TRACE_STOP();
+			return(0);
+		}
 
 		//get the input data
 		string input;
 		//"C:\\Users\\Denton.R\\Desktop\\Multipath\\Site1-Northside-21Nov2012.csv"
-		cout<<"Enter input file (.csv):\n";
+		cout<<"Enter input file (.csv or .ubx):\n";
 		getline(cin,input);
 
+		// a .ubx log is decoded in memory, anything else is ParseUBX CSV
+		binaryInput = input.size() > 4 &&
+			(input.substr(input.size() - 4) == ".ubx" || input.substr(input.size() - 4) == ".UBX");
+
 		// open log file
-		inFile.open(input.c_str());
-		if(!inFile.is_open())
+		if(binaryInput)
 		{
-			cout << "Unable to open input file!" << endl << endl;
-			return(-1);
+			if(ubxIn.open(input) != 0)
+				return(-1);
+		}
+		else
+		{
+			inFile.open(input.c_str());
+			if(!inFile.is_open())
+			{
+				cout << "Unable to open input file!" << endl << endl;
+				return(-1);
+			}
 		}
 
 		//get the output data
@@ -116,82 +223,180 @@ int main(int argc, char* argv[])
 		// write header to file
 		outFile << "TOW(s),X(m),Y(m),Z(m),b(s),SVs,GDOP" << endl;
 
+		// a .ubx input may be a live stream, export its latencies next to the solutions
+		if(binaryInput)
+		{
+			string latencyFile = output.substr(0, output.find_last_of('.')) + "-latency.csv";
+			if(latency.start(latencyFile) != 0)
+				cout << "Unable to open " << latencyFile << ", latencies not exported" << endl;
+		}
+
 		cout << "Processing Logfile Messages" << endl;
 		cout << "Message Count:" << endl;
 
-		// initialize solution to all zeros (center of earth in ECEF)
-		for(unsigned int i = 0; i < solution.size(); i++)
-			solution(i) = 0.0;
-		userClockBias = 0.0;  // initial clock bias unknown
-
 		// process messages from file
-		while(!inFile.eof())
+		while(true)
 		{
-			// read line from file
-			getline(inFile, fileLine);
+			bool haveEpoch = false;  // a measurement epoch was read
+
+			if(binaryInput)
+			{	// read next message straight from the UBX log
+				int res = ubxIn.read_next_ubx(message);
+				if(res == 1)
+					break;     // end of file
+				if(res != 0)
+					continue;  // damaged message, resynchronize on the next one
+
+				if(decodeEphemerisMessage(message, broadcast) == 1)
+				{	// RXM-EPH/AID-EPH subframes, update broadcast ephemeris
+					svEngine.setEphemeris(broadcast);
+				}
+				else if(message.header.MessageClass == RXM && message.header.MessageID == SFRBX)
+				{	// subframe words, update broadcast ephemeris once a set is complete
+					if(nav.add(message.payload, message.header.length, record) == 1 &&
+					   decodeNavRecord(record, broadcast) == 0)
+						svEngine.setEphemeris(broadcast);
+				}
+				else if(decodeKlobucharMessage(message, corrections.klob) == 1)
+				{	// AID-HUI ionospheric parameters
+				}
+				else if(decodeRawEpoch(message, epoch) == 1)
+				{	// RXM-RAW/RXM-RAWX measurements
+					haveEpoch = true;
+				}
+			}
+			else
+			{
+				if(inFile.eof())
+					break;
+
+				// read line from file
+				getline(inFile, fileLine);
+
+				// parse data from line
+				if(parseEphLine(fileLine, ephSV, subframes))
+				{	// extracted RXM-EPH subframes, update broadcast ephemeris
+					if(decodeEphemeris(broadcast, ephSV, subframes[0], subframes[1], subframes[2]) == 0)
+						svEngine.setEphemeris(broadcast);
+				}
+				else if(parseHuiLine(fileLine, corrections.klob))
+				{	// extracted AID-HUI ionospheric parameters
+				}
+				else if(parseLine(fileLine, lineData))
+				{	// extracted valid RXM-RAW data message
+					epoch.week  = week;
+					epoch.tow   = lineData.iTOW/1000.0;
+					epoch.numSV = 0;
+					for(int i = 0; i < lineData.numSV && epoch.numSV < MAX_EPOCH_SV; i++)
+					{
+						epoch.sv[epoch.numSV] = lineData.svData.at(i).sv;
+						epoch.pr[epoch.numSV] = lineData.svData.at(i).prMes;
+						epoch.numSV++;
+					}
+					haveEpoch = true;
+				}
+			}
 
-			// parse data from line
-			if(parseLine(fileLine, lineData))
-			{	// extracted valid RXM-RAW data message
-				time.setGPS(week, lineData.iTOW/1000.0);   // load time of interest
-				dataSV.resize(0,4);  // clear input data matrix
+			if(!haveEpoch)
+				continue;
 
-				// get SV position from IGS Ephemeris
-				for(int i = 0; i < lineData.numSV; i++)
-				{
-					sv.id = lineData.svData.at(i).sv;
-					if(sv.isValid() && lineData.svData.at(i).sv != 27)
-					{
-						Xvt xvt = ephem.getXvt(sv,time);  // get rapid ephemeris SV position
+			TRACE_SPAN("solve", "epoch");
 
-						// load SV data into solution input matrix
-						dataRow[0] = xvt.x[0];
-						dataRow[1] = xvt.x[1];
-						dataRow[2] = xvt.x[2];
+			// keep the usable SVs of this epoch
+			selectUsableSVs(epoch);
 
-						// load pseudorange into data row
-						dataRow[3] = lineData.svData.at(i).prMes;
+			// get SV positions for the whole epoch
+			if(useBroadcast)
+			{
+				TRACE_SPAN("solve", "sv states");
+				svEngine.evaluate(epoch);  // broadcast ephemeris SV position (memoized)
+			}
+			else
+			{
+				TRACE_SPAN("solve", "sv states");
+				interpolator.evaluate(epoch);  // rapid ephemeris SV positions, one window for all SVs
+			}
 
-						// modify pseudorange for known errors
-						dataRow[3] += xvt.dtime * SPEED_OF_LIGHT;  // SV clock bias
-						dataRow[3] -= userClockBias;               // appoximate user clock bias
-						//dataRow[3] -= relativisticError;  // relativistic correction for time
-						//dataRow[3] -= atmosphericError;   // atmospheric delays
+			// batch mode solves the stored epochs once the whole log is read
+			if(batchMode)
+			{
+				batch.addEpoch(epoch, corrections.klob);
+				cout << "\r" << ++messagesProcessed;
+				continue;
+			}
 
-						// push_back data row onto solver input data matrix
-						dataSV = dataSV && dataRow;
-					}
+			// filter mode: one predict and a scalar update per SV, also below four SVs
+			if(filterMode)
+			{
+				// relativistic, earth rotation and atmospheric corrections (the
+				// filter state is close enough for the elevation angles)
+				position[0] = filter.state[0];
+				position[1] = filter.state[1];
+				position[2] = filter.state[2];
+				{
+					TRACE_SPAN("solve", "corrections");
+					corrections.apply(epoch, position, filter.state[6]);  // corrects epoch.pr in place
 				}
 
-				// calculate GPS solution from data (previous solution used as initial guess)
-				errorcode = solutionNLLS(dataSV, solution);
-				//errorcode = solver.Compute(dataSV, solution);
-				if(errorcode == 0)
+				TRACE_SPAN("solve", "filter");
+				if(filter.update(epoch) >= 0)
 				{
-					// compute clock bias for this solution
-					userClockBias += solution[3];  // residual clock bias in solution is amount 
-												   //  clock bias varied from previous solution
-
-					// write solution data to output file
-					outFile << lineData.iTOW / 1000.0          << ",";
-					outFile << setprecision(15) << solution[0] << ",";
-					outFile << setprecision(15) << solution[1] << ",";
-					outFile << setprecision(15) << solution[2] << ",";
-					//outFile << setprecision(15) << solution[3]/SPEED_OF_LIGHT;
-					outFile << setprecision(15) << userClockBias/SPEED_OF_LIGHT;
-
-					// write number of SVs used to output file
-					outFile << "," << dataSV.rows();
-
-					// get DOP for this solution
-					errorcode = calculateDOP(matrixDOP, dataSV, solution);
-					if(errorcode >= 0)
-						outFile << "," << sqrt(trace(matrixDOP));  // print results
+					outFile << epoch.tow                                << ",";
+					outFile << setprecision(15) << filter.state[0]     << ",";
+					outFile << setprecision(15) << filter.state[1]     << ",";
+					outFile << setprecision(15) << filter.state[2]     << ",";
+					outFile << setprecision(15) << filter.state[6]/SPEED_OF_LIGHT;
+					outFile << "," << filter.used;
+
+					double gdop = filter.gdop(epoch);
+					if(gdop >= 0.0)
+						outFile << "," << gdop;
 
 					outFile << endl;
+
+					if(binaryInput)
+						latencyStats().record(ParseStats::typeSlot(message.header.MessageClass, message.header.MessageID),
+							LATENCY_FIX, ubxIn.arrival(), latencyClock());
 				}
 
 				cout << "\r" << ++messagesProcessed;
+				continue;
+			}
+
+			// calculate GPS solution from data: corrections, then least squares from
+			// the previous solution (closed form seed at the start and after clock
+			// jumps or gaps), as in batch and multi-receiver mode
+			{
+				TRACE_SPAN("solve", "least squares");
+				errorcode = solver.solve(epoch, corrections, fix);
+			}
+			if(errorcode == 0)
+			{
+				writeFix(outFile, fix);
+
+				if(binaryInput)
+					latencyStats().record(ParseStats::typeSlot(message.header.MessageClass, message.header.MessageID),
+						LATENCY_FIX, ubxIn.arrival(), latencyClock());
+			}
+
+			cout << "\r" << ++messagesProcessed;
+		}
+
+		if(batchMode)
+		{
+			cout << endl << "Solving " << batch.numEpochs() << " epochs" << endl;
+			batch.setCorrections(corrections);
+			{
+				TRACE_SPAN("solve", "batch");
+				batch.solve();
+			}
+
+			// segments were solved out of order, fixes come back in epoch order
+			const vector<BatchFix> &fixes = batch.fixes();
+			for(unsigned int i = 0; i < fixes.size(); i++)
+			{
+				if(fixes[i].errorcode == 0)
+					writeFix(outFile, fixes[i]);
 			}
 		}
 	}
@@ -201,6 +406,7 @@ int main(int argc, char* argv[])
 		exit(-1);
 	}
 
+	TRACE_STOP();
 	return(0);
 }
 
@@ -310,5 +516,93 @@ bool parseLine(string &fileLine, RXM_RAW_DATA &lineData)
 }
 
 
+// parseEphLine: extracts subframes 1-3 from an "RXM,EPH" line written by ParseUBX
+//   Note: each word is written as 30 binary digits with the data in the low 24 bits
+bool parseEphLine(string &fileLine, int &svid, unsigned int subframes[3][8])
+{
+	size_t first, last;  // indices into a string
+	stringstream ss;     // string stream used to convert strings to values
+
+	if(fileLine.substr(0,8) != "RXM,EPH,")
+		return(false);  // not correct string type
+
+	// get SV id
+	first = 8;
+	last  = fileLine.find_first_of(',', first);
+	if(last == string::npos)
+		return(false);  // polling request, no ephemeris
+	ss << fileLine.substr(first, last - first);
+	ss >> svid;
+
+	// get subframe words
+	for(int sf = 0; sf < 3; sf++)
+	{
+		const char * tag[3] = { ",SF1,", ",SF2,", ",SF3," };
+
+		first = fileLine.find(tag[sf]);
+		if(first == string::npos || fileLine.size() < first + 5 + 8*30)
+			return(false);  // HOW is zero, no ephemeris data present
+		first += 5;
+
+		for(int word = 0; word < 8; word++)
+		{
+			unsigned int value = 0;
+			for(int bit = 0; bit < 30; bit++)
+				value = (value << 1) | (fileLine[first + word*30 + bit] == '1' ? 1 : 0);
+			subframes[sf][word] = value & 0xFFFFFF;
+		}
+	}
+
+	return(true);
+}
+
+// parseHuiLine: extracts Klobuchar parameters from an "AID,HUI" line written by ParseUBX
+//   Note: line layout is utcTOW,utcWNT,alpha0..3,beta0..3,flags
+bool parseHuiLine(string &fileLine, KlobucharParams &klob)
+{
+	size_t first, last;  // indices into a string
+	stringstream ss;     // string stream used to convert strings to values
+	double values[11];   // utcTOW, utcWNT, alpha0..3, beta0..3, flags
+
+	if(fileLine.substr(0,8) != "AID,HUI,")
+		return(false);  // not correct string type
+
+	first = 8;
+	for(int i = 0; i < 11; i++)
+	{
+		last = fileLine.find_first_of(',', first);
+		ss << fileLine.substr(first, last - first);
+		ss >> values[i];
+		ss.clear();         // clear string stream to get ready for next use
+		ss.str(string());
+		if(last == string::npos && i < 10)
+			return(false);  // truncated line
+		first = last + 1;
+	}
+
+	if(!(static_cast<unsigned long>(values[10]) & KLOB_FLAG_VALID))
+		return(true);  // message parsed but receiver has no valid model yet
+
+	for(int i = 0; i < 4; i++)
+	{
+		klob.alpha[i] = values[2 + i];
+		klob.beta[i]  = values[6 + i];
+	}
+	klob.valid = true;
 
+	return(true);
+}
 
+// writeFix: writes one solution line (time, ECEF position, receiver clock
+//   bias in seconds, SVs used, GDOP)
+void writeFix(ofstream &outFile, const BatchFix &fix)
+{
+	outFile << fix.tow                     << ",";
+	outFile << setprecision(15) << fix.x   << ",";
+	outFile << setprecision(15) << fix.y   << ",";
+	outFile << setprecision(15) << fix.z   << ",";
+	outFile << setprecision(15) << fix.clockBias;
+	outFile << "," << fix.numSV;
+	outFile << "," << fix.gdop;
+	outFile << endl;
+}
@@ -0,0 +1,202 @@
+//**********************************************************************
+// File:			UBXMeasurements.cpp
+// Programmer:		Guoyu Fu
+// Description:		Solver inputs decoded straight from UBX messages
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Payload fields are read byte-wise at their documented offsets so the
+// decoding does not depend on the size of the U4/I4 typedefs.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+
+// included libraries
+#include <cstring>
+
+#include "UBXMeasurements.h"
+
+using namespace std;
+
+
+// little endian payload readers
+unsigned int readU4(const U1 *p)
+{
+	return((unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+	       ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24));
+}
+
+unsigned short readU2(const U1 *p)
+{
+	return((unsigned short)(p[0] | (p[1] << 8)));
+}
+
+static double readR8(const U1 *p)
+{
+	double value;
+	memcpy(&value, p, sizeof(value));
+	return(value);
+}
+
+static float readR4(const U1 *p)
+{
+	float value;
+	memcpy(&value, p, sizeof(value));
+	return(value);
+}
+
+
+// decodeRawEpoch: fills week, tow, sv and pr of epoch from an RXM-RAW or
+//   RXM-RAWX message (RAWX: GPS measurements with a valid pseudorange only)
+//   returns 1 if an epoch was decoded, 0 if message is not a measurement
+//   message, -1 if the payload is too short for its block count
+int decodeRawEpoch(const UBXMessage &message, EpochSVData &epoch)
+{
+	const U1 *p = message.payload;
+	unsigned int length = message.header.length;
+
+	if(message.header.MessageClass != RXM || p == 0)
+		return(0);
+
+	if(message.header.MessageID == RAW)
+	{
+		if(length < RXM_RAW_HEADER_SIZE)
+			return(-1);
+		unsigned int numSV = p[6];
+		if(length < RXM_RAW_HEADER_SIZE + numSV * RXM_RAW_BLOCK_SIZE)
+			return(-1);
+
+		epoch.week  = (short)readU2(p + 4);
+		epoch.tow   = (int)readU4(p) / 1000.0;
+		epoch.numSV = 0;
+		for(unsigned int i = 0; i < numSV && epoch.numSV < MAX_EPOCH_SV; i++)
+		{
+			const U1 *block = p + RXM_RAW_HEADER_SIZE + i * RXM_RAW_BLOCK_SIZE;
+			epoch.sv[epoch.numSV] = block[20];
+			epoch.pr[epoch.numSV] = readR8(block + 8);
+			epoch.valid[epoch.numSV] = 0;
+			epoch.numSV++;
+		}
+		return(1);
+	}
+
+	if(message.header.MessageID == RAWX)
+	{
+		if(length < RXM_RAWX_HEADER_SIZE)
+			return(-1);
+		unsigned int numMeas = p[11];
+		if(length < RXM_RAWX_HEADER_SIZE + numMeas * RXM_RAWX_BLOCK_SIZE)
+			return(-1);
+
+		epoch.week  = readU2(p + 8);
+		epoch.tow   = readR8(p);
+		epoch.numSV = 0;
+		for(unsigned int i = 0; i < numMeas && epoch.numSV < MAX_EPOCH_SV; i++)
+		{
+			const U1 *block = p + RXM_RAWX_HEADER_SIZE + i * RXM_RAWX_BLOCK_SIZE;
+			if(block[20] != GNSS_GPS || !(block[30] & RAWX_TRKSTAT_PR_VALID))
+				continue;  // solver is GPS only
+			epoch.sv[epoch.numSV] = block[21];
+			epoch.pr[epoch.numSV] = readR8(block);
+			epoch.valid[epoch.numSV] = 0;
+			epoch.numSV++;
+		}
+		return(1);
+	}
+
+	return(0);
+}
+
+// decodeEphemerisMessage: decodes subframes 1-3 of an RXM-EPH or AID-EPH message
+//   returns 1 if eph was decoded, 0 if message carries no ephemeris,
+//   -1 if the subframes do not form a consistent ephemeris
+int decodeEphemerisMessage(const UBXMessage &message, BroadcastEphemeris &eph)
+{
+	const U1 *p = message.payload;
+
+	if(!(message.header.MessageClass == RXM && message.header.MessageID == EPH) &&
+	   !(message.header.MessageClass == AID && message.header.MessageID == EPH))
+		return(0);
+
+	// only the full form carries subframes, HOW of zero means no data
+	if(message.header.length != EPH_SUBFRAMES_SIZE || p == 0 || readU4(p + 4) == 0)
+		return(0);
+
+	unsigned int sf[3][8];
+	for(int s = 0; s < 3; s++)
+		for(int w = 0; w < 8; w++)
+			sf[s][w] = readU4(p + 8 + s * 32 + w * 4) & 0xFFFFFF;
+
+	if(decodeEphemeris(eph, readU4(p), sf[0], sf[1], sf[2]) != 0)
+		return(-1);
+
+	return(1);
+}
+
+// decodeNavRecord: decodes a GPS LNAV set assembled from RXM-SFRBX words
+//   returns 0 on success, 1 if record is not GPS LNAV, -1 if the subframes
+//   do not form a consistent ephemeris
+int decodeNavRecord(const NavRecord &record, BroadcastEphemeris &eph)
+{
+	if(record.type != NAVREC_GPS_LNAV || record.numSlots < 3)
+		return(1);
+
+	unsigned int sf[3][8];
+	for(int s = 0; s < 3; s++)
+		for(int w = 0; w < 8; w++)
+			sf[s][w] = record.words[s][w + 2] & 0xFFFFFF;  // words 3 -> 10
+
+	if(decodeEphemeris(eph, record.svId, sf[0], sf[1], sf[2]) != 0)
+		return(-1);
+
+	return(0);
+}
+
+// decodeKlobucharMessage: extracts the Klobuchar parameters of an AID-HUI message
+//   returns 1 if message is AID-HUI, 0 otherwise; klob is left unchanged
+//   while the receiver has no valid model
+int decodeKlobucharMessage(const UBXMessage &message, KlobucharParams &klob)
+{
+	const U1 *p = message.payload;
+
+	if(message.header.MessageClass != AID || message.header.MessageID != HUI)
+		return(0);
+	if(message.header.length < AID_HUI_SIZE || p == 0)
+		return(0);
+
+	if(!(readU4(p + 68) & KLOB_FLAG_VALID))
+		return(1);
+
+	for(int i = 0; i < 4; i++)
+	{
+		klob.alpha[i] = readR4(p + 36 + 4 * i);
+		klob.beta[i]  = readR4(p + 52 + 4 * i);
+	}
+	klob.valid = true;
+
+	return(1);
+}
+
+// selectUsableSVs: keeps the rows of GPS PRNs the solver can use,
+//   compacting sv and pr
+//   returns the number of rows kept
+int selectUsableSVs(EpochSVData &epoch)
+{
+	unsigned int used = 0;
+
+	for(unsigned int i = 0; i < epoch.numSV; i++)
+	{
+		if(epoch.sv[i] >= 1 && epoch.sv[i] <= MAX_GPS_PRN)
+		{
+			epoch.sv[used] = epoch.sv[i];
+			epoch.pr[used] = epoch.pr[i];
+			used++;
+		}
+	}
+	epoch.numSV = used;
+
+	return(used);
+}
@@ -0,0 +1,45 @@
+//**********************************************************************
+// File:			UBXMeasurements.h
+// Programmer:		Guoyu Fu
+// Description:		Solver inputs decoded straight from UBX messages
+// Created:         10/19/2026
+// Last modified:	10/19/2026
+//**********************************************************************
+//
+// Lets SolutionUBX read a .ubx log through UBXParser instead of the CSV
+// written by ParseUBX.  Measurements keep their full binary precision
+// and no text is formatted or parsed on the way.
+//
+//**********************************************************************
+// Change Log:
+//
+//**********************************************************************
+#ifndef UBX_MEASUREMENTS_H
+#define UBX_MEASUREMENTS_H
+
+// defined constants
+#define RXM_RAW_HEADER_SIZE    8      // RXM-RAW bytes before the repeated blocks
+#define RXM_RAW_BLOCK_SIZE     24     // RXM-RAW bytes per SV
+#define RXM_RAWX_HEADER_SIZE   16     // RXM-RAWX bytes before the repeated blocks
+#define RXM_RAWX_BLOCK_SIZE    32     // RXM-RAWX bytes per measurement
+#define RAWX_TRKSTAT_PR_VALID  0x01   // RXM-RAWX trkStat: pseudorange valid
+#define AID_HUI_SIZE           72     // AID-HUI payload length
+#define EPH_SUBFRAMES_SIZE     104    // RXM-EPH/AID-EPH length with subframes 1-3
+
+// included libraries
+#include "../ParseUBX/LibUBX.h"
+#include "../ParseUBX/LibNavMsg.h"
+#include "../GPSUtilities/EpochData.h"
+#include "../GPSUtilities/SVState.h"
+#include "../GPSUtilities/Corrections.h"
+
+// function prototypes
+unsigned int readU4(const U1 *p);     // little endian payload readers, independent
+unsigned short readU2(const U1 *p);   // of the size of U4 (unsigned long)
+int decodeRawEpoch(const UBXMessage &message, EpochSVData &epoch);
+int decodeEphemerisMessage(const UBXMessage &message, BroadcastEphemeris &eph);
+int decodeNavRecord(const NavRecord &record, BroadcastEphemeris &eph);
+int decodeKlobucharMessage(const UBXMessage &message, KlobucharParams &klob);
+int selectUsableSVs(EpochSVData &epoch);
+
+#endif // UBX_MEASUREMENTS_H